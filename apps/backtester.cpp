@@ -1,127 +1,657 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <ctime>
+#include <fstream>
+#include <memory>
 
 #include "core/types.hpp"
 #include "core/module.hpp"
+#include "core/bar_columns.hpp"
 #include "indicators/rsi.hpp"
 #include "indicators/sma_ema.hpp"
 #include "indicators/bollinger.hpp"
 #include "indicators/mtfa.hpp"
+#include "indicators/kernels.hpp"
+#include "indicators/multi_engine.hpp"
 #include "strategy/decision.hpp"
+#include "strategy/pipeline.hpp"
+#include "strategy/param_presets.hpp"
+#include "strategy/walk_forward.hpp"
+#include "backtest/monte_carlo.hpp"
+#include "backtest/checkpoint.hpp"
+#include "backtest/portfolio.hpp"
+#include "backtest/tick_replay.hpp"
+#include "data/bar_loader.hpp"
+#include "data/tick_file.hpp"
+#include "util/mem_budget.hpp"
+#include "util/thread_pool.hpp"
 
-struct Row { long long t; double o,h,l,c,v; };
+using Pipeline = StaticPipeline<ind::SmaEmaModule, ind::RsiModule, ind::BollModule, ind::MtfSmaModule>;
 
-static bool load_csv(const std::string& path, std::vector<Row>& out) {
-    std::ifstream f(path);
-    if (!f.good()) return false;
-    std::string line;
-    // opcionális header sor
-    std::getline(f, line);
-    while (std::getline(f, line)) {
-        if (line.empty()) continue;
-        std::stringstream ss(line);
-        std::string x; Row r{};
-        if (!std::getline(ss,x,',')) continue; r.t = std::stoll(x);
-        if (!std::getline(ss,x,',')) continue; r.o = std::stod(x);
-        if (!std::getline(ss,x,',')) continue; r.h = std::stod(x);
-        if (!std::getline(ss,x,',')) continue; r.l = std::stod(x);
-        if (!std::getline(ss,x,',')) continue; r.c = std::stod(x);
-        if (!std::getline(ss,x,',')) continue; r.v = std::stod(x);
-        out.push_back(r);
-    }
-    return !out.empty();
+// díj- és méretmodell minden módhoz (--fee / --sizing, lásd backtest::parse_fee / parse_sizing)
+static SimParams g_sim{};
+
+static std::string utc_date(std::int64_t ms) {
+    const std::time_t t = static_cast<std::time_t>(ms / 1000);
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &t);
+#else
+    gmtime_r(&t, &tm);
+#endif
+    char buf[16];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d", &tm);
+    return buf;
 }
 
-int main(int argc, char** argv) {
-    if (argc < 2) {
-        std::cout << "Hasznalat: backtester <csv_path> [mtf_factor]\n";
+// Az adatsor bar-hossza Timeframe-ként (a modulok TF-függő része, pl. az MTF bucket, ehhez igazodik).
+// Nem szabványos vagy meg nem állapítható hossznál figyelmeztet, és M5-tel számol.
+static Timeframe data_timeframe(const BarColumns& cols, const std::string& what) {
+    Timeframe tf = Timeframe::M5;
+    if (!backtest::bar_timeframe(cols, tf))
+        std::cerr << what << ": a bar hossza (" << backtest::bar_length_ms(cols) << " ms) nem szabvanyos TF, M5-kent szamolva\n";
+    return tf;
+}
+
+// --wf <path> [train_bars] [test_bars] [equity_csv]: walk-forward validáció a közös paraméter-rácson
+static int run_walk_forward(int argc, char** argv) {
+    const std::string path = argv[2];
+    WalkForwardConfig cfg;
+    cfg.train = (argc >= 4 ? std::strtoull(argv[3], nullptr, 10) : 20000);
+    cfg.test  = (argc >= 5 ? std::strtoull(argv[4], nullptr, 10) : 5000);
+    const std::string eq_csv = (argc >= 6 ? argv[5] : "");
+
+    data::LoadedBars rows;
+    if (!rows.load(path)) {
+        std::cerr << rows.error() << "\n";
+        return 2;
+    }
+    const BarColumns cols = rows.columns();
+    if (cfg.train == 0 || cfg.test == 0 || cols.size() <= cfg.train) {
+        std::cerr << "Tul keves bar a train ablakhoz (" << cols.size() << " <= " << cfg.train << ")\n";
         return 1;
     }
-    std::string path = argv[1];
-    int mtf_factor = (argc >= 3 ? std::max(1, std::atoi(argv[2])) : 12);
 
-    std::vector<Row> rows;
-    if (!load_csv(path, rows)) {
-        std::cerr << "CSV betoltes sikertelen: " << path << "\n";
-        return 2;
+    const auto ps = default_param_slots(true);
+    const auto weights = default_weight_grid(ps.slots.size());
+    SeriesCache cache;
+    util::ThreadPool pool;
+    const SimParams& sp = g_sim;
+    const auto wf = walk_forward(ps.slots, weights, cols, Symbol{"BTC","USDT"}, data_timeframe(cols, path), sp, cfg, cache, pool,
+                                 nullptr, rows.hash());
+
+    std::printf("%-4s %-10s %-10s %-10s  %-52s %-23s %10s %8s %6s %6s %6s %7s\n",
+                "fold", "train", "test", "test end", "config", "w", "IS eq", "OOS %", "trd", "PF", "win%", "maxDD%");
+    for (std::size_t k = 0; k < wf.folds.size(); ++k) {
+        const auto& f = wf.folds[k];
+        std::string keys, ws;
+        for (const auto& key : f.best.keys) keys += (keys.empty() ? "" : " ") + key;
+        for (double w : f.best.w) ws += fmt::format("{}{:.2f}", ws.empty() ? "" : " ", w);
+        std::printf("%-4zu %-10s %-10s %-10s  %-52s %-23s %10.2f %8.3f %6d %6.2f %6.1f %7.2f\n",
+                    k + 1, utc_date(cols.open_time_ms[f.train_begin]).c_str(),
+                    utc_date(cols.open_time_ms[f.test_begin]).c_str(), utc_date(cols.open_time_ms[f.test_end - 1]).c_str(),
+                    keys.c_str(), ws.c_str(), f.best.r.final_eq, (f.oos.final_eq / f.oos_start - 1.0) * 100.0,
+                    f.oos.trades, std::min(f.oos.pf(), 999.0), f.oos.winrate() * 100.0, f.oos.maxdd * 100.0);
     }
+    std::cout << "OOS final equity: " << wf.final_eq
+              << " | Folds: " << wf.folds.size()
+              << " | MaxDD: " << wf.maxdd * 100.0 << "%"
+              << " | Evals: " << wf.stats.evaluations << " (" << wf.stats.ms << " ms)\n";
+
+    if (!eq_csv.empty()) {
+        std::ofstream f(eq_csv);
+        f << "open_time,equity\n";
+        std::size_t i = wf.folds.empty() ? 0 : wf.folds.front().test_begin;
+        for (double e : wf.equity) f << cols.open_time_ms[i++] << ',' << e << '\n';
+        if (!f) { std::cerr << "Equity CSV iras sikertelen: " << eq_csv << "\n"; return 3; }
+    }
+    return 0;
+}
 
-    // modulok
-    ind::SmaEmaModule m1(20,50);
-    ind::RsiModule    m2(14);
-    ind::BollModule   m3(20,2.0);
-    ind::MtfSmaModule m4(mtf_factor, 10, 30);
+static Pipeline make_pipeline(int mtf_factor, ind::RsiMode rsi_mode) {
+    return Pipeline{ ind::SmaEmaModule(20,50),
+                     ind::RsiModule(14, rsi_mode),
+                     ind::BollModule(20,2.0),
+                     ind::MtfSmaModule(static_cast<std::size_t>(mtf_factor), 10, 30) };
+}
 
-    std::vector<IModule*> mods{ &m1, &m2, &m3, &m4 };
+// A fix pipeline kombinált score sorozata (= decide() baronként): batch score oszlopok modulonként,
+// majd kernels::combine_score_rows. combined a bars hosszára méreteződik. A pipe állapota továbblép
+// (checkpointból folytatva csak az új barokat kell átadni). tf: az adatsor valódi bar-hossza.
+static void score_pipeline(Pipeline& pipe, const BarColumns& cols, Timeframe tf, std::vector<double>& combined) {
+    // súlyok slot-sorrendben: SMA_EMA, RSI, BOLL, MTF_SMA
+    const double w[Pipeline::N] = { 0.4, 0.3, 0.2, 0.1 };
+    const std::size_t n = cols.size();
+    std::vector<double> buf(Pipeline::N * n);
+    std::array<std::span<double>, Pipeline::N> out;
+    std::array<const double*, Pipeline::N> rows;
+    for (std::size_t m = 0; m < Pipeline::N; ++m) { out[m] = {buf.data() + m * n, n}; rows[m] = out[m].data(); }
+    pipe.on_bars(Symbol{"BTC","USDT"}, tf, cols, out);
+    combined.resize(n);
+    ind::kernels::combine_score_rows(rows, n, w, combined);
+}
 
-    // súlyok
-    Weights w;
-    w.w["SMA_EMA"] = 0.4;
-    w.w["RSI"]     = 0.3;
-    w.w["BOLL"]    = 0.2;
-    w.w["MTF_SMA"] = 0.1;
+static void score_pipeline(const BarColumns& cols, Timeframe tf, int mtf_factor, ind::RsiMode rsi_mode, std::vector<double>& combined) {
+    Pipeline pipe = make_pipeline(mtf_factor, rsi_mode);
+    score_pipeline(pipe, cols, tf, combined);
+}
 
-    Scores s;
-    Symbol sym{"BTC","USDT"};
+namespace fs = std::filesystem;
 
-    double cash=10000.0, pos=0.0, entry=0.0, fee=0.0004;
-    double eq_peak=cash, maxdd=0.0;
-    int trades=0;
+// szimbólum a fájlnévből: "BTCUSDT-5m-2024-01.csv" -> "BTCUSDT"
+static std::string symbol_of(const fs::path& p) {
+    std::string s = p.stem().string();
+    s = s.substr(0, s.find('-'));
+    for (auto& c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return s;
+}
 
+// könyvtár: a benne levő .csv/.bars fájlok név szerint; egyébként manifest: soronként egy útvonal
+// (üres és '#' sorok kimaradnak, a relatív útvonal a manifest könyvtárához képest értendő)
+static std::vector<fs::path> batch_inputs(const fs::path& src) {
+    std::vector<fs::path> out;
+    std::error_code ec;
+    if (fs::is_directory(src, ec)) {
+        for (const auto& e : fs::directory_iterator(src, ec)) {
+            if (!e.is_regular_file()) continue;
+            const auto ext = e.path().extension().string();
+            if (ext == ".csv" || ext == ".bars") out.push_back(e.path());
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+    std::ifstream f(src);
+    std::string line;
+    while (std::getline(f, line)) {
+        const auto a = line.find_first_not_of(" \t\r");
+        if (a == std::string::npos || line[a] == '#') continue;
+        const auto b = line.find_last_not_of(" \t\r");
+        fs::path p = line.substr(a, b - a + 1);
+        out.push_back(p.is_relative() ? src.parent_path() / p : p);
+    }
+    return out;
+}
+
+// becsült csúcs-memória egy fájl futásához: CSV-nél a BarTable (48 B/bar) + olvasási blokk,
+// mindkét formátumnál a score oszlopok + combined (40 B/bar). A .bars lapjai a page cache-ben vannak.
+static std::size_t job_bytes(const fs::path& p) {
+    std::error_code ec;
+    const std::size_t size = static_cast<std::size_t>(fs::file_size(p, ec));
+    if (ec) return 0;
+    if (data::is_bar_file(p.string())) return size / 48 * 40;
+    const std::size_t bars = size / 40; // a Binance sorok ennél hosszabbak: felülbecslés
+    return bars * (48 + 40) + std::min<std::size_t>(size, 64u << 20);
+}
+
+struct BatchRow {
+    std::string symbol, path, error;
+    std::size_t bars{0};
+    SimResult r;
+    double ms{0.0};
+};
+
+// --batch <dir|manifest> [threads] [summary_csv] [mem_mb]: fájlonként egy feladat a poolon;
+// a párhuzamosan rezidens adatot a MemBudget korlátozza, a fájl a feladat végén felszabadul.
+static int run_batch(int argc, char** argv) {
+    const fs::path src = argv[2];
+    const unsigned threads = (argc >= 4 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0);
+    const std::string out_csv = (argc >= 5 ? argv[4] : "");
+    const std::size_t mem_mb = (argc >= 6 ? std::strtoull(argv[5], nullptr, 10) : 4096);
+
+    // a --intrabar egyetlen sorozatra szól; batch módban a döntetleneket a TieBreak szabály dönti el
+    g_sim.intrabar = nullptr;
+    const auto inputs = batch_inputs(src);
+    if (inputs.empty()) {
+        std::cerr << "Nincs bemeneti fajl: " << src.string() << "\n";
+        return 2;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<BatchRow> rows(inputs.size());
+    util::MemBudget budget(std::max<std::size_t>(1, mem_mb) << 20);
+    {
+        util::ThreadPool pool(threads);
+        for (std::size_t k = 0; k < inputs.size(); ++k) {
+            pool.submit([&, k] {
+                auto& row = rows[k];
+                row.symbol = symbol_of(inputs[k]);
+                row.path = inputs[k].string();
+                util::MemBudget::Lease lease(budget, job_bytes(inputs[k]));
+                const auto j0 = std::chrono::steady_clock::now();
+                data::LoadedBars bars;
+                if (!bars.load(row.path, 1)) { row.error = bars.error(); return; }
+                row.bars = bars.size();
+                std::vector<double> combined;
+                score_pipeline(bars.columns(), data_timeframe(bars.columns(), row.path), 12, ind::RsiMode::Wilder, combined);
+                row.r = simulate(combined, bars.columns(), g_sim);
+                row.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - j0).count();
+            });
+        }
+        pool.wait();
+    }
+    const double wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    const SimParams& sp = g_sim;
+    std::printf("%-14s %10s %12s %9s %7s %8s %7s %6s\n", "symbol", "bars", "final eq", "ret %", "trades", "maxDD %", "PF", "win%");
+    std::size_t ok = 0, bars = 0, profitable = 0;
+    long trades = 0;
+    double gw = 0.0, gl = 0.0, worst_dd = 0.0;
+    std::vector<double> rets;
     for (const auto& r : rows) {
-        Bar b{r.t, r.o, r.h, r.l, r.c, r.v};
+        if (!r.error.empty()) { std::printf("%-14s HIBA: %s\n", r.symbol.c_str(), r.error.c_str()); continue; }
+        const double ret = (r.r.final_eq / sp.cash - 1.0) * 100.0;
+        std::printf("%-14s %10zu %12.2f %9.3f %7d %8.2f %7.2f %6.1f\n", r.symbol.c_str(), r.bars, r.r.final_eq, ret,
+                    r.r.trades, r.r.maxdd * 100.0, std::min(r.r.pf(), 999.0), r.r.winrate() * 100.0);
+        ++ok; bars += r.bars; trades += r.r.trades;
+        gw += r.r.gross_win; gl += r.r.gross_loss;
+        worst_dd = std::max(worst_dd, r.r.maxdd);
+        profitable += (r.r.final_eq > sp.cash);
+        rets.push_back(ret);
+    }
+    if (!rets.empty()) {
+        double mean = 0.0;
+        for (double x : rets) mean += x;
+        mean /= static_cast<double>(rets.size());
+        std::sort(rets.begin(), rets.end());
+        const std::size_t h = rets.size() / 2;
+        const double median = rets.size() % 2 ? rets[h] : 0.5 * (rets[h - 1] + rets[h]);
+        std::printf("Osszesen: %zu/%zu fajl | nyereseges: %zu | bars: %zu | trades: %ld\n", ok, rows.size(), profitable, bars, trades);
+        std::printf("Hozam %%: atlag %.3f, median %.3f, min %.3f, max %.3f | PF (osszesitett): %.2f | legrosszabb MaxDD: %.2f%%\n",
+                    mean, median, rets.front(), rets.back(), gl > 0 ? gw / gl : 0.0, worst_dd * 100.0);
+    }
+    std::printf("Ido: %.0f ms (%.1f M bar/s)\n", wall, wall > 0 ? static_cast<double>(bars) / wall / 1000.0 : 0.0);
 
-        for (auto* m : mods) {
-            auto R = m->on_bar(sym, Timeframe::M5, b);
-            s.s[m->id()] = R.score;
+    if (!out_csv.empty()) {
+        std::ofstream f(out_csv);
+        f << "symbol,path,bars,final_eq,return_pct,trades,maxdd_pct,pf,winrate,error\n";
+        for (const auto& r : rows)
+            f << r.symbol << ",\"" << r.path << "\"," << r.bars << ',' << r.r.final_eq << ','
+              << (r.error.empty() ? (r.r.final_eq / sp.cash - 1.0) * 100.0 : 0.0) << ',' << r.r.trades << ','
+              << r.r.maxdd * 100.0 << ',' << r.r.pf() << ',' << r.r.winrate() << ",\"" << r.error << "\"\n";
+        if (!f) { std::cerr << "Osszesito CSV iras sikertelen: " << out_csv << "\n"; return 3; }
+    }
+    return ok == rows.size() ? 0 : 4;
+}
+
+// --portfolio <dir|manifest> [threads] [alloc] [max_positions]: minden fájl egy symbol, közös cash-sel.
+// A jelfázis (betöltés + score) symbolonként külön pool-feladat; utána egyetlen időrendi lejátszás.
+// alloc: "BTCUSDT:0.5,ETHUSDT:0.3" symbolonkénti max súly, a többi symbol 1/k-t kap.
+static int run_portfolio(int argc, char** argv) {
+    const fs::path src = argv[2];
+    const unsigned threads = (argc >= 4 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0);
+    const std::string alloc = (argc >= 5 ? argv[4] : "");
+    const std::size_t max_pos = (argc >= 6 ? std::strtoull(argv[5], nullptr, 10) : 0);
+
+    const auto inputs = batch_inputs(src);
+    if (inputs.empty()) {
+        std::cerr << "Nincs bemeneti fajl: " << src.string() << "\n";
+        return 2;
+    }
+    if (g_sim.bracket.enabled()) std::cerr << "Portfolio modban a --bracket nem ervenyes, csak a jelek zarnak\n";
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<data::LoadedBars> bars(inputs.size());
+    std::vector<std::vector<double>> combined(inputs.size());
+    std::vector<std::string> errors(inputs.size());
+    {
+        util::ThreadPool pool(threads);
+        for (std::size_t k = 0; k < inputs.size(); ++k) {
+            pool.submit([&, k] {
+                if (!bars[k].load(inputs[k].string(), 1)) { errors[k] = bars[k].error(); return; }
+                score_pipeline(bars[k].columns(), data_timeframe(bars[k].columns(), inputs[k].string()), 12, ind::RsiMode::Wilder, combined[k]);
+            });
         }
+        pool.wait();
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<backtest::PortfolioSymbol> syms;
+    for (std::size_t k = 0; k < inputs.size(); ++k) {
+        if (!errors[k].empty()) { std::cerr << symbol_of(inputs[k]) << ": " << errors[k] << "\n"; continue; }
+        syms.push_back({symbol_of(inputs[k]), bars[k].columns(), combined[k], {1.0, g_sim.sizing}});
+    }
+    if (syms.empty()) return 2;
+    if (!backtest::parse_allocation(alloc, syms, 1.0 / static_cast<double>(syms.size()))) {
+        std::cerr << "Ervenytelen allokacio: " << alloc << "\n";
+        return 1;
+    }
+    backtest::PortfolioParams pp;
+    pp.cash = g_sim.cash; pp.up = g_sim.up; pp.down = g_sim.down; pp.fee = g_sim.fee;
+    pp.max_positions = max_pos;
+    const auto r = backtest::run_portfolio(syms, pp);
+    const auto t2 = std::chrono::steady_clock::now();
 
-        auto d = decide(s, w, 70.0, 30.0);
+    std::printf("%-14s %10s %7s %12s %7s %6s %9s %6s\n", "symbol", "bars", "max w", "pnl", "trades", "PF", "win%", "rej");
+    for (std::size_t k = 0; k < syms.size(); ++k) {
+        const auto& sr = r.symbols[k];
+        std::printf("%-14s %10zu %7.2f %12.2f %7d %6.2f %9.1f %6d\n", sr.name.c_str(), sr.bars, syms[k].alloc.max_weight,
+                    sr.pnl, sr.metrics.trades(), std::min(sr.metrics.pf(), 999.0), sr.metrics.winrate() * 100.0, sr.rejected);
+    }
+    const auto& m = r.metrics;
+    std::cout << "Portfolio final equity: " << r.final_eq
+              << " | Return: " << (r.final_eq / pp.cash - 1.0) * 100.0 << "%"
+              << " | Trades: " << m.trades()
+              << " | MaxDD: " << m.maxdd() * 100.0 << "%"
+              << " | PF: " << m.pf()
+              << " | Exposure: " << m.exposure() * 100.0 << "%"
+              << " | Fees: " << r.fees << "\n";
+    const auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+    std::printf("Esemenyek: %zu bar, %zu zaraspont | jelek: %.0f ms, lejatszas: %.0f ms\n",
+                r.events, r.steps, ms(t0, t1), ms(t1, t2));
+    return syms.size() == inputs.size() ? 0 : 4;
+}
+
+// --scan <dir|manifest> [top_n]: sok symbol élő figyelésének lejátszása (indicators/multi_engine.hpp).
+// Időrendben minden záráspontnál az akkor bart záró symbolok egy MultiSymbolEngine lépésben frissülnek
+// (mindegyik: step_all SIMD söprés, különben step a részhalmazra); a végén a legerősebb jelek listája.
+static int run_scan(int argc, char** argv) {
+    const fs::path src = argv[2];
+    const std::size_t top_n = (argc >= 4 ? std::strtoull(argv[3], nullptr, 10) : 20);
+
+    const auto inputs = batch_inputs(src);
+    if (inputs.empty()) {
+        std::cerr << "Nincs bemeneti fajl: " << src.string() << "\n";
+        return 2;
+    }
+    std::vector<data::LoadedBars> bars(inputs.size());
+    std::vector<std::string> errors(inputs.size());
+    {
+        util::ThreadPool pool;
+        for (std::size_t k = 0; k < inputs.size(); ++k)
+            pool.submit([&, k] { if (!bars[k].load(inputs[k].string(), 1)) errors[k] = bars[k].error(); });
+        pool.wait();
+    }
+    std::vector<std::string> names;
+    std::vector<BarColumns> cols;
+    for (std::size_t k = 0; k < inputs.size(); ++k) {
+        if (!errors[k].empty()) { std::cerr << symbol_of(inputs[k]) << ": " << errors[k] << "\n"; continue; }
+        names.push_back(symbol_of(inputs[k]));
+        cols.push_back(bars[k].columns());
+    }
+    const std::size_t n = cols.size();
+    if (n == 0) return 2;
 
-        if (d.action == Signal::Long && pos <= 0.0) {
-            if (pos < 0.0) { // zárjunk shortot
-                cash += (-pos) * (entry - b.close);
-                cash -= std::abs(pos) * entry * fee;
-                cash -= std::abs(pos) * b.close * fee;
-                pos = 0.0;
-                ++trades;
+    ind::MultiSymbolEngine eng(n);
+    std::vector<std::size_t> pos(n, 0);
+    std::vector<std::uint32_t> ids(n);
+    std::vector<double> closes(n);
+    std::vector<ind::MultiResult> out(n), last(n);
+    std::size_t steps = 0, full = 0, updates = 0;
+    double step_us = 0.0;
+    for (;;) {
+        std::int64_t t = INT64_MAX;
+        for (std::size_t s = 0; s < n; ++s)
+            if (pos[s] < cols[s].size()) t = std::min(t, cols[s].open_time_ms[pos[s]]);
+        if (t == INT64_MAX) break;
+        std::size_t m = 0;
+        for (std::size_t s = 0; s < n; ++s)
+            if (pos[s] < cols[s].size() && cols[s].open_time_ms[pos[s]] == t) {
+                ids[m] = static_cast<std::uint32_t>(s);
+                closes[m++] = cols[s].close[pos[s]++];
             }
-            const double qty = (cash * 0.2) / b.close;
-            if (qty > 0.0) {
-                pos   += qty;
-                cash  -= qty * b.close;
-                cash  -= qty * b.close * fee;
-                entry  = b.close;
+        const auto t0 = std::chrono::steady_clock::now();
+        if (m == n) eng.step_all(closes, out);
+        else eng.step({ids.data(), m}, {closes.data(), m}, out);
+        step_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        for (std::size_t i = 0; i < m; ++i) last[m == n ? i : ids[i]] = out[i];
+        ++steps; full += (m == n); updates += m;
+    }
+
+    // kombinált score: mint a pipeline súlyai (SMA_EMA 0.4, RSI 0.3, BOLL 0.2), MTF nélkül újranormálva
+    auto combined = [&](const ind::MultiResult& r) { return (0.4 * r.sma_ema.score + 0.3 * r.rsi.score + 0.2 * r.boll.score) / 0.9; };
+    std::vector<std::size_t> order(n);
+    for (std::size_t s = 0; s < n; ++s) order[s] = s;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return std::abs(combined(last[a]) - 50.0) > std::abs(combined(last[b]) - 50.0);
+    });
+    std::printf("%-14s %10s %8s %-6s %8s %-6s %8s %-6s %8s\n", "symbol", "bars", "SMA_EMA", "", "RSI", "", "BOLL", "", "score");
+    for (std::size_t i = 0; i < std::min(top_n, n); ++i) {
+        const std::size_t s = order[i];
+        const auto& r = last[s];
+        std::printf("%-14s %10zu %8.1f %-6s %8.1f %-6s %8.1f %-6s %8.1f\n", names[s].c_str(), cols[s].size(),
+                    r.sma_ema.score, to_string(r.sma_ema.signal), r.rsi.score, to_string(r.rsi.signal),
+                    r.boll.score, to_string(r.boll.signal), combined(r));
+    }
+    std::printf("Symbolok: %zu | zaraspontok: %zu (mind egyszerre: %zu) | frissites: %zu | %.2f us/zaraspont, %.1f ns/symbol-bar\n",
+                n, steps, full, updates, steps ? step_us / static_cast<double>(steps) : 0.0,
+                updates ? step_us * 1000.0 / static_cast<double>(updates) : 0.0);
+    return n == inputs.size() ? 0 : 4;
+}
+
+// "1m" / "5m" / "1h" / ... -> Timeframe
+static bool parse_timeframe(const std::string& s, Timeframe& tf) {
+    static const std::pair<const char*, Timeframe> names[] = {
+        {"1m", Timeframe::M1}, {"3m", Timeframe::M3}, {"5m", Timeframe::M5}, {"15m", Timeframe::M15},
+        {"30m", Timeframe::M30}, {"1h", Timeframe::H1}, {"4h", Timeframe::H4}, {"1d", Timeframe::D1} };
+    for (const auto& [n, t] : names)
+        if (s == n) { tf = t; return true; }
+    return false;
+}
+
+// --ticks <file.ticks> [tf] [latency_ms] [mtf_factor]: aggTrade lejátszás (backtest/tick_replay.hpp).
+// A barok a kötésekből épülnek és a pipeline baronként (step) fut; a megbízások kötéseken teljesülnek.
+// A fájlt darabonként adjuk át, a feldolgozott lapokat eldobjuk: a memória a fájl méretétől független.
+static int run_ticks(int argc, char** argv) {
+    const std::string path = argv[2];
+    Timeframe tf = Timeframe::M5;
+    if (argc >= 4 && !parse_timeframe(argv[3], tf)) {
+        std::cerr << "Ervenytelen timeframe: " << argv[3] << "\n";
+        return 1;
+    }
+    backtest::TickParams tp;
+    tp.bar_ms = tf_ms(tf);
+    tp.latency_ms = (argc >= 5 ? std::max(0LL, std::atoll(argv[4])) : 0);
+    const int mtf_factor = (argc >= 6 ? std::max(1, std::atoi(argv[5])) : 12);
+
+    data::MappedTicks ticks;
+    if (!ticks.open(path)) {
+        std::cerr << ticks.error() << "\n";
+        return 2;
+    }
+    if (g_sim.intrabar) std::cerr << "Tick modban az --intrabar nem ervenyes, a bracket kotesekre fut\n";
+
+    Pipeline pipe = make_pipeline(mtf_factor, ind::RsiMode::Wilder);
+    pipe.set_weights({ 0.4, 0.3, 0.2, 0.1 });
+    const Symbol sym{"BTC","USDT"};
+    std::vector<backtest::Trade> trades;
+    backtest::TickReplay replay(g_sim, tp, [&](const Bar& b) { return pipe.step(sym, tf, b, g_sim.up, g_sim.down).action; },
+                                &trades);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    constexpr std::size_t kChunk = 1u << 20;
+    const TickColumns cols = ticks.columns();
+    for (std::size_t pos = 0; pos < cols.size(); pos += kChunk) {
+        const std::size_t n = std::min(kChunk, cols.size() - pos);
+        replay.feed(cols.subspan(pos, n));
+        ticks.release(pos + n);
+    }
+    const auto r = replay.finish();
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const auto& st = replay.stats();
+    const auto& h = ticks.header();
+    std::cout << "Ticks: " << st.ticks << " | " << utc_date(h.first_ms) << " .. " << utc_date(h.last_ms)
+              << " | Bars: " << st.bars << " | Market fills: " << st.fills
+              << " | Avg slippage: " << st.avg_slippage_bps() << " bp\n";
+    std::cout << "Final equity: " << r.final_eq
+              << " | Trades: " << r.trades
+              << " | MaxDD: " << r.maxdd * 100.0 << "%"
+              << " | PF: " << r.pf()
+              << " | Win: " << r.winrate() * 100.0 << "%"
+              << " | Fees: " << r.fees << "\n";
+    const auto& m = r.metrics;
+    const double ppy = backtest::periods_per_year(tp.bar_ms);
+    std::cout << "Sharpe: " << m.sharpe(ppy)
+              << " | Sortino: " << m.sortino(ppy)
+              << " | Exposure: " << m.exposure() * 100.0 << "%"
+              << " | Avg trade: " << m.avg_trade()
+              << " | Avg bars: " << m.avg_bars_held()
+              << " | Longest DD: " << m.longest_dd_bars() << " bar\n";
+    if (g_sim.bracket.enabled())
+        std::cout << "Bracket: TP " << r.targets << " | SL " << r.stops << "\n";
+    std::printf("Lejatszas: %.2f s, %.1f M tick/s\n", secs, secs > 0.0 ? static_cast<double>(st.ticks) / secs / 1e6 : 0.0);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // --fee / --sizing / --bracket / --intrabar / --mc / --checkpoint bárhol állhat; a maradék pozicionális argumentumok mennek tovább
+    std::vector<char*> args;
+    std::shared_ptr<data::LazyBars> intrabar;
+    std::string intrabar_path, ck_path;
+    backtest::MonteCarloConfig mc;
+    mc.runs = 0;
+    for (int i = 0; i < argc; ++i) {
+        const std::string a = argv[i];
+        if ((a == "--fee" || a == "--sizing" || a == "--bracket" || a == "--intrabar" || a == "--mc" || a == "--checkpoint") && i + 1 < argc) {
+            bool ok = true;
+            if (a == "--fee") ok = backtest::parse_fee(argv[i + 1], g_sim.fee);
+            else if (a == "--sizing") ok = backtest::parse_sizing(argv[i + 1], g_sim.sizing);
+            else if (a == "--bracket") ok = backtest::parse_bracket(argv[i + 1], g_sim.bracket);
+            else if (a == "--mc") {
+                // "<futasok>[:shuffle]"
+                const std::string v = argv[i + 1];
+                const auto colon = v.find(':');
+                mc.runs = static_cast<std::size_t>(std::max(0L, std::atol(v.substr(0, colon).c_str())));
+                if (colon != std::string::npos) {
+                    ok = v.substr(colon + 1) == "shuffle";
+                    mc.mode = backtest::Resample::Shuffle;
+                }
+                ok = ok && mc.runs > 0;
             }
-        } else if (d.action == Signal::Short && pos > 0.0) {
-            cash += pos * (b.close - entry);
-            cash -= std::abs(pos) * entry * fee;
-            cash -= std::abs(pos) * b.close * fee;
-            pos = 0.0;
-            ++trades;
+            else if (a == "--checkpoint") ck_path = argv[i + 1];
+            else { intrabar_path = argv[i + 1]; intrabar = std::make_shared<data::LazyBars>(intrabar_path); }
+            if (!ok) { std::cerr << "Ervenytelen " << a << ": " << argv[i + 1] << "\n"; return 1; }
+            ++i;
+            continue;
         }
+        args.push_back(argv[i]);
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+    // finomabb barok csak a bracket döntetlenekhez, az első ilyen barnál töltődnek be
+    if (intrabar)
+        g_sim.intrabar = [intrabar](std::int64_t from, std::int64_t to) { return intrabar->range(from, to); };
+
+    if (argc >= 3 && std::string(argv[1]) == "--wf") return run_walk_forward(argc, argv);
+    if (argc >= 3 && std::string(argv[1]) == "--batch") return run_batch(argc, argv);
+    if (argc >= 3 && std::string(argv[1]) == "--portfolio") return run_portfolio(argc, argv);
+    if (argc >= 3 && std::string(argv[1]) == "--ticks") return run_ticks(argc, argv);
+    if (argc >= 3 && std::string(argv[1]) == "--scan") return run_scan(argc, argv);
+    if (argc < 2) {
+        std::cout << "Hasznalat: backtester <csv|bars path> [mtf_factor] [rsi_mode: wilder|window]\n"
+                     "           backtester --wf <csv|bars path> [train_bars] [test_bars] [equity_csv]\n"
+                     "           backtester --batch <dir|manifest> [threads] [summary_csv] [mem_mb]\n"
+                     "           backtester --portfolio <dir|manifest> [threads] [SYM:w,...] [max_positions]\n"
+                     "           backtester --ticks <aggTrades.ticks> [tf: 1m|5m|15m|1h|...] [latency_ms] [mtf_factor]\n"
+                     "           backtester --scan <dir|manifest> [top_n]  (sok symbol, MultiSymbolEngine)\n"
+                     "  opciok:  --fee <arany | fix+arany>  --sizing <cash:f | notional:q | qty:q>\n"
+                     "           --bracket <tp%:sl%[:stop|target|open]>  --intrabar <1m csv|bars path>\n"
+                     "           --mc <futasok[:shuffle]>  (Monte Carlo a trade-listan)\n"
+                     "           --checkpoint <path>  (allapot mentese; hosszabb adatsoron csak az uj barok futnak)\n";
+        return 1;
+    }
+    std::string path = argv[1];
+    int mtf_factor = (argc >= 3 ? std::max(1, std::atoi(argv[2])) : 12);
+    // "window": a régi (egyszerű összeges) RSI, a korábbi backtestek reprodukálásához
+    const ind::RsiMode rsi_mode = (argc >= 4 && std::string(argv[3]) == "window") ? ind::RsiMode::Window : ind::RsiMode::Wilder;
 
-        const double eq = cash + pos * b.close;
-        if (eq > eq_peak) eq_peak = eq;
-        maxdd = std::max(maxdd, (eq_peak - eq) / std::max(1.0, eq_peak));
+    // .bars (mmap) vagy CSV, a fájl tartalma alapján
+    data::LoadedBars rows;
+    if (!rows.load(path)) {
+        std::cerr << rows.error() << "\n";
+        return 2;
     }
+    if (rows.csv_stats().malformed > 0)
+        std::cerr << "Kihagyott hibas sorok: " << rows.csv_stats().malformed << "\n";
 
-    if (pos > 0.0) {
-        const double last = rows.back().c;
-        cash += pos * last;
-        cash -= std::abs(pos) * entry * fee;
-        cash -= std::abs(pos) * last * fee;
-        pos = 0.0;
-        ++trades;
+    const BarColumns cols = rows.columns();
+    const Timeframe tf = data_timeframe(cols, path);   // a teljes adatsorból (a folytatás új barjai kevesek lehetnek)
+    std::vector<double> combined;
+    Pipeline pipe = make_pipeline(mtf_factor, rsi_mode);
+    backtest::Engine engine;
+
+    // --checkpoint: ha a mentett állapot ehhez a konfigurációhoz és ennek az adatsornak az elejéhez
+    // tartozik, csak az új barok futnak (bitre azonos eredmény); egyébként teljes futás. Utána mentés.
+    backtest::Checkpoint ck;
+    ck.config = fmt::format("tf={} mtf={} rsi={} up={} down={} cash={} fee={} sizing={} bracket={}:{}:{} intrabar={}",
+                            tf_ms(tf), mtf_factor, static_cast<int>(rsi_mode), g_sim.up, g_sim.down, g_sim.cash,
+                            backtest::to_string(g_sim.fee), backtest::to_string(g_sim.sizing),
+                            g_sim.bracket.tp_pct, g_sim.bracket.sl_pct, static_cast<int>(g_sim.bracket.tie), intrabar_path);
+    ck.state = backtest::State(g_sim.cash);
+    std::size_t from = 0;
+    if (!ck_path.empty() && std::filesystem::exists(ck_path)) {
+        backtest::Checkpoint saved;
+        std::string err;
+        if (!backtest::load_checkpoint(ck_path, saved, &err)) std::cerr << "Checkpoint: " << err << " - teljes futas\n";
+        else if (saved.config != ck.config) std::cerr << "Checkpoint: mas parameterekkel keszult - teljes futas\n";
+        else if (!saved.extends(cols)) std::cerr << "Checkpoint: az adatsor nem a mentett folytatasa - teljes futas\n";
+        else {
+            util::BinReader mr(saved.modules);
+            if (!pipe.deserialize(mr) || !mr.at_end()) {
+                std::cerr << "Checkpoint: modulallapot nem toltheto - teljes futas\n";
+                pipe = make_pipeline(mtf_factor, rsi_mode);
+            } else {
+                from = saved.bars;
+                ck.state = saved.state;
+                ck.trades = std::move(saved.trades);
+                std::cerr << "Checkpoint: folytatas a(z) " << from << ". bartol, " << cols.size() - from << " uj bar\n";
+            }
+        }
+    }
+    const BarColumns fresh = cols.subspan(from, cols.size() - from);
+    score_pipeline(pipe, fresh, tf, combined);
+    const auto& r = engine.resume(fresh, combined, g_sim, ck.state);
+    // minden trade (a mentett + az új, a vég-zárással együtt), pl. a Monte Carlóhoz
+    std::vector<backtest::Trade> all_trades = ck.trades;
+    all_trades.insert(all_trades.end(), engine.trades().begin(), engine.trades().end());
+    if (!ck_path.empty()) {
+        for (const auto& t : engine.trades())
+            if (t.reason != backtest::ExitReason::End) ck.trades.push_back(t);
+        util::BinWriter mw;
+        pipe.serialize(mw);
+        ck.modules = mw.data();
+        backtest::stamp(ck, cols);
+        std::string err;
+        if (!backtest::save_checkpoint(ck_path, ck, &err)) std::cerr << "Checkpoint: " << err << "\n";
     }
 
-    std::cout << "Final equity: " << cash
-              << " | Trades: " << trades
-              << " | MaxDD: " << maxdd * 100.0 << "%\n";
+    std::cout << "Final equity: " << r.final_eq
+              << " | Trades: " << r.trades
+              << " | MaxDD: " << r.maxdd * 100.0 << "%"
+              << " | PF: " << r.pf()
+              << " | Win: " << r.winrate() * 100.0 << "%"
+              << " | Fees: " << r.fees << "\n";
+    const auto& m = r.metrics;
+    const double ppy = backtest::periods_per_year(cols.size() >= 2 ? cols.open_time_ms[1] - cols.open_time_ms[0] : 0);
+    std::cout << "Sharpe: " << m.sharpe(ppy)
+              << " | Sortino: " << m.sortino(ppy)
+              << " | Exposure: " << m.exposure() * 100.0 << "%"
+              << " | Avg trade: " << m.avg_trade()
+              << " | Avg bars: " << m.avg_bars_held()
+              << " | Longest DD: " << m.longest_dd_bars() << " bar\n";
+    if (g_sim.bracket.enabled()) {
+        std::cout << "Bracket: TP " << r.targets << " | SL " << r.stops
+                  << " | dontetlen 1m-rel: " << r.drilled << " | szaballyal: " << r.ties << "\n";
+        if (intrabar && r.drilled == 0 && !intrabar->error().empty())
+            std::cerr << "Intrabar: " << intrabar->error() << "\n";
+    }
+    if (mc.runs > 0) {
+        mc.cash = g_sim.cash;
+        const auto q = backtest::monte_carlo(all_trades, mc);
+        std::printf("Monte Carlo (%zu futas, %zu trade, %.0f ms): hozam 5/50/95%%: %.2f / %.2f / %.2f %%"
+                    " | MaxDD 5/50/95%%: %.2f / %.2f / %.2f %% | P(veszteseg): %.1f%%\n",
+                    q.runs, q.trades, q.ms, q.ret.p5 * 100.0, q.ret.p50 * 100.0, q.ret.p95 * 100.0,
+                    q.maxdd.p5 * 100.0, q.maxdd.p50 * 100.0, q.maxdd.p95 * 100.0, q.p_loss * 100.0);
+    }
 
     return 0;
 }
@@ -0,0 +1,67 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "core/bar_columns.hpp"
+#include "data/bar_file.hpp"
+#include "data/bar_loader.hpp"
+#include "data/tick_file.hpp"
+
+// --aggtrades: aggTrade CSV -> .ticks (data/tick_file.hpp), állandó memóriával
+static int convert_ticks(const std::string& in, const std::string& out) {
+    data::TickCsvStats st; std::string err;
+    if (!data::convert_aggtrades_csv(in, out, &st, &err)) {
+        std::cerr << "Konverzio sikertelen: " << err << "\n";
+        return 2;
+    }
+    data::MappedTicks chk;
+    if (!chk.open(out)) {
+        std::cerr << "Ellenorzes sikertelen: " << chk.error() << "\n";
+        return 5;
+    }
+    const auto& h = chk.header();
+    if (st.malformed > 0) std::cerr << "Kihagyott hibas sorok: " << st.malformed << "\n";
+    if (st.id_gaps > 0) std::cerr << "Hianyzo aggTrade id tartomanyok: " << st.id_gaps << "\n";
+    std::cout << "Ticks: " << h.count << " | " << h.first_ms << " .. " << h.last_ms
+              << " | id: " << h.first_id << " .. " << h.last_id << "\n";
+    return 0;
+}
+
+// CSV kline dump -> .bars (mmap-elhető oszlopos formátum, lásd data/bar_file.hpp)
+int main(int argc, char** argv) {
+    if (argc >= 4 && std::string(argv[1]) == "--aggtrades") return convert_ticks(argv[2], argv[3]);
+    if (argc < 3) {
+        std::cout << "Hasznalat: csv2bars <in.csv> <out.bars> [index_stride=4096]\n"
+                     "           csv2bars --aggtrades <aggTrades.csv> <out.ticks>\n";
+        return 1;
+    }
+    const std::string in = argv[1], out = argv[2];
+    const long stride = (argc >= 4 ? std::atol(argv[3]) : 4096);
+
+    BarTable t; data::CsvStats st;
+    if (!data::load_csv(in, t, &st)) {
+        std::cerr << "CSV betoltes sikertelen: " << in << "\n";
+        return 2;
+    }
+    for (std::size_t i = 1; i < t.size(); ++i) {
+        if (t.open_time_ms[i] <= t.open_time_ms[i-1]) {
+            std::cerr << "Nem novekvo open_time a(z) " << i << ". sorban\n";
+            return 3;
+        }
+    }
+    if (!data::write_bar_file(out, t.columns(), static_cast<std::uint32_t>(stride > 0 ? stride : 4096))) {
+        std::cerr << "Iras sikertelen: " << out << "\n";
+        return 4;
+    }
+
+    data::MappedBars chk;
+    if (!chk.open(out) || chk.size() != t.size()) {
+        std::cerr << "Ellenorzes sikertelen: " << chk.error() << "\n";
+        return 5;
+    }
+    const auto& h = chk.header();
+    if (st.malformed > 0) std::cerr << "Kihagyott hibas sorok: " << st.malformed << "\n";
+    std::cout << "Bars: " << h.count << " | " << h.first_open_ms << " .. " << h.last_open_ms
+              << " | step: " << h.step_ms << " ms\n";
+    return 0;
+}
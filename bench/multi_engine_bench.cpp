@@ -0,0 +1,94 @@
+// Per-bar késleltetés a szimbólumszám függvényében: szimbólumonkénti IModule objektumok
+// (SmaEma + RSI Wilder + Boll, virtuális on_bar) vs. MultiSymbolEngine (step_all / step).
+//   multi_engine_bench [bars] [warmup]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/module.hpp"
+#include "indicators/bollinger.hpp"
+#include "indicators/multi_engine.hpp"
+#include "indicators/rsi.hpp"
+#include "indicators/sma_ema.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// n szimbólum × bars zárás (bar-major: bar b minden szimbóluma egymás után)
+std::vector<double> make_closes(std::size_t n, std::size_t bars){
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> nd(0.0, 0.002);
+    std::vector<double> x(n), out(n*bars);
+    for (std::size_t s=0;s<n;++s) x[s] = 10.0 + static_cast<double>(s % 97);
+    for (std::size_t b=0;b<bars;++b)
+        for (std::size_t s=0;s<n;++s){ x[s] *= 1.0 + nd(rng); out[b*n + s] = x[s]; }
+    return out;
+}
+
+bool same(const ModuleResult& a, const ModuleResult& b){
+    return a.score == b.score && a.signal == b.signal;
+}
+
+} // namespace
+
+int main(int argc, char** argv){
+    const std::size_t bars   = (argc >= 2 ? std::strtoull(argv[1], nullptr, 10) : 2000);
+    const std::size_t warmup = (argc >= 3 ? std::strtoull(argv[2], nullptr, 10) : 200);
+    const std::size_t counts[] = {1, 10, 100, 300, 1000, 3000};
+    const Symbol sym{"BTC","USDT"};
+
+    std::printf("%8s %14s %14s %14s %9s %8s\n", "symbols", "modules us/bar", "step_all us", "step us", "speedup", "mismatch");
+    for (std::size_t n : counts){
+        const auto closes = make_closes(n, warmup + bars);
+
+        // szimbólumonként három modul, ahogy egy symbol-kiszolgáló tartaná
+        std::vector<std::unique_ptr<IModule>> mods;
+        mods.reserve(3*n);
+        for (std::size_t s=0;s<n;++s){
+            mods.push_back(std::make_unique<ind::SmaEmaModule>(20, 50));
+            mods.push_back(std::make_unique<ind::RsiModule>(14, ind::RsiMode::Wilder));
+            mods.push_back(std::make_unique<ind::BollModule>(20, 2.0));
+        }
+        std::vector<ModuleResult> ref(3*n);
+        ind::MultiSymbolEngine all(n), sub(n);
+        std::vector<ind::MultiResult> out_all(n), out_sub(n);
+        std::vector<std::uint32_t> ids(n);
+        for (std::size_t s=0;s<n;++s) ids[s] = static_cast<std::uint32_t>(s);
+
+        double t_mod = 0.0, t_all = 0.0, t_sub = 0.0;
+        std::size_t mismatch = 0;
+        for (std::size_t b=0;b<warmup+bars;++b){
+            const double* c = closes.data() + b*n;
+            const std::span<const double> row(c, n);
+
+            const auto t0 = Clock::now();
+            for (std::size_t s=0;s<n;++s){
+                const Bar bar{static_cast<std::int64_t>(b)*300'000, c[s], c[s], c[s], c[s], 0.0};
+                for (std::size_t m=0;m<3;++m) ref[3*s + m] = mods[3*s + m]->on_bar(sym, Timeframe::M5, bar);
+            }
+            const auto t1 = Clock::now();
+            all.step_all(row, out_all);
+            const auto t2 = Clock::now();
+            sub.step(ids, row, out_sub);
+            const auto t3 = Clock::now();
+
+            for (std::size_t s=0;s<n;++s){
+                const ModuleResult* r = ref.data() + 3*s;
+                mismatch += !(same(r[0], out_all[s].sma_ema) && same(r[1], out_all[s].rsi) && same(r[2], out_all[s].boll));
+                mismatch += !(same(r[0], out_sub[s].sma_ema) && same(r[1], out_sub[s].rsi) && same(r[2], out_sub[s].boll));
+            }
+            if (b < warmup) continue;
+            t_mod += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            t_all += std::chrono::duration<double, std::micro>(t2 - t1).count();
+            t_sub += std::chrono::duration<double, std::micro>(t3 - t2).count();
+        }
+        const double nb = static_cast<double>(bars);
+        std::printf("%8zu %14.2f %14.2f %14.2f %8.2fx %8zu\n", n, t_mod/nb, t_all/nb, t_sub/nb,
+                    t_all > 0.0 ? t_mod/t_all : 0.0, mismatch);
+    }
+    return 0;
+}
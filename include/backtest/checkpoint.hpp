@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/bar_columns.hpp"
+#include "backtest/engine.hpp"
+
+// Append-only backtest checkpoint: az utolsó feldolgozott bar utáni teljes állapot (score-modulok,
+// pozíció, cash, számlálók, metrikák, lezárt trade-ek). Egy hosszabb adatsoron csak az új barokat
+// kell feldolgozni, az eredmény bitre ugyanaz, mint a teljes újrafuttatásé – ha az adatsor eleje
+// változatlan (hash) és a futás paraméterei (config) is azonosak.
+//
+// Fájl: "BTCK" | u32 verzió | config | u64 barok | i64 utolsó open_time | u64 adatsor-hash |
+//       u64 modulblob-hossz | modulblob | State | u64 trade-szám | trade-ek
+namespace backtest {
+
+struct Checkpoint {
+    std::string config;             // a futás paramétereinek leírója (modulok, küszöbök, díj, méret, bracket)
+    std::uint64_t bars{0};          // feldolgozott barok (= state.bars)
+    std::int64_t last_open_ms{0};
+    std::uint64_t data_hash{0};     // dataset_hash az első `bars` baron
+    std::vector<char> modules;      // a score-pipeline serialize() blobja
+    State state;
+    std::vector<Trade> trades;      // lezárt trade-ek (a vég-zárás nélkül, az a State-ből újra előáll)
+
+    // a cols az első `bars` baron pontosan a checkpoint adatsora-e (időbélyeg + hash)
+    bool extends(const BarColumns& cols) const;
+};
+
+// a checkpoint fejléc mezőinek kitöltése a feldolgozott adatsorból (bars, last_open_ms, data_hash)
+void stamp(Checkpoint& ck, const BarColumns& processed);
+
+// Atomikusan ír (ideiglenes fájl + rename). Hibánál false, az ok az err-be kerül.
+bool save_checkpoint(const std::string& path, const Checkpoint& ck, std::string* err = nullptr);
+// false: nincs meg, ismeretlen verzió vagy sérült (ck ekkor változatlan)
+bool load_checkpoint(const std::string& path, Checkpoint& ck, std::string* err = nullptr);
+
+} // namespace backtest
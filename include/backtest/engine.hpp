@@ -0,0 +1,324 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "core/types.hpp"
+#include "core/bar_columns.hpp"
+#include "backtest/metrics.hpp"
+#include "util/binio.hpp"
+
+// Közös backtest-mag (CLI, GUI, grid/optimizer, walk-forward): long-only, egyetlen pozíció,
+// cserélhető díj- és pozícióméret-modellel. A futás baronként nem foglal memóriát: a kimeneteket
+// (equity görbe, trade lista) a hívó vagy az Engine előre lefoglalja.
+namespace backtest {
+
+// --- díjmodellek: fee(notional) oldalanként; max_notional: a cash-ből vehető legnagyobb notional úgy,
+// hogy a belépő díj mellett a (legfeljebb a belépési árú) zárás díja is megmaradjon – a cash így a
+// teljes kör után sem lesz negatív
+struct PercentFee {
+    double rate{0.0004};
+    double operator()(double notional) const { return notional*rate; }
+    double max_notional(double cash) const { return std::max(0.0, cash/(1.0 + 2.0*rate)); }
+};
+struct FixedPlusPercentFee {
+    double fixed{0.0};
+    double rate{0.0004};
+    double operator()(double notional) const { return fixed + notional*rate; }
+    double max_notional(double cash) const { return std::max(0.0, (cash - 2.0*fixed)/(1.0 + 2.0*rate)); }
+};
+using FeeModel = std::variant<PercentFee, FixedPlusPercentFee>;
+
+// --- pozícióméret: belépő mennyiség (base) a szabad cash és az ár függvényében
+struct FractionOfCash {
+    double f{0.2};
+    double operator()(double cash, double px) const { return cash*f/px; }
+};
+struct FixedNotional {
+    double quote{1000.0};
+    double operator()(double, double px) const { return quote/px; }
+};
+struct FixedQty {
+    double qty{0.01};
+    double operator()(double, double) const { return qty; }
+};
+using SizingModel = std::variant<FractionOfCash, FixedNotional, FixedQty>;
+
+// --- OCO bracket (mint élesben az oco_sell_bracket): belépés után TP limit + SL stop a belépési árhoz képest.
+// A szinteket a következő bartól a bar high/low-ján nézzük; gapnél (a nyitó már a szint túloldalán)
+// a stop a nyitóáron, a target a limit áron teljesül. A stop-limit limit részét nem modellezzük.
+enum class TieBreak {
+    StopFirst,      // ha egy baron belül mindkét szint érintett: a stop (konzervatív)
+    TargetFirst,    // ... a target (optimista)
+    NearestOpen     // ... amelyik közelebb van a bar nyitóárához
+};
+struct Bracket {
+    double tp_pct{0.0};     // %, 0 = nincs target
+    double sl_pct{0.0};     // %, 0 = nincs stop
+    TieBreak tie{TieBreak::StopFirst};
+    bool enabled() const { return tp_pct > 0.0 || sl_pct > 0.0; }
+};
+
+// Finomabb (pl. 1m) barok a [from_ms, to_ms) intervallumra; üres, ha nincs adat. Csak azokra a
+// barokra hívódik, ahol a bracket mindkét szintje érintett, így a forrás lustán tölthet.
+using IntrabarFn = std::function<BarColumns(std::int64_t from_ms, std::int64_t to_ms)>;
+
+struct Params {
+    double cash{10000.0};
+    double up{70.0};        // combined > up   -> Long
+    double down{30.0};      // combined < down -> zárás
+    FeeModel fee{PercentFee{}};
+    SizingModel sizing{FractionOfCash{}};
+    Bracket bracket{};
+    IntrabarFn intrabar{};  // üres: a döntetlent a bracket.tie dönti el
+};
+
+enum class ExitReason : std::uint8_t { Signal, StopLoss, TakeProfit, End };
+
+struct Trade {
+    std::size_t entry_i{0}, exit_i{0};
+    double qty{0.0}, entry_px{0.0}, exit_px{0.0};
+    double pnl{0.0};        // mindkét oldali díjjal csökkentve
+    double ret{0.0};        // pnl / belépés előtti equity (Monte Carlo újramintavételhez)
+    ExitReason reason{ExitReason::Signal};
+};
+
+struct Result {
+    double final_eq{0.0};
+    double maxdd{0.0};      // 0..1
+    int trades{0}, wins{0};
+    double gross_win{0.0}, gross_loss{0.0};
+    double fees{0.0};
+    int stops{0}, targets{0};   // bracket zárások
+    int drilled{0};             // finomabb barokkal eldöntött döntetlenek
+    int ties{0};                // a TieBreak szabállyal eldöntött döntetlenek
+    Metrics metrics;            // Sharpe/Sortino, kitettség, átlagos trade, leghosszabb drawdown, ...
+
+    double pf() const { return gross_loss > 0? gross_win/gross_loss : (gross_win > 0? 1e9 : 0.0); }
+    double winrate() const { return trades? static_cast<double>(wins)/trades : 0.0; }
+};
+
+// kombinált score -> jel, decide() küszöbeivel
+struct ScoreThresholds {
+    std::span<const double> combined;
+    double up{70.0}, down{30.0};
+    Signal operator()(std::size_t i) const {
+        const double c = combined[i];
+        return c > up? Signal::Long : (c < down? Signal::Short : Signal::Neutral);
+    }
+};
+
+// legfeljebb ennyi trade lehet n baron (bracket zárás után ugyanazon bar záróján újra be lehet lépni)
+inline std::size_t max_trades(std::size_t n){ return n + 1; }
+
+namespace detail {
+
+enum class Touch { None, Stop, Target, Both };
+
+// egy bar a bracket szintjeihez (sl/tp <= 0: nincs); px: a teljesülés ára
+inline Touch touch(double o, double h, double l, double sl, double tp, double& px){
+    if (sl > 0.0 && o <= sl){ px = o; return Touch::Stop; }
+    if (tp > 0.0 && o >= tp){ px = tp; return Touch::Target; }
+    const bool s = sl > 0.0 && l <= sl, t = tp > 0.0 && h >= tp;
+    if (s && t) return Touch::Both;
+    if (s){ px = sl; return Touch::Stop; }
+    if (t){ px = tp; return Touch::Target; }
+    return Touch::None;
+}
+
+inline Touch tie_break(TieBreak tb, double o, double sl, double tp, double& px){
+    const bool stop = tb == TieBreak::StopFirst || (tb == TieBreak::NearestOpen && o - sl <= tp - o);
+    px = stop? sl : tp;
+    return stop? Touch::Stop : Touch::Target;
+}
+
+} // namespace detail
+
+// Folytatható futási állapot az utolsó feldolgozott bar után, a vég-zárás (ExitReason::End) előtt:
+// pozíció, cash, futó számlálók és metrikák. Egy hosszabb adatsor új barjain advance()-szel
+// folytatva ugyanazt adja, mint a teljes újrafuttatás (checkpoint: backtest/checkpoint.hpp).
+struct State {
+    double cash{0.0}, qty{0.0}, entry{0.0}, entry_fee{0.0}, entry_eq{0.0}, sl{0.0}, tp{0.0};
+    double last_close{0.0};
+    std::size_t entry_i{0};     // globális barindex
+    std::size_t bars{0};        // eddig feldolgozott barok; a következő bar globális indexe
+    Result r;                   // fees, bracket-számlálók, metrics (a többi mezőt a finish() tölti)
+
+    State() = default;
+    explicit State(double cash0): cash(cash0) { r.metrics.reset(cash0); }
+
+    void serialize(util::BinWriter& w) const;
+    bool deserialize(util::BinReader& r);
+};
+
+namespace detail {
+
+template<class Fee>
+void exit_at(State& s, const Fee& fee, std::size_t i, double px, ExitReason why, std::vector<Trade>* trades){
+    const double f = fee(s.qty*px);
+    const double pnl = s.qty*(px - s.entry) - s.entry_fee - f;
+    s.cash += s.qty*px - f;
+    s.r.fees += f;
+    s.r.metrics.on_trade(pnl, i - s.entry_i);
+    if (why == ExitReason::StopLoss) ++s.r.stops;
+    if (why == ExitReason::TakeProfit) ++s.r.targets;
+    if (trades) trades->push_back({s.entry_i, i, s.qty, s.entry, px, pnl, s.entry_eq > 0.0? pnl/s.entry_eq : 0.0, why});
+    s.qty = 0.0;
+}
+
+} // namespace detail
+
+// A mag. sig(i) -> Signal; Long jelre belép a záróáron (ha nincs pozíció), Short jelre zár. A belépő
+// mennyiséget a két oldali díjjal együtt a cash-re korlátozza; elfogyott cash-sel nem lép be.
+// p.bracket esetén a nyitott pozíciót a következő bartól TP/SL is zárhatja (lásd Bracket, IntrabarFn).
+// advance(): a bars a st.bars. globális indextől folytatja az st állapotot (a nyitott pozíció nyitva
+// marad); sig és equity lokális (0-tól) indexelt, a trade-indexek globálisak.
+// equity: üres vagy legalább bars.size() hosszú (mark-to-market); trades: nullptr vagy elég kapacitású
+// vektor (max_trades(n); push_back így nem foglal).
+template<class Strategy, class Fee, class Sizing>
+void advance(const BarColumns& bars, Strategy&& sig, const Fee& fee, const Sizing& size, const Params& p,
+             State& st, std::span<double> equity = {}, std::vector<Trade>* trades = nullptr){
+    State s = st;   // lokális másolat: a ciklusban regiszterben maradhat (az equity-írás nem aliasolhatja)
+    const std::size_t n = bars.size(), base = s.bars;
+    const auto close = bars.close;
+    const bool bracket = p.bracket.enabled();
+    const bool drill = bracket && p.intrabar && bars.open_time_ms.size() == n;
+
+    // a bar TP/SL találata; döntetlennél a finomabb barok (ha vannak), különben a TieBreak szabály.
+    // A szakasz utolsó barjánál a következő nyitás nem ismert: az intervallum az előző bar hosszával számol.
+    auto check_bracket = [&](std::size_t i){
+        const double c = close[i];
+        const double o = bars.open.empty()? c : bars.open[i];
+        const double h = bars.high.empty()? c : bars.high[i];
+        const double l = bars.low.empty()?  c : bars.low[i];
+        double px = 0.0;
+        auto t = detail::touch(o, h, l, s.sl, s.tp, px);
+        if (t == detail::Touch::Both){
+            double tie_open = o;
+            if (drill){
+                const std::int64_t t0 = bars.open_time_ms[i];
+                const std::int64_t t1 = (i + 1 < n)? bars.open_time_ms[i+1] : t0 + (i > 0? t0 - bars.open_time_ms[i-1] : 0);
+                const BarColumns sub = p.intrabar(t0, t1);
+                for (std::size_t k = 0; k < sub.size(); ++k){
+                    const Bar m = sub.at(k);
+                    const auto tk = detail::touch(m.open, m.high, m.low, s.sl, s.tp, px);
+                    if (tk == detail::Touch::None) continue;
+                    t = tk; tie_open = m.open;
+                    break;
+                }
+                if (t != detail::Touch::Both) ++s.r.drilled;
+            }
+            if (t == detail::Touch::Both){ ++s.r.ties; t = detail::tie_break(p.bracket.tie, tie_open, s.sl, s.tp, px); }
+        }
+        if (t == detail::Touch::Stop) detail::exit_at(s, fee, base + i, px, ExitReason::StopLoss, trades);
+        else if (t == detail::Touch::Target) detail::exit_at(s, fee, base + i, px, ExitReason::TakeProfit, trades);
+    };
+
+    for (std::size_t i = 0; i < n; ++i){
+        const double c = close[i];
+        if (bracket && s.qty > 0.0 && base + i > s.entry_i) check_bracket(i);
+        const Signal sg = sig(i);
+        if (sg == Signal::Long && s.qty == 0.0 && s.cash > 0.0){
+            const double q = std::min(size(s.cash, c), fee.max_notional(s.cash)/c);
+            if (q > 0.0){
+                s.qty = q; s.entry = c; s.entry_i = base + i; s.entry_eq = s.cash;
+                s.entry_fee = fee(q*c);
+                s.cash -= q*c + s.entry_fee;
+                s.r.fees += s.entry_fee;
+                s.sl = p.bracket.sl_pct > 0.0? c*(1.0 - p.bracket.sl_pct/100.0) : 0.0;
+                s.tp = p.bracket.tp_pct > 0.0? c*(1.0 + p.bracket.tp_pct/100.0) : 0.0;
+            }
+        } else if (sg == Signal::Short && s.qty > 0.0){
+            detail::exit_at(s, fee, base + i, c, ExitReason::Signal, trades);
+        }
+        const double eq = s.cash + s.qty*c;
+        s.r.metrics.on_bar(eq, s.qty > 0.0);
+        if (!equity.empty()) equity[i] = eq;
+    }
+    if (n > 0){ s.last_close = close[n-1]; s.bars = base + n; }
+    st = s;
+}
+
+// Az állapot lezárása: a nyitott pozíció az utolsó záróáron zár (ExitReason::End), és a Result
+// összesítő mezői a metrikákból töltődnek. Az st nem változik (egy checkpoint tovább folytatható).
+template<class Fee>
+Result finish(const State& st, const Fee& fee, std::vector<Trade>* trades = nullptr){
+    State s = st;
+    if (s.qty > 0.0 && s.bars > 0) detail::exit_at(s, fee, s.bars - 1, s.last_close, ExitReason::End, trades);
+    Result r = s.r;
+    const Metrics& m = r.metrics;
+    r.final_eq = s.cash;
+    r.maxdd = m.maxdd();
+    r.trades = m.trades(); r.wins = m.wins();
+    r.gross_win = m.gross_win(); r.gross_loss = m.gross_loss();
+    return r;
+}
+
+// teljes futás: advance() p.cash-ről + finish(); equity utolsó eleme a záró cash
+template<class Strategy, class Fee, class Sizing>
+Result run(const BarColumns& bars, Strategy&& sig, const Fee& fee, const Sizing& size, const Params& p,
+           std::span<double> equity = {}, std::vector<Trade>* trades = nullptr){
+    State st(p.cash);
+    advance(bars, sig, fee, size, p, st, equity, trades);
+    const Result r = finish(st, fee, trades);
+    if (!equity.empty() && bars.size() > 0) equity[bars.size()-1] = r.final_eq;
+    return r;
+}
+
+// a fenti három a futásidejű modellekkel (egy std::visit a ciklus előtt, a ciklus monomorf)
+template<class Strategy>
+Result run(const BarColumns& bars, Strategy&& sig, const Params& p,
+           std::span<double> equity = {}, std::vector<Trade>* trades = nullptr){
+    return std::visit([&](const auto& fee, const auto& size){
+        return run(bars, sig, fee, size, p, equity, trades);
+    }, p.fee, p.sizing);
+}
+template<class Strategy>
+void advance(const BarColumns& bars, Strategy&& sig, const Params& p, State& st,
+             std::span<double> equity = {}, std::vector<Trade>* trades = nullptr){
+    std::visit([&](const auto& fee, const auto& size){
+        advance(bars, sig, fee, size, p, st, equity, trades);
+    }, p.fee, p.sizing);
+}
+inline Result finish(const State& st, const Params& p, std::vector<Trade>* trades = nullptr){
+    return std::visit([&](const auto& fee){ return finish(st, fee, trades); }, p.fee);
+}
+
+// Újrahasznosítható kimeneti pufferekkel futtató motor: prepare(n) egyszer foglal, az azonos vagy
+// kisebb méretű további futások már nem.
+class Engine {
+public:
+    void prepare(std::size_t n);
+    // kombinált score sorozat (= decide() baronként) a p küszöbeivel
+    const Result& run(const BarColumns& bars, std::span<const double> combined, const Params& p);
+    // folytatás az st állapotból (csak az új barok; st továbblép): result() a lezárt eredmény, equity()
+    // az új barokra szól, trades() az új trade-ek (a lezáráskor nyitott pozíció ExitReason::End trade-je is)
+    const Result& resume(const BarColumns& bars, std::span<const double> combined, const Params& p, State& st);
+
+    const Result& result() const { return res_; }
+    std::span<const double> equity() const { return {equity_.data(), n_}; }
+    const std::vector<Trade>& trades() const { return trades_; }
+
+private:
+    std::vector<double> equity_;
+    std::vector<Trade> trades_;
+    std::size_t n_{0};
+    Result res_{};
+};
+
+// Modell-leírók (CLI / GUI mező):
+//   díj:   "0.0004" (arány) vagy "0.5+0.0004" (fix + arány)
+//   méret: "cash:0.2" (a cash része), "notional:1000" (quote összeg), "qty:0.01" (base mennyiség)
+//   bracket: "tp%:sl%[:stop|target|open]", pl. "2:1.5" vagy "2:1.5:open"
+bool parse_fee(std::string_view s, FeeModel& out);
+bool parse_sizing(std::string_view s, SizingModel& out);
+bool parse_bracket(std::string_view s, Bracket& out);
+std::string to_string(const FeeModel& f);
+std::string to_string(const SizingModel& s);
+
+} // namespace backtest
@@ -0,0 +1,116 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "util/binio.hpp"
+
+namespace backtest {
+
+// Inkrementális backtest-metrikák: baronként (equity) és zárt trade-enként O(1) frissítés, tárolt
+// sorozat nélkül. A bar-hozamok átlaga/szórása az összegükből és négyzetösszegükből (a baronkénti
+// ciklusban nincs láncolt osztás); a Sortino a negatív hozamok négyzetösszegéből (a nevező az összes bar).
+class Metrics {
+public:
+    Metrics() = default;
+    explicit Metrics(double cash0): prev_(cash0), peak_(cash0) {}
+
+    void reset(double cash0){ *this = Metrics(cash0); }
+
+    // bar vége: mark-to-market equity, és hogy volt-e nyitott pozíció
+    void on_bar(double eq, bool in_position){
+        n_ret_ += prev_ > 0.0;
+        if (eq != prev_ && prev_ > 0.0){   // pozíció nélkül a hozam 0: nincs osztás
+            const double r = eq/prev_ - 1.0;
+            sum_ += r;
+            sum2_ += r*r;
+            down2_ += r < 0.0? r*r : 0.0;
+        }
+        prev_ = eq;
+        ++bars_;
+        bars_in_pos_ += in_position;
+        if (eq >= peak_){ peak_ = eq; dd_len_ = 0; return; }
+        ++dd_len_;
+        longest_dd_ = std::max(longest_dd_, dd_len_);
+        maxdd_ = std::max(maxdd_, (peak_ - eq)/std::max(1.0, peak_));
+    }
+
+    // zárt trade: díjakkal csökkentett PnL és a tartás hossza barban
+    void on_trade(double pnl, std::size_t bars_held){
+        ++trades_;
+        sum_pnl_ += pnl;
+        held_ += bars_held;
+        if (pnl > 0.0){ ++wins_; gross_win_ += pnl; best_ = std::max(best_, pnl); }
+        else { gross_loss_ -= pnl; worst_ = std::min(worst_, pnl); }
+    }
+
+    // --- trade szint
+    int trades() const { return trades_; }
+    int wins() const { return wins_; }
+    double gross_win() const { return gross_win_; }
+    double gross_loss() const { return gross_loss_; }
+    double pf() const { return gross_loss_ > 0? gross_win_/gross_loss_ : (gross_win_ > 0? 1e9 : 0.0); }
+    double winrate() const { return trades_? static_cast<double>(wins_)/trades_ : 0.0; }
+    double avg_trade() const { return trades_? sum_pnl_/trades_ : 0.0; }
+    double avg_win() const { return wins_? gross_win_/wins_ : 0.0; }
+    double avg_loss() const { return trades_ > wins_? gross_loss_/(trades_ - wins_) : 0.0; }
+    double best_trade() const { return best_; }
+    double worst_trade() const { return worst_; }
+    double avg_bars_held() const { return trades_? static_cast<double>(held_)/trades_ : 0.0; }
+
+    // --- bar szint
+    std::size_t bars() const { return bars_; }
+    double exposure() const { return bars_? static_cast<double>(bars_in_pos_)/static_cast<double>(bars_) : 0.0; }
+    double maxdd() const { return maxdd_; }                    // 0..1
+    std::size_t longest_dd_bars() const { return longest_dd_; } // a leghosszabb csúcs alatti szakasz
+    double mean_return() const { return n_ret_? sum_/static_cast<double>(n_ret_) : 0.0; }
+    double stdev_return() const {
+        if (n_ret_ < 2) return 0.0;
+        const double n = static_cast<double>(n_ret_), mu = sum_/n;
+        return std::sqrt(std::max(0.0, (sum2_ - n*mu*mu)/(n - 1.0)));
+    }
+    // évesítve: periods_per_year = bar / év (pl. M5: 105120)
+    double sharpe(double periods_per_year) const {
+        const double sd = stdev_return();
+        return sd > 0.0? mean_return()/sd*std::sqrt(periods_per_year) : 0.0;
+    }
+    double sortino(double periods_per_year) const {
+        const double dd = n_ret_? std::sqrt(down2_/static_cast<double>(n_ret_)) : 0.0;
+        return dd > 0.0? mean_return()/dd*std::sqrt(periods_per_year) : 0.0;
+    }
+
+    // teljes állapot (checkpoint); a folytatás bitre ugyanazt adja, mint a megszakítás nélküli futás
+    void serialize(util::BinWriter& w) const {
+        w.put(prev_); w.put(peak_); w.put(maxdd_); w.put(sum_); w.put(sum2_); w.put(down2_);
+        w.put<std::uint64_t>(n_ret_);
+        for (std::size_t v : {bars_, bars_in_pos_, dd_len_, longest_dd_, held_}) w.put<std::uint64_t>(v);
+        w.put<std::int32_t>(trades_); w.put<std::int32_t>(wins_);
+        w.put(gross_win_); w.put(gross_loss_); w.put(sum_pnl_); w.put(best_); w.put(worst_);
+    }
+    bool deserialize(util::BinReader& r){
+        r.get(prev_); r.get(peak_); r.get(maxdd_); r.get(sum_); r.get(sum2_); r.get(down2_);
+        n_ret_ = r.get<std::uint64_t>();
+        for (std::size_t* v : {&bars_, &bars_in_pos_, &dd_len_, &longest_dd_, &held_}) *v = r.get<std::uint64_t>();
+        trades_ = r.get<std::int32_t>(); wins_ = r.get<std::int32_t>();
+        r.get(gross_win_); r.get(gross_loss_); r.get(sum_pnl_); r.get(best_); r.get(worst_);
+        return r.ok();
+    }
+
+private:
+    // bar szint
+    double prev_{0.0}, peak_{0.0}, maxdd_{0.0};
+    double sum_{0.0}, sum2_{0.0}, down2_{0.0};
+    std::uint64_t n_ret_{0};
+    std::size_t bars_{0}, bars_in_pos_{0}, dd_len_{0}, longest_dd_{0};
+    // trade szint
+    int trades_{0}, wins_{0};
+    double gross_win_{0.0}, gross_loss_{0.0}, sum_pnl_{0.0}, best_{0.0}, worst_{0.0};
+    std::size_t held_{0};
+};
+
+// bar / év a bar hosszából (ms); 0 vagy negatív hossznál 1 (évesítés nélkül)
+inline double periods_per_year(std::int64_t bar_ms){
+    return bar_ms > 0? 365.0*24*3600*1000 / static_cast<double>(bar_ms) : 1.0;
+}
+
+} // namespace backtest
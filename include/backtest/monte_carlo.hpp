@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "backtest/engine.hpp"
+#include "util/job_control.hpp"
+
+// Monte Carlo a trade-listán: a trade-hozamokat (Trade::ret, a belépés előtti equity arányában)
+// sokszor újramintavételezi, és a kapott equity-pályák záró hozamából és drawdownjából
+// konfidencia-intervallumot ad. A drawdown trade-zárásonként mért (a trade-en belüli mélypontot nem látja).
+namespace backtest {
+
+enum class Resample {
+    Bootstrap,  // visszatevéses mintavétel: a hozam és a drawdown is szór
+    Shuffle     // permutáció: a záró hozam minden futásban azonos, csak a sorrend (drawdown) változik
+};
+
+struct MonteCarloConfig {
+    std::size_t runs{5000};
+    unsigned threads{0};            // 0: hardware_concurrency
+    std::uint64_t seed{1};          // azonos seed -> azonos eredmény, a szálszámtól függetlenül
+    Resample mode{Resample::Bootstrap};
+    double cash{10000.0};
+};
+
+struct Interval { double p5{0.0}, p50{0.0}, p95{0.0}; };
+
+struct MonteCarloResult {
+    std::size_t runs{0}, trades{0};
+    Interval ret;           // teljes hozam (final/cash - 1)
+    Interval maxdd;         // 0..1
+    Interval final_eq;
+    double p_loss{0.0};     // vesztes futások aránya
+    double ms{0.0};
+};
+
+// A futások szálanként összefüggő tartományokban mennek, futásonként saját (a seedből és a futás
+// indexéből vetett) generátorral, közös írható állapot és zár nélkül. ctl: futásonként lép; megszakításnál
+// az addig kész futásokból számol.
+MonteCarloResult monte_carlo(std::span<const Trade> trades, const MonteCarloConfig& cfg,
+                             util::JobControl* ctl = nullptr);
+
+} // namespace backtest
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "core/bar_columns.hpp"
+#include "backtest/engine.hpp"
+#include "backtest/metrics.hpp"
+
+// Több symbol egy közös (USDT) számlán: a symbolonkénti kombinált score-sorozatokat (a jelfázis,
+// symbolonként párhuzamosan számolható) időrendben, k-utas összefésüléssel egyetlen cash- és
+// pozíció-főkönyvön játssza le. Symbolonként long-only, egy pozíció, a Params küszöbeivel és díjmodelljével.
+//
+// Időrend: egy bar a záráskor (open_time + barhossz) válik ismertté, így eltérő timeframe-ű fájlok
+// is helyesen sorakoznak (az 1h bar a 12. 5m barral együtt zár). Azonos záráskor a symbolok
+// sorrendje dönt; a portfólió-equity és a metrikák záráspontonként egyszer frissülnek.
+namespace backtest {
+
+// symbolonkénti allokációs szabály
+struct Allocation {
+    double max_weight{1.0};     // a portfólió-equity legfeljebb ekkora része lehet ebben a symbolban (belépéskor)
+    SizingModel sizing{FractionOfCash{}};   // belépő méret a közös szabad cash-ből
+};
+
+struct PortfolioSymbol {
+    std::string name;
+    BarColumns bars;                    // open_time_ms kötelező
+    std::span<const double> combined;   // = decide() baronként (legalább bars.size() hosszú)
+    Allocation alloc;
+};
+
+struct PortfolioParams {
+    double cash{10000.0};
+    double up{70.0}, down{30.0};
+    FeeModel fee{PercentFee{}};
+    std::size_t max_positions{0};       // egyszerre nyitott pozíciók felső korlátja (0: nincs)
+};
+
+struct SymbolResult {
+    std::string name;
+    Metrics metrics;            // csak trade-szintű mezők (PF, winrate, átlagos trade, ...)
+    double pnl{0.0}, fees{0.0};
+    std::size_t bars{0};
+    int rejected{0};            // cash / súly / pozíciószám miatt elmaradt belépések
+};
+
+struct PortfolioResult {
+    double final_eq{0.0};
+    Metrics metrics;            // portfólió-equity záráspontonként + az összes trade
+    double fees{0.0};
+    std::size_t events{0};      // feldolgozott barok (minden symbol)
+    std::size_t steps{0};       // különböző záráspontok
+    std::vector<SymbolResult> symbols;
+};
+
+// a bar hossza (ms): a legkisebb pozitív open_time különbség (0, ha nem állapítható meg)
+std::int64_t bar_length_ms(const BarColumns& bars);
+// ugyanez Timeframe-ként (a modulok TF-függő része, pl. az MTF bucket ehhez igazodik);
+// false, ha nem állapítható meg vagy nem szabványos hossz (tf ilyenkor nem változik)
+bool bar_timeframe(const BarColumns& bars, Timeframe& tf);
+
+// equity / times != nullptr: záráspontonként a mark-to-market portfólió-equity és a zárás ideje
+// (az utolsó elem a minden pozíció zárása utáni cash)
+PortfolioResult run_portfolio(std::span<const PortfolioSymbol> syms, const PortfolioParams& p,
+                              std::vector<double>* equity = nullptr, std::vector<std::int64_t>* times = nullptr);
+
+// "BTCUSDT:0.5,ETHUSDT:0.3" -> symbolonkénti max_weight; a fel nem sorolt symbolok a def értéket kapják
+bool parse_allocation(std::string_view spec, std::span<PortfolioSymbol> syms, double def);
+
+} // namespace backtest
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "core/types.hpp"
+#include "core/tick_columns.hpp"
+#include "backtest/engine.hpp"
+
+// Tick-szintű lejátszás (Binance aggTrade): a barokat menet közben, a kötésekből építi (epoch-hoz
+// igazított bar_ms bucketek; kötés nélküli bucketből nem lesz bar), és minden lezárt bart átad a
+// jelfüggvénynek (a modulok ugyanúgy bar-szinten futnak, mint a bar-backtestben). A megbízások viszont
+// egyedi kötéseken teljesülnek:
+//  - market belépés / zárás: a bar zárása + latency utáni első kötés árán (nem a bar záróján);
+//  - stop: az első kötésen, aminek az ára <= sl, annak az árán (gapnél a szint alatt);
+//  - target (limit): az első kötésen, aminek az ára >= tp, a limit áron (a tp-n lévő kötés is
+//    teljesíti: a Bracket bar-szintű touch()-jával egyezően a szint érintése elég);
+// a szinteket a belépő kötés utáni kötésektől nézzük, így nincs döntetlen (a Params::intrabar és a
+// Bracket::tie itt nem játszik). Az állapot tickenként O(1): a feed() darabokban is hívható, a
+// bemenetet nem tárolja (mmap-elt .ticks fájlon a feldolgozott lapok eldobhatók).
+// A Trade indexek barindexek; a metrikák baronként (záráskor) frissülnek.
+namespace backtest {
+
+struct TickParams {
+    std::int64_t bar_ms{300'000};   // a modulok bar-hossza
+    std::int64_t latency_ms{0};     // jel (bar zárás) és a market megbízás beérkezése között
+};
+
+struct TickStats {
+    std::size_t ticks{0}, bars{0};
+    int fills{0};               // teljesült market megbízások
+    double slippage{0.0};       // Σ a kereskedő kárára eső relatív eltérés a jel barjának záróárától
+
+    // átlagos market slippage bázispontban (+: rosszabb, mint a záróár)
+    double avg_slippage_bps() const { return fills? slippage/fills*1e4 : 0.0; }
+};
+
+class TickReplay {
+public:
+    // lezárt bar -> jel (Long: belépés, ha nincs pozíció; Short: zárás)
+    using SignalFn = std::function<Signal(const Bar&)>;
+
+    // trades: nullptr vagy a lezárt trade-ek gyűjtője (trade-enként egy elem)
+    TickReplay(const Params& p, const TickParams& tp, SignalFn sig, std::vector<Trade>* trades = nullptr);
+
+    // a következő, időrendben folytatólagos kötések
+    void feed(const TickColumns& ticks);
+    // a részleges bar lezárása és a nyitott pozíció zárása az utolsó kötés árán (ExitReason::End)
+    Result finish();
+
+    const TickStats& stats() const { return stats_; }
+    const State& state() const { return st_; }
+
+private:
+    enum class Pending : std::uint8_t { None, Buy, Sell };
+
+    template<class Fee, class Sizing>
+    void feed_impl(const TickColumns& ticks, const Fee& fee, const Sizing& size);
+    void close_bar(State& s, const Bar& bar);
+
+    Params p_;
+    TickParams tp_;
+    SignalFn sig_;
+    std::vector<Trade>* trades_;
+    State st_;
+    TickStats stats_;
+    Bar bar_{};                 // az épülő bar
+    bool has_bar_{false};
+    std::int64_t bar_end_{0};
+    Pending pending_{Pending::None};
+    std::int64_t due_ms_{0};    // a függő market megbízás legkorábbi teljesülése
+    double ref_px_{0.0};        // a jel barjának záróára (slippage)
+};
+
+} // namespace backtest
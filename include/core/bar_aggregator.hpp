@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <algorithm>
+#include "core/types.hpp"
+#include "util/binio.hpp"
+
+// Streaming OHLCV aggregátor: alacsonyabb TF barokból (pl. M1/M5) időhöz igazított magasabb TF
+// barokat épít (H1/H4/D1 vagy tetszőleges bucket), a Bar::open_time_ms alapján, O(1) baronként.
+// A bucketek az epoch-hoz igazodnak (floor(open_time / bucket) * bucket), így a D1 UTC nap.
+// Egy bucket lezárul, ha
+//  - megjött az utolsó alacsony TF bar-ja (open_time + low_ms >= bucket vége), vagy
+//  - hiány (gap) után már a következő bucket bar-ja érkezik: ekkor a részleges bart zárjuk le.
+// Ismételt vagy visszafelé érkező bar (open_time <= utolsó) figyelmen kívül marad.
+class BarAggregator {
+public:
+    BarAggregator() = default;
+    BarAggregator(std::int64_t low_ms, std::int64_t bucket_ms): low_ms_(low_ms), bucket_ms_(bucket_ms) {}
+    BarAggregator(Timeframe low, Timeframe high): BarAggregator(tf_ms(low), tf_ms(high)) {}
+
+    void reset(){ has_partial_ = false; last_open_ = INT64_MIN; }
+
+    std::int64_t low_ms() const { return low_ms_; }
+    std::int64_t bucket_ms() const { return bucket_ms_; }
+
+    // a még nyitott (részleges) magasabb TF bar
+    bool has_partial() const { return has_partial_; }
+    const Bar& partial() const { return partial_; }
+
+    std::int64_t bucket_start(std::int64_t t) const {
+        const std::int64_t q = t / bucket_ms_;
+        return (t % bucket_ms_ < 0 ? q - 1 : q) * bucket_ms_;
+    }
+
+    // új alacsony TF bar; minden lezárt magasabb TF bart időrendben átad az on_close(const Bar&)-nek
+    template<class F>
+    void push(const Bar& b, F&& on_close){
+        if (bucket_ms_ <= 0 || b.open_time_ms <= last_open_) return;
+        last_open_ = b.open_time_ms;
+
+        const std::int64_t start = bucket_start(b.open_time_ms);
+        if (has_partial_ && start != partial_.open_time_ms){ // gap: az előző bucket vége hiányzott
+            has_partial_ = false;
+            on_close(partial_);
+        }
+        if (!has_partial_){
+            partial_ = b;
+            partial_.open_time_ms = start;
+            has_partial_ = true;
+        } else {
+            partial_.high = std::max(partial_.high, b.high);
+            partial_.low  = std::min(partial_.low,  b.low);
+            partial_.close = b.close;
+            partial_.volume += b.volume;
+        }
+        if (b.open_time_ms + low_ms_ >= start + bucket_ms_){
+            has_partial_ = false;
+            on_close(partial_);
+        }
+    }
+
+    // állapot mentése/visszatöltése (a low/bucket méret a konfiguráció része, azt nem írjuk)
+    void serialize(util::BinWriter& w) const { w.put(last_open_); w.put(has_partial_); w.put(partial_); }
+    bool deserialize(util::BinReader& r){ r.get(last_open_); r.get(has_partial_); r.get(partial_); return r.ok(); }
+
+private:
+    std::int64_t low_ms_{0};
+    std::int64_t bucket_ms_{0};
+    std::int64_t last_open_{INT64_MIN};
+    bool has_partial_{false};
+    Bar partial_{};
+};
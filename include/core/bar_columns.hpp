@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "core/types.hpp"
+
+// Oszlopos (struct-of-arrays) nézet barokra, batch feldolgozáshoz.
+// A close oszlop kötelező; a többi lehet üres (ekkor at() a close-t / 0-t használja).
+struct BarColumns {
+    std::span<const std::int64_t> open_time_ms;
+    std::span<const double> open, high, low, close, volume;
+
+    std::size_t size() const { return close.size(); }
+
+    Bar at(std::size_t i) const {
+        const double c = close[i];
+        return Bar{ open_time_ms.empty()? 0 : open_time_ms[i],
+                    open.empty()? c : open[i],
+                    high.empty()? c : high[i],
+                    low.empty()?  c : low[i],
+                    c,
+                    volume.empty()? 0.0 : volume[i] };
+    }
+
+    // [pos, pos+n) részintervallum
+    BarColumns subspan(std::size_t pos, std::size_t n) const {
+        auto cut = [&](auto s){ return s.empty()? s : s.subspan(pos, n); };
+        return { cut(open_time_ms), cut(open), cut(high), cut(low), cut(close), cut(volume) };
+    }
+};
+
+// FNV-1a az összes jelen levő oszlop bájtjain (optimizer cache-kulcs, checkpoint adatsor-ellenőrzés)
+inline std::uint64_t dataset_hash(const BarColumns& c){
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&](const void* p, std::size_t bytes){
+        const auto* b = static_cast<const unsigned char*>(p);
+        for (std::size_t i = 0; i < bytes; ++i){ h ^= b[i]; h *= 1099511628211ull; }
+    };
+    const std::uint64_t n = c.size();
+    mix(&n, sizeof(n));
+    mix(c.open_time_ms.data(), c.open_time_ms.size_bytes());
+    for (auto s : {c.open, c.high, c.low, c.close, c.volume}) mix(s.data(), s.size_bytes());
+    return h;
+}
+
+// Tulajdonos oszlopos bar-tábla (pl. CSV-ből betöltött teljes history).
+struct BarTable {
+    std::vector<std::int64_t> open_time_ms;
+    std::vector<double> open, high, low, close, volume;
+
+    std::size_t size() const { return close.size(); }
+    bool empty() const { return close.empty(); }
+    void reserve(std::size_t n){
+        open_time_ms.reserve(n); open.reserve(n); high.reserve(n); low.reserve(n); close.reserve(n); volume.reserve(n);
+    }
+    void push_back(const Bar& b){
+        open_time_ms.push_back(b.open_time_ms); open.push_back(b.open); high.push_back(b.high);
+        low.push_back(b.low); close.push_back(b.close); volume.push_back(b.volume);
+    }
+    Bar at(std::size_t i) const { return {open_time_ms[i], open[i], high[i], low[i], close[i], volume[i]}; }
+    BarColumns columns() const { return {open_time_ms, open, high, low, close, volume}; }
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include "core/types.hpp"
+#include "core/bar_columns.hpp"
+#include "util/ring_buffer.hpp"
+
+// Egy (Symbol, Timeframe) bar-története oszlopos OHLCV formában, fix kapacitású összefüggő
+// gyűrűkben. A modulok on_bar(sym, tf, series)-en keresztül csak olvassák; a history így
+// szimbólum/TF-enként egyszer van tárolva, nem modulonként.
+class BarSeries {
+public:
+    explicit BarSeries(std::size_t cap = 2000){ set_capacity(cap); }
+
+    void set_capacity(std::size_t cap){
+        t_.set_capacity(cap); o_.set_capacity(cap); h_.set_capacity(cap);
+        l_.set_capacity(cap); c_.set_capacity(cap); v_.set_capacity(cap);
+    }
+    void clear(){ t_.clear(); o_.clear(); h_.clear(); l_.clear(); c_.clear(); v_.clear(); }
+
+    void push(const Bar& b){
+        t_.push_back(b.open_time_ms); o_.push_back(b.open); h_.push_back(b.high);
+        l_.push_back(b.low); c_.push_back(b.close); v_.push_back(b.volume);
+    }
+
+    std::size_t size() const { return c_.size(); }
+    std::size_t capacity() const { return c_.capacity(); }
+    bool empty() const { return c_.empty(); }
+
+    // 0 = legrégebbi, size()-1 = legfrissebb
+    Bar at(std::size_t i) const { return {t_[i], o_[i], h_[i], l_[i], c_[i], v_[i]}; }
+    Bar back() const { return at(size()-1); }
+
+    // időrendi, összefüggő oszlopnézetek (a következő push-ig érvényesek)
+    std::span<const std::int64_t> open_time() const { return t_.view(); }
+    std::span<const double> open()   const { return o_.view(); }
+    std::span<const double> high()   const { return h_.view(); }
+    std::span<const double> low()    const { return l_.view(); }
+    std::span<const double> close()  const { return c_.view(); }
+    std::span<const double> volume() const { return v_.view(); }
+    BarColumns columns() const { return {open_time(), open(), high(), low(), close(), volume()}; }
+
+private:
+    util::RingBuffer<std::int64_t> t_;
+    util::RingBuffer<double> o_, h_, l_, c_, v_;
+};
+
+// Közös bar-tár: (Symbol, Timeframe) -> BarSeries. A visszaadott referencia stabil
+// (unordered_map elemei nem mozdulnak), a hívó megtarthatja. A kapacitás a modulok
+// history_bars()-ából jön (reserve_history), nem egy fix "elég nagy" érték: 6 oszlop, kétszeres tárolás.
+class BarStore {
+public:
+    explicit BarStore(std::size_t cap = 1): cap_(std::max<std::size_t>(cap, 1)) {}
+
+    // a meglévő és a később létrejövő series-ek legalább cap bart tartanak
+    void reserve_history(std::size_t cap){
+        if (cap <= cap_) return;
+        cap_ = cap;
+        for (auto& kv : map_) kv.second.set_capacity(cap_);
+    }
+    std::size_t capacity() const { return cap_; }
+
+    BarSeries& series(const Symbol& s, Timeframe tf){
+        auto it = map_.find(key(s, tf));
+        if (it == map_.end()) it = map_.emplace(key(s, tf), BarSeries(cap_)).first;
+        return it->second;
+    }
+    const BarSeries* find(const Symbol& s, Timeframe tf) const {
+        auto it = map_.find(key(s, tf));
+        return it == map_.end() ? nullptr : &it->second;
+    }
+    std::size_t size() const { return map_.size(); }
+
+private:
+    static std::string key(const Symbol& s, Timeframe tf){
+        return s.name() + "@" + std::to_string(static_cast<int>(tf));
+    }
+    std::size_t cap_;
+    std::unordered_map<std::string, BarSeries> map_;
+};
@@ -2,7 +2,11 @@
 #include <string>
 #include <deque>
 #include <algorithm>
+#include <span>
 #include "core/types.hpp"
+#include "core/bar_columns.hpp"
+#include "core/bar_series.hpp"
+#include "util/binio.hpp"
 
 // Egy modul visszatérési típusa
 struct ModuleResult {
@@ -27,6 +31,29 @@ public:
 
     // Új bar érkezésekor hívjuk; itt adja a score-t és a (Long/Short/Wait) javaslatot
     virtual ModuleResult on_bar(const Symbol&, Timeframe, const Bar&) = 0;
+
+    // Közös bar-tárból (core/bar_series.hpp): a series utolsó eleme az új bar, már betéve.
+    // History-t igénylő modulok innen olvasnak saját másolat helyett; egy modulpéldány egy
+    // series-hez tartozik. Alapértelmezésben csak az új bart adja tovább on_bar-nak.
+    virtual ModuleResult on_bar(const Symbol& s, Timeframe tf, const BarSeries& series) {
+        return on_bar(s, tf, series.back());
+    }
+    // Az on_bar(series) a series utolsó legfeljebb ennyi barját olvassa; a BarStore kapacitása ebből
+    // adódik (BarStore::reserve_history), így a közös history csak a tényleges ablakot tartja.
+    virtual std::size_t history_bars() const { return 1; }
+
+    // Batch hívás (backtest, warm-up): a cols minden barjára score-t ír az out-ba
+    // (out.size() >= cols.size()), és az állapotot úgy lépteti tovább, mintha on_bar-t hívtunk volna
+    // egyenként. Alapértelmezésben on_bar ciklus; a modulok saját (SIMD) kernelt adhatnak.
+    virtual void on_bars(const Symbol& s, Timeframe tf, const BarColumns& cols, std::span<double> out) {
+        for (std::size_t i = 0; i < cols.size(); ++i) out[i] = on_bar(s, tf, cols.at(i)).score;
+    }
+
+    // Állapot mentése/visszatöltése (data/snapshot.hpp: gyors újraindítás warmup nélkül).
+    // A blob a modul paramétereit is tartalmazza; deserialize false-t ad, ha nem ehhez a
+    // konfigurációhoz tartozik vagy sérült – ilyenkor a hívó reset()-el. Alapértelmezés: nem támogatott.
+    virtual bool serialize(util::BinWriter&) const { return false; }
+    virtual bool deserialize(util::BinReader&) { return false; }
 };
 
 // Kényelmi clamp 0..1 közé
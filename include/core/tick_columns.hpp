@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+// Egyedi kötések (Binance aggTrade) oszlopos nézete, időrendben. A time_ms és a price kötelező;
+// a qty és a flags lehet üres (ekkor 0 mennyiség / nincs jelző).
+struct TickColumns {
+    std::span<const std::int64_t> time_ms;
+    std::span<const double> price, qty;
+    std::span<const std::uint8_t> flags;    // kTickBuyerMaker, ...
+
+    static constexpr std::uint8_t kTickBuyerMaker = 1;  // a vevő volt a maker (= agresszív eladás)
+
+    std::size_t size() const { return price.size(); }
+
+    // [pos, pos+n) részintervallum
+    TickColumns subspan(std::size_t pos, std::size_t n) const {
+        auto cut = [&](auto s){ return s.empty()? s : s.subspan(pos, n); };
+        return { cut(time_ms), cut(price), cut(qty), cut(flags) };
+    }
+};
@@ -7,6 +7,29 @@
 // Időkeret
 enum class Timeframe { M1, M3, M5, M15, M30, H1, H4, D1 };
 
+// Időkeret hossza ms-ban
+inline std::int64_t tf_ms(Timeframe tf) {
+    constexpr std::int64_t m = 60'000;
+    switch (tf) {
+        case Timeframe::M1:  return m;
+        case Timeframe::M3:  return 3 * m;
+        case Timeframe::M5:  return 5 * m;
+        case Timeframe::M15: return 15 * m;
+        case Timeframe::M30: return 30 * m;
+        case Timeframe::H1:  return 60 * m;
+        case Timeframe::H4:  return 240 * m;
+        default:             return 1440 * m; // D1
+    }
+}
+
+// bar hossz (ms) -> Timeframe; false, ha egyik sem illik rá (tf ilyenkor nem változik)
+inline bool tf_from_ms(std::int64_t ms, Timeframe& tf) {
+    for (Timeframe t : {Timeframe::M1, Timeframe::M3, Timeframe::M5, Timeframe::M15,
+                        Timeframe::M30, Timeframe::H1, Timeframe::H4, Timeframe::D1})
+        if (tf_ms(t) == ms) { tf = t; return true; }
+    return false;
+}
+
 // Szimbólum
 struct Symbol {
     std::string base{"BTC"};
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "core/bar_columns.hpp"
+#include "data/mapped_file.hpp"
+
+namespace data {
+
+// Bináris oszlopos bar-fájl (".bars"): fejléc + fix szélességű oszlopok + ritka idő-index.
+// Olvasása mmap-pel, parse nélkül: a BarColumns közvetlenül a leképezett lapokra mutat.
+//
+//   [BarFileHeader, 128 B]
+//   [open_time i64 × count] [open f64 × count] [high] [low] [close] [volume]   (64 B-ra igazítva)
+//   [idő-index i64 × index_count]: index[k] = open_time[k * index_stride]
+//
+// Little-endian, natív IEEE double; a verzió emelésével bővíthető.
+struct BarFileHeader {
+    char magic[8];            // "HSBARS\0\0"
+    std::uint32_t version;    // kBarFileVersion
+    std::uint32_t header_bytes;
+    std::uint64_t count;
+    std::int64_t first_open_ms;
+    std::int64_t last_open_ms;
+    std::int64_t step_ms;     // egyenletes sorozatnál a barok távolsága, különben 0
+    std::uint32_t index_stride;
+    std::uint32_t flags;
+    std::uint64_t col_off[6]; // open_time, open, high, low, close, volume
+    std::uint64_t index_off;
+    std::uint64_t index_count;
+    std::uint64_t reserved;
+};
+static_assert(sizeof(BarFileHeader) == 128, "BarFileHeader layout");
+
+inline constexpr char kBarFileMagic[8] = {'H','S','B','A','R','S','\0','\0'};
+inline constexpr std::uint32_t kBarFileVersion = 1;
+
+// Kiírja a cols tartalmát (open_time és close kötelező, a hiányzó oszlop close-zal / 0-val töltődik).
+// A sorozatnak open_time szerint növekvőnek kell lennie. false, ha nem írható.
+bool write_bar_file(const std::string& path, const BarColumns& cols, std::uint32_t index_stride = 4096);
+
+// Az első bájtok alapján .bars fájl-e (kiterjesztéstől függetlenül).
+bool is_bar_file(const std::string& path);
+
+// Csak olvasható mmap-elt .bars fájl. Move-only; a columns() span-jei a példány élettartamáig érvényesek.
+class MappedBars {
+public:
+    MappedBars() = default;
+    ~MappedBars();
+    MappedBars(MappedBars&& o) noexcept;
+    MappedBars& operator=(MappedBars&& o) noexcept;
+    MappedBars(const MappedBars&) = delete;
+    MappedBars& operator=(const MappedBars&) = delete;
+
+    // megnyit + fejléc/méret ellenőrzés; hibánál false és error() kitöltve
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return file_.is_open(); }
+    const std::string& error() const { return err_; }
+    const BarFileHeader& header() const { return *hdr_; }
+    std::size_t size() const { return hdr_? static_cast<std::size_t>(hdr_->count) : 0; }
+
+    BarColumns columns() const { return cols_; }
+
+    // első bar, aminek open_time >= t (size(), ha nincs ilyen); az idő-indexszel csak egy
+    // index_stride hosszú blokkot kell a time oszlopból érinteni
+    std::size_t lower_bound(std::int64_t t) const;
+    // [from, to) open_time tartomány
+    BarColumns range(std::int64_t from_ms, std::int64_t to_ms) const;
+
+private:
+    bool fail(std::string msg);
+
+    MappedFile file_;
+    const BarFileHeader* hdr_{nullptr};
+    BarColumns cols_{};
+    std::span<const std::int64_t> index_{};
+    std::string err_;
+};
+
+} // namespace data
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "core/bar_columns.hpp"
+#include "data/bar_file.hpp"
+
+namespace data {
+
+struct CsvStats {
+    std::size_t lines{0};       // nem üres sorok (header nélkül)
+    std::size_t malformed{0};   // kihagyott, nem értelmezhető sorok
+    bool header{false};         // az első sor header volt
+};
+
+// CSV kline betöltés: open_time,open,high,low,close,volume[,...] soronként (Binance dump formátum),
+// opcionális header sorral. Nagy blokkokban olvas, a blokkot sorhatáron szálankénti darabokra vágja,
+// std::from_chars-szal parse-ol, és sorrendben fűzi össze. A hibás sorokat kihagyja és számolja.
+// A mikroszekundumos open_time-ot (újabb Binance dumpok) ms-ra váltja. threads = 0: hardware_concurrency.
+bool load_csv(const std::string& path, BarTable& out, CsvStats* stats = nullptr, unsigned threads = 0);
+
+// Backtest bemenet formátumtól függetlenül: .bars fájl (mmap, parse nélkül) vagy CSV.
+// A formátumot a fájl eleje dönti el, nem a kiterjesztés.
+class LoadedBars {
+public:
+    // csv_threads: a CSV parse szálszáma (0 = hardware_concurrency; batch futásnál 1, mert a
+    // párhuzamosság a fájlok szintjén van)
+    bool load(const std::string& path, unsigned csv_threads = 0);
+
+    BarColumns columns() const { return cols_; }
+    std::size_t size() const { return cols_.size(); }
+    bool empty() const { return cols_.size() == 0; }
+    bool mapped() const { return map_.is_open(); }
+    const std::string& error() const { return err_; }
+    const CsvStats& csv_stats() const { return csv_; }
+
+    // dataset_hash(columns()), betöltésenként egyszer számolva (optimizer cache-kulcs). Az első
+    // hívás nem szálbiztos: ha több szál használja a példányt, a betöltő hívja meg előbb.
+    std::uint64_t hash() const {
+        if (!hashed_){ hash_ = dataset_hash(cols_); hashed_ = true; }
+        return hash_;
+    }
+
+private:
+    MappedBars map_;
+    BarTable table_;
+    BarColumns cols_{};
+    CsvStats csv_{};
+    std::string err_;
+    mutable std::uint64_t hash_{0};
+    mutable bool hashed_{false};
+};
+
+// Lustán betöltött finomabb felbontású sorozat (pl. 1m a bracket döntetlenekhez): az első range()
+// hívás tölti be (.bars esetén mmap, így csak az érintett lapok olvasódnak). Szálbiztos; nem mozgatható.
+class LazyBars {
+public:
+    explicit LazyBars(std::string path): path_(std::move(path)) {}
+    LazyBars(const LazyBars&) = delete;
+    LazyBars& operator=(const LazyBars&) = delete;
+
+    // [from_ms, to_ms) open_time tartomány; üres, ha a fájl nem tölthető
+    BarColumns range(std::int64_t from_ms, std::int64_t to_ms);
+    bool loaded() const { return loaded_; }
+    const std::string& error() const { return bars_.error(); }
+
+private:
+    std::string path_;
+    std::once_flag once_;
+    LoadedBars bars_;
+    bool loaded_{false};
+};
+
+} // namespace data
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace data {
+
+// Csak olvasható, teljes fájlra szóló leképezés (POSIX mmap / Windows file mapping) a bináris
+// oszlopos fájlokhoz (.bars, .ticks). Move-only; a data() mutató a példány élettartamáig érvényes.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(MappedFile&& o) noexcept;
+    MappedFile& operator=(MappedFile&& o) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // hibánál false, az ok az err-be kerül; sequential: végigolvasásra optimalizált előolvasás
+    bool open(const std::string& path, std::string& err, bool sequential = true);
+    void close();
+
+    bool is_open() const { return base_ != nullptr; }
+    const char* data() const { return base_; }
+    std::size_t size() const { return bytes_; }
+
+    // a [off, off+len) tartomány teljes lapjai már nem kellenek: a leképezés lapjai felszabadulnak
+    // (a fájl tartalma a page cache-ben marad, újraolvasáskor visszatöltődik). Windows-on nincs hatása.
+    void release(std::size_t off, std::size_t len) const;
+
+private:
+    const char* base_{nullptr};
+    std::size_t bytes_{0};
+#ifdef _WIN32
+    void* file_{nullptr};
+    void* mapping_{nullptr};
+#else
+    int fd_{-1};
+#endif
+};
+
+} // namespace data
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "core/types.hpp"
+#include "core/module.hpp"
+#include "core/bar_series.hpp"
+
+namespace data {
+
+// Bináris állapot-snapshot egy (symbol, TF) párhoz: a közös bar-történet + minden modul
+// serialize() blobja id szerint. Újraindításkor visszatöltve a modulok azonnal kereskedésképesek,
+// nem kell kivárni a warmupot.
+//
+// Fájl: "HSNP" | u32 verzió | symbol | u8 tf | i64 utolsó open_time | series oszlopok |
+//       u32 modulszám | { id | u64 bloblen | blob }*
+struct SnapshotInfo {
+    std::int64_t last_open_time_ms{0};  // a snapshot utolsó barja (0, ha üres volt a series)
+    std::size_t bars{0};                // visszatöltött barok
+    std::size_t restored{0};            // sikeresen visszaállított modulok
+    std::size_t skipped{0};             // eltérő konfiguráció / hiányzó blob miatt reset-elt modulok
+};
+
+// <dir>/<SYMBOL>_<tf>.snap
+std::string snapshot_path(const std::string& dir, const Symbol& sym, Timeframe tf);
+
+// Atomikusan ír (ideiglenes fájl + rename); false, ha az írás nem sikerült.
+bool save_snapshot(const std::string& path, const Symbol& sym, Timeframe tf, const BarSeries& series,
+                   std::span<const std::unique_ptr<IModule>> modules);
+
+// Betölti a series-t és a modulokat. Modulpárosítás id szerint, sorrendben (azonos id többször is
+// szerepelhet). Amelyik modul blobja hiányzik vagy nem illeszkedik, reset()-et kap.
+// nullopt, ha a fájl nincs meg, sérült, vagy más symbol/TF-hez tartozik – ekkor semmi nem változik.
+std::optional<SnapshotInfo> load_snapshot(const std::string& path, const Symbol& sym, Timeframe tf,
+                                          BarSeries& series, std::span<const std::unique_ptr<IModule>> modules);
+
+} // namespace data
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "core/tick_columns.hpp"
+#include "data/mapped_file.hpp"
+
+namespace data {
+
+// Bináris oszlopos tick-fájl (".ticks", Binance aggTrade): fejléc + fix szélességű oszlopok.
+// A .bars párja: mmap-pel, parse nélkül olvasható, és mivel a replay egyszer, sorban megy végig
+// rajta, a már feldolgozott lapok release()-szel eldobhatók – a memóriaigény a fájl méretétől független.
+//
+//   [TickFileHeader, 128 B]
+//   [time i64 × capacity] [price f64 × capacity] [qty f64 × capacity] [flags u8 × capacity]   (64 B-ra igazítva)
+//
+// Az oszlopok az első count elemig érvényesek (capacity >= count: a konverzió előre foglal).
+struct TickFileHeader {
+    char magic[8];            // "HSTICKS\0"
+    std::uint32_t version;    // kTickFileVersion
+    std::uint32_t header_bytes;
+    std::uint64_t count;
+    std::uint64_t capacity;
+    std::int64_t first_ms;
+    std::int64_t last_ms;
+    std::int64_t first_id;    // aggTrade id (folytonossági ellenőrzéshez)
+    std::int64_t last_id;
+    std::uint64_t col_off[4]; // time, price, qty, flags
+    std::uint64_t reserved[4];
+};
+static_assert(sizeof(TickFileHeader) == 128, "TickFileHeader layout");
+
+inline constexpr char kTickFileMagic[8] = {'H','S','T','I','C','K','S','\0'};
+inline constexpr std::uint32_t kTickFileVersion = 1;
+
+struct TickCsvStats {
+    std::size_t lines{0};       // nem üres sorok (header nélkül)
+    std::size_t malformed{0};   // kihagyott, nem értelmezhető sorok
+    std::size_t id_gaps{0};     // hiányzó aggTrade id tartományok
+    bool header{false};
+};
+
+// aggTrade CSV -> .ticks, állandó memóriával (blokkonkénti olvasás, oszloponként pufferelt írás).
+// Sor: agg_id,price,qty,first_id,last_id,time,is_buyer_maker[,is_best_match]; opcionális header.
+// A µs időbélyeget ms-ra váltja. false, ha nem olvasható / írható, üres, vagy az idő visszalép
+// (az ok az err-be kerül).
+bool convert_aggtrades_csv(const std::string& csv, const std::string& out, TickCsvStats* stats = nullptr,
+                           std::string* err = nullptr);
+
+// Az első bájtok alapján .ticks fájl-e.
+bool is_tick_file(const std::string& path);
+
+// Csak olvasható mmap-elt .ticks fájl. Move-only; a columns() span-jei a példány élettartamáig érvényesek.
+class MappedTicks {
+public:
+    MappedTicks() = default;
+    MappedTicks(MappedTicks&& o) noexcept;
+    MappedTicks& operator=(MappedTicks&& o) noexcept;
+    MappedTicks(const MappedTicks&) = delete;
+    MappedTicks& operator=(const MappedTicks&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return file_.is_open(); }
+    const std::string& error() const { return err_; }
+    const TickFileHeader& header() const { return *hdr_; }
+    std::size_t size() const { return hdr_? static_cast<std::size_t>(hdr_->count) : 0; }
+
+    TickColumns columns() const { return cols_; }
+
+    // az első `upto` tick már nem kell: a leképezett lapjai felszabadulnak (RSS korlát a végigolvasáshoz);
+    // a span-ek érvényesek maradnak, újraolvasáskor a lapok visszatöltődnek
+    void release(std::size_t upto) const;
+
+private:
+    bool fail(std::string msg);
+
+    MappedFile file_;
+    const TickFileHeader* hdr_{nullptr};
+    TickColumns cols_{};
+    std::string err_;
+};
+
+} // namespace data
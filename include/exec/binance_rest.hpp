@@ -4,6 +4,7 @@
 #include <vector>
 #include <cstdint>
 #include <nlohmann/json.hpp>
+#include "core/types.hpp"
 
 namespace exec {
 
@@ -13,6 +14,7 @@ struct ApiConfig {
     std::string api_secret;
     bool testnet{true};
     int timeout_ms{5000};
+    std::string base_url;   // ha nem üres, ez az alap URL (pl. helyi stand-in: "http://127.0.0.1:8080")
 };
 
 // --- Order státusz enum
@@ -52,6 +54,10 @@ struct OcoResult {
     std::vector<uint64_t> extra_order_ids;
 };
 
+// GET /api/v3/klines válasz -> Bar-ok (időrendben). Ha now_ms > 0, a még nyitott
+// (closeTime >= now_ms) klinet eldobja, hogy csak lezárt bar kerüljön a modulokba.
+std::vector<Bar> parse_klines(const nlohmann::json& j, std::int64_t now_ms = 0);
+
 class BinanceRest {
 public:
     explicit BinanceRest(ApiConfig cfg);
@@ -69,6 +75,11 @@ public:
     OcoResult oco_sell_bracket(const std::string& symbol, double base_qty,
                                double tp_price, double sl_price, double sl_limit_price);
 
+    // GET klines (nyilvános): az utolsó `limit` lezárt kline, end_time_ms-ig (0: most).
+    // 1000 fölött visszafelé lapoz; az eredmény időrendi, open_time szerint egyedi.
+    std::vector<Bar> klines(const std::string& symbol, const std::string& interval,
+                            std::size_t limit = 500, std::int64_t end_time_ms = 0);
+
     // GET openOrders
     std::vector<OrderInfo> open_orders(const std::string& symbol);
 
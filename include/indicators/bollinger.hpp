@@ -1,21 +1,78 @@
 #pragma once
-#include <deque>
+#include <span>
 #include <algorithm>
+#include <cmath>
+#include <vector>
 #include "core/module.hpp"
+#include "util/ring_buffer.hpp"
 
 namespace ind {
 
 struct BB { double mid, upper, lower; };
-BB compute_bb(const std::deque<double>& v, size_t p=20, double k=2.0);
+BB compute_bb(std::span<const double> v, size_t p=20, double k=2.0);
+
+// Gördülő ablak átlag/variancia Welford-frissítéssel: új érték be, legrégebbi ki, O(1).
+// A lebegőpontos drift ellen a hívó időnként anchor()-ral kétmenetesen újraszámolja az ablakból.
+struct RollingStats {
+    size_t n{0};
+    double mean{0.0};
+    double m2{0.0};   // sum (x-mean)^2
+
+    void clear(){ n=0; mean=0.0; m2=0.0; }
+    void add(double x){
+        ++n; const double d = x-mean;
+        mean += d/static_cast<double>(n);
+        m2   += d*(x-mean);
+    }
+    // x_out elhagyja, x_in belép az ablakba (n változatlan)
+    void replace(double x_out, double x_in){
+        const double old = mean;
+        mean += (x_in-x_out)/static_cast<double>(n);
+        m2   += (x_in-x_out)*((x_in-mean) + (x_out-old));
+        if (m2<0.0) m2 = 0.0;
+    }
+    // kétmenetes újraszámolás [first,last) ablakból
+    template<class It> void anchor(It first, It last){
+        clear();
+        for (It it=first; it!=last; ++it){ mean += *it; ++n; }
+        if (n==0) return;
+        mean /= static_cast<double>(n);
+        for (It it=first; it!=last; ++it){ const double d=*it-mean; m2 += d*d; }
+    }
+    double variance() const { return n? std::max(0.0, m2/static_cast<double>(n)) : 0.0; } // populációs, mint compute_bb
+
+    void serialize(util::BinWriter& w) const { w.put<std::uint64_t>(n); w.put(mean); w.put(m2); }
+    bool deserialize(util::BinReader& r){ n = r.get<std::uint64_t>(); r.get(mean); r.get(m2); return r.ok(); }
+};
 
 class BollModule final : public IModule {
-    std::deque<double> closes; size_t period; double k_;
+    static constexpr size_t kReanchorEvery = 1024;
+    // saját history csak közös BarSeries nélküli használathoz (lusta foglalás)
+    util::RingBuffer<double> closes; size_t period; double k_;
+    RollingStats st_; size_t since_anchor_{0}; bool dirty_{false}; double last_{0.0};
+    std::vector<double> batch_mid_, batch_sd_;   // on_bars munkapufferei: csak nőnek, így a batch hívás nem foglal
+    void own_push(double c);
+    void reanchor(std::span<const double> view);
+    void update(std::span<const double> view);       // a gördülő állapot léptetése; view: history az új close-zal együtt
+    ModuleResult step(std::span<const double> view); // update + score
 public:
-    BollModule(size_t p=20, double k=2.0): period(p), k_(k) {}
+    BollModule(size_t p=20, double k=2.0): period(std::max<size_t>(p,1)), k_(k) {}
     std::string id() const override { return "BOLL"; }
     size_t warmup_bars() const override { return period + 5; }
-    void reset() override { closes.clear(); }
+    void reset() override { closes.clear(); st_.clear(); since_anchor_=0; dirty_=false; last_=0.0; }
     ModuleResult on_bar(const Symbol&, Timeframe, const Bar&) override;
+    ModuleResult on_bar(const Symbol&, Timeframe, const BarSeries&) override;
+    size_t history_bars() const override { return warmup_bars(); } // a warmup-feltétel a series hosszát nézi
+    void on_bars(const Symbol&, Timeframe, const BarColumns&, std::span<double> out) override;
+    bool serialize(util::BinWriter&) const override;
+    bool deserialize(util::BinReader&) override;
+
+    // futás közbeni paraméterállítás; periódusváltás után a következő bar a historyból újraszámol
+    void set_period(size_t p);
+    void set_k(double k){ k_ = k; }
+    size_t get_period() const { return period; }
+    double get_k() const { return k_; }
+    BB bands() const;
 }
 
 ; // <- fontos
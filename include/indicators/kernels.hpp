@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <span>
+
+// Batch (oszlopos) indikátor kernelek backtesthez.
+// Minden kernelnek van skalár, SSE2 és AVX2 változata; a megfelelőt futásidőben választjuk
+// (CPUID alapján, első hívásnál). Az ablakos kernelek kimenetenként ugyanabban a sorrendben
+// összegeznek, mint a compute_* referenciafüggvények, FMA nélkül – így az eredmény bitre azonos.
+// A rekurzív részek (EMA, Wilder-simítás) eleve szekvenciálisak, azok a modulokban maradnak
+// skalárisak; a score-leképezések viszont vektorizáltak.
+namespace ind::kernels {
+
+enum class Isa { Scalar, SSE2, AVX2 };
+
+Isa active_isa();
+const char* isa_name(Isa);
+// teszteléshez / összehasonlításhoz: adott ISA kényszerítése (ha a CPU nem tudja, marad a detektált)
+void force_isa(Isa);
+
+// out[j] = átlag(x[i-p+1 .. i]), ahol i = first + j;  first >= p-1
+void sma_series(std::span<const double> x, std::size_t p, std::size_t first, std::span<double> out);
+
+// kétmenetes Bollinger: mid[j] és sd[j] az x[i-p+1 .. i] ablakra, i = first + j;  first >= p-1
+void bb_series(std::span<const double> x, std::size_t p, std::size_t first,
+               std::span<double> mid, std::span<double> sd);
+
+// ablakos (egyszerű összeges) RSI az x[i-p .. i] záróárakra, i = first + j;  first >= p
+void rsi_window_series(std::span<const double> x, std::size_t p, std::size_t first, std::span<double> out);
+
+// keresztmetszeti lépések (minden elem egy másik szimbólum állapota), seedelt állapotokra:
+//  ema_step:    state[i] = x[i]*k + state[i]*(1-k)
+//  wilder_step: Wilder-féle átlag nyereség/veszteség frissítés p periódussal, prev = x
+void ema_step(std::span<double> state, std::span<const double> x, double k);
+void wilder_step(std::span<double> prev, std::span<double> avg_gain, std::span<double> avg_loss,
+                 std::span<const double> x, std::size_t p);
+void rsi_from_gain_loss(std::span<const double> avg_gain, std::span<const double> avg_loss, std::span<double> out);
+
+// score-leképezések (ugyanaz, mint az on_bar-okban)
+void ema_cross_score(std::span<const double> fast, std::span<const double> slow, std::span<double> out);
+void rsi_score(std::span<const double> rsi, std::span<double> out);
+void bb_score(std::span<const double> close, std::span<const double> mid, std::span<const double> sd,
+              double k, std::span<double> out);
+
+// súlyozott kombinált score bar-onként (decide() sorozatra, bitre azonos vele):
+// scores m×n soronként összefüggő mátrix (sor = modul), out[i] = Σk w[k]*(s[k][i]/100) / Σw * 100
+void combine_scores(std::span<const double> scores, std::size_t n, std::span<const double> w, std::span<double> out);
+// ugyanez külön tárolt sorokra (rows[k] a k. modul n hosszú score-sorozata, pl. cache-ből)
+void combine_score_rows(std::span<const double* const> rows, std::size_t n, std::span<const double> w, std::span<double> out);
+
+} // namespace ind::kernels
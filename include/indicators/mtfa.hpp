@@ -1,7 +1,6 @@
 #pragma once
 
 // --- standard
-#include <deque>
 #include <string>
 #include <algorithm>
 #include <cmath>
@@ -10,59 +9,101 @@
 // Fontos: előbb types, aztán module, hogy biztosan legyen IModule.
 #include "core/types.hpp"
 #include "core/module.hpp"
+#include "core/bar_aggregator.hpp"
+#include "indicators/sma_ema.hpp"
 
 namespace ind {
 
 // Egyszerű MTF "EMA-kereszt" modul.
-// factor_ = hány alacsonyabb TF bar tesz ki 1 magasabb TF bart (pl. 12: M5->H1)
+// A magasabb TF barokat idő szerint aggregálja (BarAggregator), nem darabszám alapján:
+//  - MtfSmaModule(factor, ...): bucket = factor * a bejövő TF hossza (pl. 12: M5->H1)
+//  - MtfSmaModule(Timeframe::H4, ...): bucket = a megadott magasabb TF
+// Ha egy közös aggregátor már előállítja a magasabb TF barokat, on_hi_bar()-ral közvetlenül
+// is etethető (ilyenkor on_bar nem kell).
 class MtfSmaModule final : public ::IModule {  // <- globális névtér
     std::size_t factor_{0};
+    Timeframe hi_tf_{Timeframe::H1};
     std::size_t fast_p_{0};
     std::size_t slow_p_{0};
 
-    std::deque<double> low_closes_;
-    std::deque<double> hi_closes_;
+    BarAggregator agg_;
+    std::int64_t low_ms_{0};     // amire az aggregátor be van állítva
+    std::size_t hi_bars_{0};     // lezárt HTF barok (warmup-hoz)
 
-    static double ema(const std::deque<double>& v, std::size_t p) {
-        if (v.empty()) return 0.0;
-        const double k = 2.0 / (p + 1.0);
-        double e = v.front();
-        for (std::size_t i = 1; i < v.size(); ++i) e = v[i] * k + e * (1.0 - k);
-        return e;
+    // streaming EMA-k a magasabb TF záróárain (zárt HTF baronként O(1))
+    EmaState ema_fast_;
+    EmaState ema_slow_;
+
+    void ensure_aggregator(Timeframe low){
+        const std::int64_t lm = tf_ms(low);
+        if (lm == low_ms_) return;
+        low_ms_ = lm;
+        agg_ = BarAggregator(lm, factor_ > 0 ? static_cast<std::int64_t>(factor_) * lm : tf_ms(hi_tf_));
+    }
+
+    void add_hi_close(double c){
+        ema_fast_.update(c);
+        ema_slow_.update(c);
+        if (hi_bars_ < warmup_bars()) ++hi_bars_;
+    }
+
+    ModuleResult evaluate() const {
+        if (hi_bars_ < warmup_bars())
+            return {50.0, Signal::Neutral, warmup_bars()};
+
+        const double e_fast = ema_fast_.value;
+        const double e_slow = ema_slow_.value;
+        const double diff = e_fast - e_slow;
+        const double norm = (std::abs(e_slow) > 1e-12 ? diff / e_slow : 0.0);
+        const double score = std::clamp(50.0 + norm * 5000.0, 0.0, 100.0);
+        const Signal s = (diff > 0 ? Signal::Long : diff < 0 ? Signal::Short : Signal::Neutral);
+        return {score, s, warmup_bars()};
     }
 
 public:
     MtfSmaModule(std::size_t factor, std::size_t fast_p, std::size_t slow_p)
-        : factor_(factor), fast_p_(fast_p), slow_p_(slow_p) {}
+        : factor_(factor), fast_p_(fast_p), slow_p_(slow_p), ema_fast_(fast_p), ema_slow_(slow_p) {}
+    MtfSmaModule(Timeframe hi_tf, std::size_t fast_p, std::size_t slow_p)
+        : hi_tf_(hi_tf), fast_p_(fast_p), slow_p_(slow_p), ema_fast_(fast_p), ema_slow_(slow_p) {}
 
     std::string id() const override { return "MTF_SMA"; }
     std::size_t warmup_bars() const override { return std::max(fast_p_, slow_p_) + 3; }
-    void reset() override { low_closes_.clear(); hi_closes_.clear(); }
+    void reset() override { agg_.reset(); hi_bars_ = 0; ema_fast_.reset(); ema_slow_.reset(); }
 
-    ModuleResult on_bar(const Symbol&, Timeframe, const Bar& b) override {
-        low_closes_.push_back(b.close);
+    ModuleResult on_bar(const Symbol&, Timeframe tf, const Bar& b) override {
+        ensure_aggregator(tf);
+        agg_.push(b, [this](const Bar& hb){ add_hi_close(hb.close); });
+        return evaluate();
+    }
 
-        // memóriakorlát
-        const std::size_t keep = std::max<std::size_t>(factor_ * (slow_p_ + 50), 512);
-        while (low_closes_.size() > keep) low_closes_.pop_front();
+    // egy kész (lezárt) magasabb TF bar közvetlenül, pl. közös BarAggregator kimenetéből
+    ModuleResult on_hi_bar(const Bar& hb) {
+        add_hi_close(hb.close);
+        return evaluate();
+    }
 
-        // minden factor_ bar után "zárunk" egy magasabb TF bart
-        if (factor_ > 0 && (low_closes_.size() % factor_) == 0) {
-            hi_closes_.push_back(b.close);
-            while (hi_closes_.size() > (slow_p_ + 50)) hi_closes_.pop_front();
+    bool serialize(util::BinWriter& w) const override {
+        w.put<std::uint64_t>(factor_); w.put(hi_tf_); w.put<std::uint64_t>(fast_p_); w.put<std::uint64_t>(slow_p_);
+        w.put(low_ms_); w.put<std::uint64_t>(hi_bars_);
+        agg_.serialize(w);
+        ema_fast_.serialize(w); ema_slow_.serialize(w);
+        return true;
+    }
+    bool deserialize(util::BinReader& r) override {
+        if (r.get<std::uint64_t>() != factor_ || r.get<Timeframe>() != hi_tf_ ||
+            r.get<std::uint64_t>() != fast_p_ || r.get<std::uint64_t>() != slow_p_) return false;
+        const std::int64_t lm = r.get<std::int64_t>();
+        hi_bars_ = std::min<std::size_t>(r.get<std::uint64_t>(), warmup_bars());
+        if (lm > 0){
+            low_ms_ = lm;
+            agg_ = BarAggregator(lm, factor_ > 0 ? static_cast<std::int64_t>(factor_) * lm : tf_ms(hi_tf_));
         }
-
-        if (hi_closes_.size() < warmup_bars())
-            return {50.0, Signal::Neutral, warmup_bars()};
-
-        const double e_fast = ema(hi_closes_, fast_p_);
-        const double e_slow = ema(hi_closes_, slow_p_);
-        const double diff = e_fast - e_slow;
-        const double norm = (std::abs(e_slow) > 1e-12 ? diff / e_slow : 0.0);
-        const double score = std::clamp(50.0 + norm * 5000.0, 0.0, 100.0);
-        const Signal s = (diff > 0 ? Signal::Long : diff < 0 ? Signal::Short : Signal::Neutral);
-        return {score, s, warmup_bars()};
+        agg_.deserialize(r);
+        return ema_fast_.deserialize(r) && ema_slow_.deserialize(r);
     }
+
+    // a belső aggregátor (pl. részleges HTF bar megjelenítéséhez)
+    const BarAggregator& aggregator() const { return agg_; }
 };
 
 } // namespace ind
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstdint>
+#include "core/module.hpp"
+
+namespace ind {
+
+struct MultiEngineConfig {
+    std::size_t ema_short{20};
+    std::size_t ema_long{50};
+    std::size_t rsi_period{14};
+    std::size_t bb_period{20};
+    double bb_k{2.0};
+};
+
+// Egy szimbólum eredménye egy lépésben: ugyanaz, mint a SmaEmaModule / RsiModule (Wilder) /
+// BollModule on_bar-ja ugyanarra a bar-sorozatra.
+struct MultiResult { ModuleResult sma_ema, rsi, boll; };
+
+// Sok szimbólum indikátorállapota struct-of-arrays formában: egy tömb a rövid/hosszú EMA-knak,
+// egy-egy a Wilder-átlagoknak, egy összefüggő tömb (N * bb_period) a Bollinger-ablakoknak stb.
+// step_all: minden szimbólum zárt egy bart (azonos TF) -> egy söprés, SIMD kernelekkel;
+// step:     csak a felsorolt szimbólumok léptetése (skalár út, ugyanazzal az eredménnyel).
+// Lépésenként nincs heap-allokáció (a munkatömbök a konstruktorban foglalódnak).
+class MultiSymbolEngine {
+public:
+    explicit MultiSymbolEngine(std::size_t n_symbols, MultiEngineConfig cfg = {});
+
+    std::size_t size() const { return n_; }
+    const MultiEngineConfig& config() const { return cfg_; }
+    void reset();
+
+    // closes[s] az s. szimbólum záróára; out.size() >= size()
+    void step_all(std::span<const double> closes, std::span<MultiResult> out);
+    // closes[i] a sym[i] szimbólum záróára; out[i] az eredménye
+    void step(std::span<const std::uint32_t> sym, std::span<const double> closes, std::span<MultiResult> out);
+
+private:
+    void update_one(std::size_t s, double close);   // teljes skalár állapotfrissítés
+    void update_bb(std::size_t s, double close);
+    void reanchor_bb(std::size_t s);
+    MultiResult result(std::size_t s, double sma_score, double rsi) const;
+    double sma_score(std::size_t s) const;
+
+    static constexpr std::uint32_t kReanchorEvery = 1024;  // mint BollModule
+
+    std::size_t n_{0};
+    MultiEngineConfig cfg_;
+    double k_short_{0.0}, k_long_{0.0};
+    std::size_t w_sma_{0}, w_rsi_{0}, w_bb_{0}, bb_cap_{0};
+
+    // állapot (SoA)
+    std::vector<std::uint64_t> bars_;       // eddig látott barok száma
+    std::vector<double> ema_s_, ema_l_;
+    std::vector<double> rsi_prev_, rsi_ag_, rsi_al_;
+    std::vector<double> bb_win_;            // n_ * bb_period, szimbólumonként gyűrű
+    std::vector<double> bb_mean_, bb_m2_;
+    std::vector<std::uint32_t> bb_since_;
+
+    // munkatömbök step_all-hoz
+    std::vector<double> tmp_sma_, tmp_rsi_;
+};
+
+} // namespace ind
@@ -1,20 +1,84 @@
 #pragma once
-#include <deque>
+#include <span>
 #include <algorithm>
+#include <vector>
 #include "core/module.hpp"
+#include "util/ring_buffer.hpp"
 
 namespace ind {
 
-double compute_rsi(const std::deque<double>& closes, size_t period);
+double compute_rsi(std::span<const double> closes, size_t period);
+
+// átlagos nyereség/veszteség -> RSI (0..100); a két számítási mód közös leképezése
+inline double rsi_from_gain_loss(double g, double l){
+    if (g==0 && l==0) return 50.0;
+    const double rs  = (l==0? 1000.0 : g/l);
+    const double rsi = 100.0 - (100.0/(1.0+rs));
+    return std::clamp(rsi, 0.0, 100.0);
+}
+
+// RSI számítási mód:
+//  Wilder – futó átlag nyereség/veszteség Wilder-simítással, O(1) baronként, history nélkül (alapértelmezés)
+//  Window – a régi forma: az utolsó `period` differencia egyszerű összege, baronként O(period) újraszámolással;
+//           opt-in, a korábbi backtestek eredményének reprodukálásához
+enum class RsiMode { Wilder, Window };
+
+// Inkrementális Wilder RSI állapot. Az első `period` differenciát egyszerű átlaggal seedeli,
+// utána avg = (avg*(p-1) + x) / p.
+struct RsiState {
+    size_t period{14};
+    size_t n{0};              // eddig látott differenciák száma
+    double prev{0.0};
+    bool has_prev{false};
+    double avg_gain{0.0}, avg_loss{0.0};
+
+    explicit RsiState(size_t p=14): period(std::max<size_t>(p,1)) {}
+    void reset(){ n=0; prev=0.0; has_prev=false; avg_gain=0.0; avg_loss=0.0; }
+
+    double update(double close){
+        if (!has_prev){ prev=close; has_prev=true; return 50.0; }
+        const double d = close - prev; prev = close;
+        const double g = (d>=0? d : 0.0), l = (d<0? -d : 0.0);
+        const double p = static_cast<double>(period);
+        if (n<period){
+            avg_gain += g/p; avg_loss += l/p; ++n;
+        } else {
+            avg_gain = (avg_gain*(p-1.0) + g)/p;
+            avg_loss = (avg_loss*(p-1.0) + l)/p;
+        }
+        return value();
+    }
+    double value() const { return n<period? 50.0 : rsi_from_gain_loss(avg_gain, avg_loss); }
+
+    // a period a modul paramétere, nem része a blobnak
+    void serialize(util::BinWriter& w) const {
+        w.put<std::uint64_t>(n); w.put(prev); w.put(has_prev); w.put(avg_gain); w.put(avg_loss);
+    }
+    bool deserialize(util::BinReader& r){
+        n = std::min<size_t>(r.get<std::uint64_t>(), period);
+        r.get(prev); r.get(has_prev); r.get(avg_gain); r.get(avg_loss);
+        return r.ok();
+    }
+};
 
 class RsiModule final : public IModule {
-    std::deque<double> closes; size_t period;
+    // saját history csak Window módban és közös BarSeries nélkül kell (lusta foglalás)
+    util::RingBuffer<double> closes; size_t period; RsiMode mode; RsiState st; size_t n{0};
+    std::vector<double> batch_rsi, batch_x;   // on_bars munkapufferei: csak nőnek, így a batch hívás nem foglal
+    void own_push(double c);
+    ModuleResult result(double rsi) const;
 public:
-    explicit RsiModule(size_t p=14): period(p) {}
+    explicit RsiModule(size_t p=14, RsiMode m=RsiMode::Wilder): period(p), mode(m), st(p) {}
     std::string id() const override { return "RSI"; }
     size_t warmup_bars() const override { return std::max<size_t>(period+1, 20); }
-    void reset() override { closes.clear(); }
+    void reset() override { closes.clear(); st.reset(); n=0; }
     ModuleResult on_bar(const Symbol&, Timeframe, const Bar&) override;
+    ModuleResult on_bar(const Symbol&, Timeframe, const BarSeries&) override;
+    size_t history_bars() const override { return mode==RsiMode::Window? warmup_bars() : 1; }
+    void on_bars(const Symbol&, Timeframe, const BarColumns&, std::span<double> out) override;
+    bool serialize(util::BinWriter&) const override;
+    bool deserialize(util::BinReader&) override;
+    RsiMode rsi_mode() const { return mode; }
 }
 
 ; // <- fontos
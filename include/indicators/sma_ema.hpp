@@ -1,21 +1,44 @@
 #pragma once
-#include <deque>
+#include <span>
 #include <algorithm>
+#include <vector>
 #include "core/module.hpp"
 
 namespace ind {
 
-double compute_sma(const std::deque<double>& v, size_t p);
-double compute_ema(const std::deque<double>& v, size_t p);
+double compute_sma(std::span<const double> v, size_t p);
+double compute_ema(std::span<const double> v, size_t p);
+
+// Streaming EMA állapot: baronként O(1) frissítés, az első értékkel seedelve
+// (ugyanaz a képlet és sorrend, mint compute_ema-ban, így bitre azonos eredményt ad).
+struct EmaState {
+    double k{1.0};
+    double value{0.0};
+    bool seeded{false};
+
+    explicit EmaState(size_t p=1): k(2.0/(p+1.0)) {}
+    void reset(){ value=0.0; seeded=false; }
+    double update(double x){
+        if (!seeded){ value=x; seeded=true; }
+        else value = x*k + value*(1.0-k);
+        return value;
+    }
+    void serialize(util::BinWriter& w) const { w.put(value); w.put(seeded); }
+    bool deserialize(util::BinReader& r){ r.get(value); r.get(seeded); return r.ok(); }
+};
 
 class SmaEmaModule final : public IModule {
-    std::deque<double> closes; size_t short_p, long_p;
+    EmaState ema_s, ema_l; size_t n{0}; size_t short_p, long_p;
+    std::vector<double> batch_s, batch_l;   // on_bars munkapufferei: csak nőnek, így a batch hívás nem foglal
 public:
-    SmaEmaModule(size_t sp=20, size_t lp=50): short_p(sp), long_p(lp) {}
+    SmaEmaModule(size_t sp=20, size_t lp=50): ema_s(sp), ema_l(lp), short_p(sp), long_p(lp) {}
     std::string id() const override { return "SMA_EMA"; }
     size_t warmup_bars() const override { return std::max(short_p, long_p) + 5; }
-    void reset() override { closes.clear(); }
+    void reset() override { ema_s.reset(); ema_l.reset(); n=0; }
     ModuleResult on_bar(const Symbol&, Timeframe, const Bar&) override;
+    void on_bars(const Symbol&, Timeframe, const BarColumns&, std::span<double> out) override;
+    bool serialize(util::BinWriter&) const override;
+    bool deserialize(util::BinReader&) override;
 }
 
 ; // <- fontos
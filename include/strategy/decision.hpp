@@ -1,11 +1,24 @@
 #pragma once
 #include <unordered_map>
 #include <string>
+#include <span>
+#include <vector>
+#include <algorithm>
 #include "core/types.hpp"
 
 struct Weights { std::unordered_map<std::string, double> w; };
 struct Scores  { std::unordered_map<std::string, double> s; };
 
+// Sűrű változatok: az index a ModuleRegistry által kiosztott modul-index (lásd strategy/registry.hpp).
+struct DenseWeights {
+    std::vector<double> w;
+    void set(std::size_t idx, double v){ if (w.size()<=idx) w.resize(idx+1, 0.0); w[idx]=v; }
+};
+struct DenseScores {
+    std::vector<double> s;
+    void resize(std::size_t n){ s.resize(n, 50.0); }
+};
+
 struct Decision {
     double combined_score{50.0};
     Signal action{Signal::Neutral};
@@ -22,4 +35,22 @@ inline Decision decide(const Scores& sc, const Weights& w, double up=70.0, doubl
     Signal sig = (cs>up? Signal::Long : (cs<down? Signal::Short : Signal::Neutral));
     return {cs, sig};
 }
+
+// Index szerinti változat: sc[i] és w[i] ugyanahhoz a modulhoz tartozik; a kombináció skalárszorzat,
+// string-kulcs és hash nélkül. Ugyanazt a Decision-t adja, mint a map-es decide().
+inline Decision decide(std::span<const double> sc, std::span<const double> w, double up=70.0, double down=30.0){
+    const std::size_t n = std::min(sc.size(), w.size());
+    double sumw=0.0, acc=0.0;
+    for (std::size_t i=0;i<n;++i){
+        acc  += w[i] * (sc[i]/100.0);
+        sumw += w[i];
+    }
+    double cs = (sumw>0? acc/sumw : 0.5) * 100.0;
+    Signal sig = (cs>up? Signal::Long : (cs<down? Signal::Short : Signal::Neutral));
+    return {cs, sig};
+}
+
+inline Decision decide(const DenseScores& sc, const DenseWeights& w, double up=70.0, double down=30.0){
+    return decide(std::span<const double>(sc.s), std::span<const double>(w.w), up, down);
+}
 // decision.hpp from canvas
@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <thread>
+#include <vector>
+#include "core/types.hpp"
+#include "core/module.hpp"
+#include "core/bar_columns.hpp"
+#include "indicators/kernels.hpp"
+#include "backtest/engine.hpp"
+#include "util/job_control.hpp"
+#include "util/thread_pool.hpp"
+
+// Súly-grid keresés score-mátrixon: a modul-score-ok nem függenek a súlyoktól, ezért modulonként
+// egyszer számoljuk ki a teljes sorozatot (on_bars), utána minden súlyvektor csak egy kombinálás
+// (kernels::combine_scores, = decide() sorozatra) + egy kompakt pozíció-szimuláció.
+
+// m modul × n bar, soronként összefüggő (sor = egy modul score-sorozata)
+struct ScoreMatrix {
+    std::size_t m{0}, n{0};
+    std::vector<double> s;
+
+    void resize(std::size_t rows, std::size_t cols){ m = rows; n = cols; s.assign(rows*cols, 50.0); }
+    std::span<double> row(std::size_t k){ return {s.data() + k*n, n}; }
+    std::span<const double> row(std::size_t k) const { return {s.data() + k*n, n}; }
+    std::span<const double> flat() const { return s; }
+
+    // modulonként egy batch hívás a teljes sorozatra (a modulok állapota továbblép)
+    static ScoreMatrix build(std::span<IModule* const> mods, const Symbol& sym, Timeframe tf, const BarColumns& cols){
+        ScoreMatrix sm; sm.resize(mods.size(), cols.size());
+        for (std::size_t k = 0; k < mods.size(); ++k) mods[k]->on_bars(sym, tf, cols, sm.row(k));
+        return sm;
+    }
+};
+
+// a közös backtest-mag paraméterei és eredménye (backtest/engine.hpp)
+using SimParams = backtest::Params;
+using SimResult = backtest::Result;
+
+// A kombinált score sorozat szimulációja a közös maggal (backtest::run, ScoreThresholds).
+// A bars high/low/open oszlopai a TP/SL brackethez kellenek (p.bracket); a close kötelező.
+// equity != nullptr: baronként a mark-to-market equity (az utolsó elem a záró cash).
+inline SimResult simulate(std::span<const double> combined, const BarColumns& bars, const SimParams& p,
+                          std::vector<double>* equity = nullptr){
+    const std::size_t n = std::min(combined.size(), bars.size());
+    if (equity) equity->resize(n);
+    return backtest::run(bars.subspan(0, n), backtest::ScoreThresholds{combined, p.up, p.down}, p,
+                         equity? std::span<double>(*equity) : std::span<double>{});
+}
+
+// csak záróárakkal (bracket esetén a szinteket is a záróárhoz méri)
+inline SimResult simulate(std::span<const double> combined, std::span<const double> close, const SimParams& p,
+                          std::vector<double>* equity = nullptr){
+    BarColumns bars;
+    bars.close = close;
+    return simulate(combined, bars, p, equity);
+}
+
+struct GridResult {
+    std::vector<double> w;
+    SimResult r;
+};
+
+// m modulra az összes nemnegatív súlyvektor `steps` lépésközzel, ahol Σw = 1 és minden súly >= 1/steps
+inline std::vector<std::vector<double>> weight_simplex(std::size_t m, int steps){
+    std::vector<std::vector<double>> out;
+    if (m == 0 || steps < static_cast<int>(m)) return out;
+    std::vector<int> c(m, 1);
+    auto rec = [&](auto&& self, std::size_t k, int left) -> void {
+        if (k + 1 == m){
+            c[k] = left;
+            std::vector<double> w(m);
+            for (std::size_t j = 0; j < m; ++j) w[j] = c[j] / static_cast<double>(steps);
+            out.push_back(std::move(w));
+            return;
+        }
+        for (int v = 1; v <= left - static_cast<int>(m - k - 1); ++v){ c[k] = v; self(self, k + 1, left - v); }
+    };
+    rec(rec, 0, steps);
+    return out;
+}
+
+// a legjobb top_k final equity szerint csökkenő sorrendben
+inline std::vector<GridResult> grid_top(std::vector<GridResult> res, std::size_t top_k){
+    const std::size_t k = std::min(top_k, res.size());
+    std::partial_sort(res.begin(), res.begin() + static_cast<std::ptrdiff_t>(k), res.end(),
+                      [](const GridResult& a, const GridResult& b){ return a.r.final_eq > b.r.final_eq; });
+    res.resize(k);
+    return res;
+}
+
+// Minden súlyvektort kiértékel a mátrixon (szálanként saját combined pufferrel), és a legjobb top_k-t
+// adja vissza final equity szerint csökkenő sorrendben. threads = 0: hardware_concurrency.
+// ctl: súlyvektoronként lép; megszakításnál a szálak a következő vektor előtt kilépnek.
+inline std::vector<GridResult> grid_search(const ScoreMatrix& sm, const BarColumns& bars,
+                                           const std::vector<std::vector<double>>& weights,
+                                           const SimParams& p, std::size_t top_k = 10, unsigned threads = 0,
+                                           util::JobControl* ctl = nullptr){
+    std::vector<GridResult> res(weights.size());
+    if (ctl) ctl->add_total(weights.size());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(1, weights.size())));
+
+    auto work = [&](std::size_t from, std::size_t to){
+        std::vector<double> combined(sm.n);
+        for (std::size_t j = from; j < to; ++j){
+            if (ctl && ctl->cancelled()) return;
+            ind::kernels::combine_scores(sm.flat(), sm.n, weights[j], combined);
+            res[j] = {weights[j], simulate(combined, bars, p)};
+            if (ctl) ctl->advance();
+        }
+    };
+    if (threads <= 1) work(0, weights.size());
+    else {
+        std::vector<std::thread> pool;
+        const std::size_t per = (weights.size() + threads - 1) / threads;
+        for (unsigned t = 0; t < threads; ++t){
+            const std::size_t a = t*per, b = std::min(weights.size(), a + per);
+            if (a < b) pool.emplace_back(work, a, b);
+        }
+        for (auto& th : pool) th.join();
+    }
+
+    return grid_top(std::move(res), top_k);
+}
+
+// Ugyanez egy közös poolon (pl. a GUI feladatai közt megosztott pool): nem indít saját szálakat,
+// a súlyvektorok blokkjai a pool feladatai, és csak a saját blokkjaira vár (util::TaskGroup).
+inline std::vector<GridResult> grid_search(const ScoreMatrix& sm, const BarColumns& bars,
+                                           const std::vector<std::vector<double>>& weights,
+                                           const SimParams& p, std::size_t top_k, util::ThreadPool& pool,
+                                           util::JobControl* ctl = nullptr){
+    std::vector<GridResult> res(weights.size());
+    if (ctl) ctl->add_total(weights.size());
+    constexpr std::size_t kBlock = 16;
+    util::TaskGroup group(pool);
+    for (std::size_t from = 0; from < weights.size(); from += kBlock){
+        group.submit([&, from]{
+            if (ctl && ctl->cancelled()) return;
+            const std::size_t to = std::min(weights.size(), from + kBlock);
+            std::vector<double> combined(sm.n);
+            for (std::size_t j = from; j < to; ++j){
+                ind::kernels::combine_scores(sm.flat(), sm.n, weights[j], combined);
+                res[j] = {weights[j], simulate(combined, bars, p)};
+            }
+            if (ctl) ctl->advance(to - from);
+        });
+    }
+    group.wait();
+    return grid_top(std::move(res), top_k);
+}
@@ -0,0 +1,255 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "core/types.hpp"
+#include "core/module.hpp"
+#include "core/bar_columns.hpp"
+#include "indicators/kernels.hpp"
+#include "strategy/grid_search.hpp"
+#include "util/job_control.hpp"
+#include "util/thread_pool.hpp"
+
+// Paraméter-optimalizáló: modul-paraméterek (slotonként alternatív konfigurációk) × súlyvektorok
+// teljes sweepje egy work-stealing poolon. A score-sorozatok csak a modul konfigurációjától, a bar
+// timeframe-től és az adatsortól függenek, ezért (konfiguráció-kulcs, TF, dataset hash) szerint
+// cache-eljük őket: a közös
+// al-konfigurációkat egyszer számoljuk, a kombinációk már csak combine + simulate.
+
+// Egy modul-konfiguráció: a kulcs egyértelműen azonosítja a paramétereket (cache-kulcs része)
+struct ModuleSpec {
+    std::string key;                                  // pl. "RSI(14)"
+    std::function<std::unique_ptr<IModule>()> make;
+};
+using SlotChoices = std::vector<ModuleSpec>;          // egy modul-slot alternatívái
+
+// (spec.key, timeframe, dataset hash) -> score-sorozat. Szálbiztos; a sorozatok megosztott, változatlan pufferek.
+// Mérete korlátos: max_bytes fölött a legrégebben használt sorozatok esnek ki (LRU). A kiesett
+// sorozatot a még futó sweep a saját shared_ptr-én át tovább használhatja.
+class SeriesCache {
+public:
+    using Series = std::shared_ptr<const std::vector<double>>;
+
+    explicit SeriesCache(std::size_t max_bytes = std::size_t{512} << 20): max_bytes_(max_bytes) {}
+
+    Series find(const std::string& key, Timeframe tf, std::uint64_t data_hash){
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = map_.find(make_key(key, tf, data_hash));
+        if (it == map_.end()) return nullptr;
+        lru_.splice(lru_.begin(), lru_, it->second.pos);
+        return it->second.s;
+    }
+    void put(const std::string& key, Timeframe tf, std::uint64_t data_hash, Series s){
+        std::lock_guard<std::mutex> lk(m_);
+        auto k = make_key(key, tf, data_hash);
+        if (map_.count(k)) return;
+        bytes_ += bytes_of(s);
+        lru_.push_front(k);
+        map_.emplace(std::move(k), Entry{std::move(s), lru_.begin()});
+        // a legfrissebb akkor is bent marad, ha egymagában nagyobb a korlátnál
+        while (bytes_ > max_bytes_ && lru_.size() > 1){
+            auto old = map_.find(lru_.back());
+            bytes_ -= bytes_of(old->second.s);
+            map_.erase(old);
+            lru_.pop_back();
+            ++evicted_;
+        }
+    }
+    std::size_t size() const { std::lock_guard<std::mutex> lk(m_); return map_.size(); }
+    std::size_t bytes() const { std::lock_guard<std::mutex> lk(m_); return bytes_; }
+    std::size_t evicted() const { std::lock_guard<std::mutex> lk(m_); return evicted_; }
+    void clear(){ std::lock_guard<std::mutex> lk(m_); map_.clear(); lru_.clear(); bytes_ = 0; }
+
+private:
+    struct Entry { Series s; std::list<std::string>::iterator pos; };
+    static std::string make_key(const std::string& key, Timeframe tf, std::uint64_t h){
+        return key + "@" + std::to_string(tf_ms(tf)) + "#" + std::to_string(h);
+    }
+    static std::size_t bytes_of(const Series& s){ return s ? s->size() * sizeof(double) : 0; }
+    mutable std::mutex m_;
+    std::unordered_map<std::string, Entry> map_;
+    std::list<std::string> lru_;        // elöl a legutóbb használt
+    std::size_t max_bytes_;
+    std::size_t bytes_{0}, evicted_{0};
+};
+
+struct OptResult {
+    std::vector<std::string> keys;   // slotonként a választott konfiguráció
+    std::vector<double> w;
+    SimResult r;
+};
+
+struct OptimizerStats {
+    std::size_t evaluations{0};      // konfiguráció × súlyvektor
+    std::size_t series_computed{0};  // most számolt score-sorozatok
+    std::size_t series_cached{0};    // cache-ből kapott score-sorozatok
+    double ms{0.0};
+};
+
+// Slotonként a konfigurációk teljes score-sorozata (series[s][c]); ami nincs a cache-ben, azt a poolon
+// párhuzamosan számolja. A modulok kauzálisak, így a sorozat bármely [a,b) szelete ugyanaz, mintha
+// a modul a sorozat elejétől a b. barig futott volna – walk-forward ablakok is ebből szeletelnek.
+// tf: a cols valódi bar-hossza (pl. backtest::bar_timeframe), ettől függ pl. az MTF bucket; a cache-kulcs része.
+// data_hash: a cols dataset_hash-e, ha a hívó már ismeri (pl. data::LoadedBars::hash()); 0: itt számoljuk.
+using SeriesTable = std::vector<std::vector<SeriesCache::Series>>;
+
+inline SeriesTable compute_series(const std::vector<SlotChoices>& slots, const BarColumns& cols,
+                                  const Symbol& sym, Timeframe tf, SeriesCache& cache, util::ThreadPool& pool,
+                                  OptimizerStats* stats = nullptr, util::JobControl* ctl = nullptr,
+                                  std::uint64_t data_hash = 0){
+    const std::size_t m = slots.size(), n = cols.size();
+    const std::uint64_t dh = data_hash ? data_hash : dataset_hash(cols);
+    SeriesTable series(m);
+    std::vector<std::pair<std::size_t, std::size_t>> todo;
+    std::size_t cached = 0;
+    for (std::size_t s = 0; s < m; ++s){
+        series[s].resize(slots[s].size());
+        for (std::size_t c = 0; c < slots[s].size(); ++c){
+            series[s][c] = cache.find(slots[s][c].key, tf, dh);
+            if (series[s][c]) ++cached;
+            else todo.emplace_back(s, c);
+        }
+    }
+    if (ctl) ctl->add_total(todo.size());
+    util::TaskGroup group(pool);   // csak a saját feladatokra várunk (a poolt más feladat is használhatja)
+    for (auto [s, c] : todo){
+        group.submit([&, s = s, c = c]{
+            if (ctl && ctl->cancelled()) return;
+            auto mod = slots[s][c].make();
+            auto v = std::make_shared<std::vector<double>>(n);
+            mod->on_bars(sym, tf, cols, *v);
+            series[s][c] = v;
+            cache.put(slots[s][c].key, tf, dh, v);
+            if (ctl) ctl->advance();
+        });
+    }
+    group.wait();
+    if (stats){ stats->series_computed += todo.size(); stats->series_cached += cached; }
+    return series;
+}
+
+// Egy kiértékelt kombináció: konfiguráció-index (vegyes alapú számláló a slotokon) + súlyindex
+struct OptEval {
+    std::size_t cfg{0}, wi{0};
+    SimResult r;
+};
+
+// slotonként a választott konfiguráció indexe
+inline std::vector<std::size_t> config_choice(const std::vector<SlotChoices>& slots, std::size_t cfg){
+    std::vector<std::size_t> ch(slots.size());
+    for (std::size_t s = slots.size(); s-- > 0;){ ch[s] = cfg % slots[s].size(); cfg /= slots[s].size(); }
+    return ch;
+}
+
+// Az összes (konfiguráció × súly) kombináció a [begin, end) bar-tartományon; a top_k legjobb
+// final equity szerint csökkenő sorrendben (top_k = 0: mind). pool == nullptr: a hívó szálán fut
+// (pl. ha maga a hívó is egy pool-feladat, mint a walk-forward foldok).
+// ctl: kombinációnként lép; megszakításnál a hátralevő blokkok kimaradnak (az eredmény ekkor részleges).
+inline std::vector<OptEval> evaluate(const SeriesTable& series, const std::vector<SlotChoices>& slots,
+                                     const std::vector<std::vector<double>>& weights,
+                                     const BarColumns& bars, std::size_t begin, std::size_t end,
+                                     const SimParams& sp, util::ThreadPool* pool, std::size_t top_k,
+                                     util::JobControl* ctl = nullptr){
+    const std::size_t m = slots.size();
+    end = std::min(end, bars.size());
+    if (m == 0 || begin >= end || weights.empty()) return {};
+    const std::size_t len = end - begin;
+    std::size_t configs = 1;
+    for (const auto& s : slots) configs *= s.size();
+    const std::size_t total = configs * weights.size();
+
+    std::vector<OptEval> evals(total);
+    if (ctl) ctl->add_total(total);
+    constexpr std::size_t kBlock = 8;
+    auto block = [&](std::size_t from){
+        if (ctl && ctl->cancelled()) return;
+        std::vector<double> combined(len);
+        std::vector<const double*> rows(m);
+        for (std::size_t e = from; e < std::min(total, from + kBlock); ++e){
+            const std::size_t cfg = e / weights.size(), wi = e % weights.size();
+            const auto ch = config_choice(slots, cfg);
+            for (std::size_t s = 0; s < m; ++s) rows[s] = series[s][ch[s]]->data() + begin;
+            ind::kernels::combine_score_rows(rows, len, weights[wi], combined);
+            evals[e] = {cfg, wi, simulate(combined, bars.subspan(begin, len), sp)};
+        }
+        if (ctl) ctl->advance(std::min(total, from + kBlock) - from);
+    };
+    if (pool){
+        util::TaskGroup group(*pool);
+        for (std::size_t from = 0; from < total; from += kBlock) group.submit([&block, from]{ block(from); });
+        group.wait();
+    } else {
+        for (std::size_t from = 0; from < total; from += kBlock) block(from);
+    }
+
+    const std::size_t k = (top_k == 0 ? total : std::min(top_k, total));
+    std::partial_sort(evals.begin(), evals.begin() + static_cast<std::ptrdiff_t>(k), evals.end(),
+                      [](const OptEval& a, const OptEval& b){ return a.r.final_eq > b.r.final_eq; });
+    evals.resize(k);
+    return evals;
+}
+
+inline OptResult to_result(const std::vector<SlotChoices>& slots, const std::vector<std::vector<double>>& weights,
+                           const OptEval& e){
+    OptResult o;
+    for (std::size_t s = 0; const auto c : config_choice(slots, e.cfg)) o.keys.push_back(slots[s++][c].key);
+    o.w = weights[e.wi];
+    o.r = e.r;
+    return o;
+}
+
+// Sweep: slots Descartes-szorzata × weights (a súlyvektor hossza = slotok száma) a teljes sorozaton.
+// A top_k legjobbat adja final equity szerint csökkenő sorrendben (top_k = 0: mindet).
+// data_hash: lásd compute_series.
+inline std::vector<OptResult> optimize(const std::vector<SlotChoices>& slots,
+                                       const std::vector<std::vector<double>>& weights,
+                                       const BarColumns& cols, const Symbol& sym, Timeframe tf,
+                                       const SimParams& sp, SeriesCache& cache, util::ThreadPool& pool,
+                                       std::size_t top_k = 20, OptimizerStats* stats = nullptr,
+                                       util::JobControl* ctl = nullptr, std::uint64_t data_hash = 0){
+    const auto t0 = std::chrono::steady_clock::now();
+    OptimizerStats st;
+    if (slots.empty() || cols.size() == 0 || weights.empty()) return {};
+
+    const auto series = compute_series(slots, cols, sym, tf, cache, pool, &st, ctl, data_hash);
+    if (ctl && ctl->cancelled()) return {};
+    const auto evals = evaluate(series, slots, weights, cols, 0, cols.size(), sp, &pool, top_k, ctl);
+
+    std::size_t configs = 1;
+    for (const auto& s : slots) configs *= s.size();
+    st.evaluations = configs * weights.size();
+
+    std::vector<OptResult> out;
+    out.reserve(evals.size());
+    for (const auto& e : evals) out.push_back(to_result(slots, weights, e));
+    st.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (stats) *stats = st;
+    return out;
+}
+
+// Rangsorolt eredmények CSV-be: rank, slotonként a konfiguráció, súlyok, metrikák
+inline bool write_results_csv(const std::string& path, const std::vector<OptResult>& res,
+                              const std::vector<std::string>& slot_names){
+    std::ofstream f(path);
+    if (!f) return false;
+    f << "rank";
+    for (const auto& s : slot_names) f << ',' << s;
+    for (const auto& s : slot_names) f << ",w_" << s;
+    f << ",final_eq,pf,winrate,trades,maxdd\n";
+    for (std::size_t i = 0; i < res.size(); ++i){
+        const auto& r = res[i];
+        f << (i + 1);
+        for (const auto& k : r.keys) f << ",\"" << k << '"';
+        for (double w : r.w) f << ',' << w;
+        f << ',' << r.r.final_eq << ',' << r.r.pf() << ',' << r.r.winrate() << ',' << r.r.trades << ',' << r.r.maxdd << '\n';
+    }
+    return static_cast<bool>(f);
+}
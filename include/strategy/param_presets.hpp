@@ -0,0 +1,44 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include "indicators/rsi.hpp"
+#include "indicators/sma_ema.hpp"
+#include "indicators/bollinger.hpp"
+#include "indicators/mtfa.hpp"
+#include "strategy/optimizer.hpp"
+
+// Az optimalizáló alapértelmezett paraméter-rácsa (GUI "Optimize params" és backtester --wf közös).
+// Slot-sorrend: SMA_EMA, RSI, BOLL, [MTF_SMA]; a kulcs a SeriesCache-kulcs része.
+// Az RSI a baronként O(1) Wilder forma (RsiMode::Wilder, mint a CLI és a GUI alapértelmezése).
+struct ParamSlots {
+    std::vector<SlotChoices> slots;
+    std::vector<std::string> names;
+};
+
+inline ParamSlots default_param_slots(bool with_mtf){
+    ParamSlots ps;
+    ps.slots.resize(3);
+    const std::pair<std::size_t, std::size_t> ema_p[] = {{10,30}, {20,50}, {50,200}};
+    const std::pair<std::size_t, double> bb_p[] = {{20,2.0}, {20,2.5}, {30,2.0}};
+    for (auto [s, l] : ema_p)
+        ps.slots[0].push_back({fmt::format("SMA_EMA({},{})", s, l), [s=s, l=l]{ return std::make_unique<ind::SmaEmaModule>(s, l); }});
+    for (std::size_t p : {7, 14, 21})
+        ps.slots[1].push_back({fmt::format("RSI({})", p), [p]{ return std::make_unique<ind::RsiModule>(p, ind::RsiMode::Wilder); }});
+    for (auto [p, k] : bb_p)
+        ps.slots[2].push_back({fmt::format("BOLL({},{})", p, k), [p=p, k=k]{ return std::make_unique<ind::BollModule>(p, k); }});
+    ps.names = {"SMA_EMA", "RSI", "BOLL"};
+    if (with_mtf){
+        ps.slots.emplace_back();
+        for (std::size_t f : {6, 12, 24})
+            ps.slots[3].push_back({fmt::format("MTF_SMA({},10,30)", f), [f]{ return std::make_unique<ind::MtfSmaModule>(f, 10, 30); }});
+        ps.names.push_back("MTF_SMA");
+    }
+    return ps;
+}
+
+// a rácshoz illő súlyvektorok (3 slot: 0.2, 4 slot: 1/6 lépés)
+inline std::vector<std::vector<double>> default_weight_grid(std::size_t slots){
+    return weight_simplex(slots, slots == 3 ? 5 : 6);
+}
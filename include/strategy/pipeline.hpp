@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "core/types.hpp"
+#include "core/module.hpp"
+#include "core/bar_columns.hpp"
+#include "strategy/decision.hpp"
+#include "util/binio.hpp"
+
+// Fordítási időben összerakott modul-lánc: a modulok típusa és slot-indexe fix, így a hívások
+// nem virtuálisak (a modulosztályok final-ok), a score-ok pedig std::array-be kerülnek
+// string-kulcsos map helyett. A Decision ugyanaz, mint a dinamikus IModule + decide() úton.
+//
+//   StaticPipeline<ind::SmaEmaModule, ind::RsiModule> p{ind::SmaEmaModule(20,50), ind::RsiModule(14)};
+//   p.set_weights({0.6, 0.4});
+//   Decision d = p.step(sym, tf, bar);
+template<class... Mods>
+class StaticPipeline {
+public:
+    static constexpr std::size_t N = sizeof...(Mods);
+    using ScoreArray = std::array<double, N>;
+
+    StaticPipeline() = default;
+    explicit StaticPipeline(Mods... mods): mods_(std::move(mods)...) {}
+
+    template<std::size_t I> auto& module() { return std::get<I>(mods_); }
+    template<std::size_t I> const auto& module() const { return std::get<I>(mods_); }
+
+    void set_weights(const ScoreArray& w){ weights_ = w; }
+    const ScoreArray& weights() const { return weights_; }
+    const ScoreArray& scores() const { return scores_; }
+
+    // modul azonosítók slot-sorrendben (GUI / riport)
+    std::array<std::string, N> ids() const {
+        return std::apply([](const auto&... m){ return std::array<std::string, N>{ m.id()... }; }, mods_);
+    }
+
+    void reset(){
+        std::apply([](auto&... m){ (m.reset(), ...); }, mods_);
+        scores_.fill(50.0);
+    }
+
+    // egy bar minden modulon; visszaadja a slotonkénti score-okat
+    const ScoreArray& on_bar(const Symbol& s, Timeframe tf, const Bar& b){
+        on_bar_impl(s, tf, b, std::index_sequence_for<Mods...>{});
+        return scores_;
+    }
+
+    // on_bar + súlyozott döntés
+    Decision step(const Symbol& s, Timeframe tf, const Bar& b, double up=70.0, double down=30.0){
+        on_bar(s, tf, b);
+        return decide(std::span<const double>(scores_), std::span<const double>(weights_), up, down);
+    }
+
+    // batch: out[I] a(z) I. modul score-sorozata (mindegyik >= cols.size() hosszú)
+    void on_bars(const Symbol& s, Timeframe tf, const BarColumns& cols, const std::array<std::span<double>, N>& out){
+        on_bars_impl(s, tf, cols, out, std::index_sequence_for<Mods...>{});
+        if (cols.size() > 0)
+            for (std::size_t i = 0; i < N; ++i) scores_[i] = out[i][cols.size()-1];
+    }
+
+    // minden modul állapota slot-sorrendben ({id | u64 hossz | blob}*) + az utolsó score-ok.
+    // deserialize false, ha egy modul nem támogatja / más konfiguráció / sérült – ekkor reset() kell.
+    bool serialize(util::BinWriter& w) const {
+        w.put(scores_);
+        return std::apply([&](const auto&... m){ return (put_module(w, m) && ...); }, mods_);
+    }
+    bool deserialize(util::BinReader& r){
+        r.get(scores_);
+        return std::apply([&](auto&... m){ return (get_module(r, m) && ...); }, mods_) && r.ok();
+    }
+
+private:
+    template<class M>
+    static bool put_module(util::BinWriter& w, const M& m){
+        util::BinWriter blob;
+        if (!m.serialize(blob)) return false;
+        w.put_str(m.id());
+        w.put<std::uint64_t>(blob.size());
+        w.put_bytes(blob.data());
+        return true;
+    }
+    template<class M>
+    static bool get_module(util::BinReader& r, M& m){
+        if (r.get_str() != m.id()) return false;
+        const auto len = r.get<std::uint64_t>();
+        if (len > r.remaining()) return false;
+        auto blob = r.sub(static_cast<std::size_t>(len));
+        return m.deserialize(blob) && blob.ok() && blob.at_end();
+    }
+
+    template<std::size_t... I>
+    void on_bar_impl(const Symbol& s, Timeframe tf, const Bar& b, std::index_sequence<I...>){
+        ((scores_[I] = std::get<I>(mods_).on_bar(s, tf, b).score), ...);
+    }
+    template<std::size_t... I>
+    void on_bars_impl(const Symbol& s, Timeframe tf, const BarColumns& cols,
+                      const std::array<std::span<double>, N>& out, std::index_sequence<I...>){
+        (std::get<I>(mods_).on_bars(s, tf, cols, out[I]), ...);
+    }
+
+    std::tuple<Mods...> mods_;
+    ScoreArray weights_{};
+    ScoreArray scores_{ [](){ ScoreArray a{}; a.fill(50.0); return a; }() };
+};
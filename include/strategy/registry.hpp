@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+
+// Modul-azonosítók internálása kis egész indexekre. Az internálás egyszer, a modul
+// hozzáadásakor történik; a bar-onkénti úton utána csak az indexet használjuk
+// (DenseScores / DenseWeights), string-allokáció és hash nélkül.
+class ModuleRegistry {
+public:
+    // meglévő id esetén a korábbi indexet adja vissza
+    std::size_t intern(const std::string& id){
+        auto it = index_.find(id);
+        if (it!=index_.end()) return it->second;
+        const std::size_t idx = names_.size();
+        names_.push_back(id);
+        index_.emplace(id, idx);
+        return idx;
+    }
+    std::optional<std::size_t> find(const std::string& id) const {
+        auto it = index_.find(id);
+        if (it==index_.end()) return std::nullopt;
+        return it->second;
+    }
+    const std::string& name(std::size_t idx) const { return names_[idx]; }
+    std::size_t size() const { return names_.size(); }
+
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, std::size_t> index_;
+};
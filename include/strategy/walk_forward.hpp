@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <span>
+#include <vector>
+#include "core/types.hpp"
+#include "core/bar_columns.hpp"
+#include "strategy/grid_search.hpp"
+#include "strategy/optimizer.hpp"
+#include "util/thread_pool.hpp"
+
+// Walk-forward validáció: gördülő train/test ablakok; minden train ablakon a teljes
+// (konfiguráció × súly) sweep, a legjobb in-sample kombináció a rákövetkező test ablakon fut.
+// A score-sorozatokat egyszer számoljuk a teljes adatsorra (kauzálisak, így a test ablak elején a
+// modulok már be vannak melegítve); a foldok párhuzamosan, pool-feladatonként egy fold.
+
+struct WalkForwardConfig {
+    std::size_t train{0};     // train ablak, bar
+    std::size_t test{0};      // test ablak, bar (a lépésköz is ennyi)
+    bool anchored{false};     // true: a train ablak mindig a sorozat elejéről indul (bővülő)
+};
+
+struct WalkForwardFold {
+    std::size_t train_begin{0}, train_end{0}, test_begin{0}, test_end{0};
+    OptResult best;                   // in-sample legjobb (best.r: train eredmény)
+    double oos_start{0.0};            // a test ablak kezdőtőkéje (az előző fold záró equity-je)
+    SimResult oos;                    // test ablak
+    std::vector<double> oos_equity;   // baronként
+};
+
+struct WalkForwardResult {
+    std::vector<WalkForwardFold> folds;
+    std::vector<double> equity;       // összefűzött OOS equity
+    double final_eq{0.0};
+    double maxdd{0.0};                // az összefűzött görbén
+    OptimizerStats stats;
+};
+
+// fold határok: test ablakok egymás után a sorozat végéig (az utolsó rövidebb lehet)
+inline std::vector<WalkForwardFold> walk_forward_folds(std::size_t n, const WalkForwardConfig& cfg){
+    std::vector<WalkForwardFold> out;
+    if (cfg.train == 0 || cfg.test == 0) return out;
+    for (std::size_t a = 0; a + cfg.train < n; a += cfg.test){
+        WalkForwardFold f;
+        f.train_begin = cfg.anchored ? 0 : a;
+        f.train_end = a + cfg.train;
+        f.test_begin = f.train_end;
+        f.test_end = std::min(n, f.test_begin + cfg.test);
+        out.push_back(std::move(f));
+    }
+    return out;
+}
+
+// A train sweepek párhuzamosan futnak; a test ablakok ezután sorban, mindegyik az előző fold záró
+// equity-jéről indul (a pozíció minden fold végén zárul), így a görbe bármely díj-/méretmodellnél pontos.
+// data_hash: lásd compute_series.
+inline WalkForwardResult walk_forward(const std::vector<SlotChoices>& slots,
+                                      const std::vector<std::vector<double>>& weights,
+                                      const BarColumns& cols, const Symbol& sym, Timeframe tf,
+                                      const SimParams& sp, const WalkForwardConfig& cfg,
+                                      SeriesCache& cache, util::ThreadPool& pool, util::JobControl* ctl = nullptr,
+                                      std::uint64_t data_hash = 0){
+    const auto t0 = std::chrono::steady_clock::now();
+    WalkForwardResult res;
+    res.folds = walk_forward_folds(cols.size(), cfg);
+    if (slots.empty() || weights.empty() || res.folds.empty()) return res;
+
+    const auto series = compute_series(slots, cols, sym, tf, cache, pool, &res.stats, ctl, data_hash);
+    if (ctl && ctl->cancelled()) return res;
+
+    util::TaskGroup group(pool);
+    for (auto& f : res.folds){
+        group.submit([&, fp = &f]{
+            // egy fold egy feladat: a sweep a feladat szálán fut (beágyazott wait() nélkül)
+            const auto top = evaluate(series, slots, weights, cols, fp->train_begin, fp->train_end, sp, nullptr, 1, ctl);
+            if (!top.empty()) fp->best = to_result(slots, weights, top.front());
+        });
+    }
+    group.wait();
+    if (ctl && ctl->cancelled()) return res;
+
+    std::size_t configs = 1;
+    for (const auto& s : slots) configs *= s.size();
+    res.stats.evaluations = res.folds.size() * configs * weights.size();
+
+    std::vector<double> combined;
+    std::vector<const double*> rows(slots.size());
+    SimParams p = sp;
+    double peak = sp.cash;
+    for (auto& f : res.folds){
+        f.oos_start = p.cash;
+        if (f.best.keys.empty()) continue;
+        std::size_t s = 0;
+        for (const auto& key : f.best.keys){
+            const auto it = std::find_if(slots[s].begin(), slots[s].end(), [&](const ModuleSpec& m){ return m.key == key; });
+            rows[s] = series[s][static_cast<std::size_t>(it - slots[s].begin())]->data() + f.test_begin;
+            ++s;
+        }
+        const std::size_t len = f.test_end - f.test_begin;
+        combined.resize(len);
+        ind::kernels::combine_score_rows(rows, len, f.best.w, combined);
+        f.oos = simulate(combined, cols.subspan(f.test_begin, len), p, &f.oos_equity);
+        for (double eq : f.oos_equity){
+            res.equity.push_back(eq);
+            peak = std::max(peak, eq);
+            res.maxdd = std::max(res.maxdd, (peak - eq)/std::max(1.0, peak));
+        }
+        p.cash = f.oos.final_eq;
+    }
+    res.final_eq = p.cash;
+    res.stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
@@ -6,6 +6,7 @@
 #include "core/types.hpp"
 #include "core/module.hpp"
 #include "strategy/decision.hpp"
+#include "strategy/registry.hpp"
 
 namespace ui {
 
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <span>
+#include <type_traits>
+
+namespace util {
+
+// Egyszerű bináris író/olvasó állapot-snapshotokhoz (natív byte-sorrend, little-endian gépekre).
+// Csak triviálisan másolható skalárokat és hosszprefixes stringeket/tömböket kezel;
+// a formátum-verziózás a hívó dolga.
+class BinWriter {
+public:
+    template<class T>
+    void put(const T& v){
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* p = reinterpret_cast<const char*>(&v);
+        buf_.insert(buf_.end(), p, p+sizeof(T));
+    }
+    void put_str(const std::string& s){
+        put<std::uint32_t>(static_cast<std::uint32_t>(s.size()));
+        buf_.insert(buf_.end(), s.begin(), s.end());
+    }
+    template<class T>
+    void put_span(std::span<const T> v){
+        static_assert(std::is_trivially_copyable_v<T>);
+        put<std::uint64_t>(v.size());
+        const auto* p = reinterpret_cast<const char*>(v.data());
+        buf_.insert(buf_.end(), p, p+v.size_bytes());
+    }
+    void put_bytes(std::span<const char> v){ buf_.insert(buf_.end(), v.begin(), v.end()); }
+
+    const std::vector<char>& data() const { return buf_; }
+    std::size_t size() const { return buf_.size(); }
+    void clear(){ buf_.clear(); }
+
+private:
+    std::vector<char> buf_;
+};
+
+// Olvasó: hibánál (túlolvasás) ok() hamis lesz, és minden további get nullát/üreset ad –
+// így a hívónak elég a végén egyszer ellenőriznie.
+class BinReader {
+public:
+    explicit BinReader(std::span<const char> d): d_(d) {}
+
+    template<class T>
+    T get(){
+        static_assert(std::is_trivially_copyable_v<T>);
+        T v{};
+        if (!need(sizeof(T))) return v;
+        std::memcpy(&v, d_.data()+pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return v;
+    }
+    template<class T>
+    bool get(T& v){ v = get<T>(); return ok_; }
+
+    std::string get_str(){
+        const auto n = get<std::uint32_t>();
+        if (!need(n)) return {};
+        std::string s(d_.data()+pos_, n);
+        pos_ += n;
+        return s;
+    }
+    template<class T>
+    std::vector<T> get_vec(){
+        const auto n = get<std::uint64_t>();
+        if (n > remaining()/sizeof(T) || !need(n*sizeof(T))) { ok_ = false; return {}; }
+        std::vector<T> v(n);
+        std::memcpy(v.data(), d_.data()+pos_, n*sizeof(T));
+        pos_ += n*sizeof(T);
+        return v;
+    }
+    // n bájtos al-olvasó (pl. egy modul blobja), a fő olvasó átlépi
+    BinReader sub(std::size_t n){
+        if (!need(n)) return BinReader({});
+        BinReader r(d_.subspan(pos_, n));
+        pos_ += n;
+        return r;
+    }
+
+    bool ok() const { return ok_; }
+    bool at_end() const { return pos_ == d_.size(); }
+    std::size_t remaining() const { return d_.size() - pos_; }
+    void fail(){ ok_ = false; }
+
+private:
+    bool need(std::size_t n){
+        if (!ok_ || n > d_.size()-pos_){ ok_ = false; return false; }
+        return true;
+    }
+    std::span<const char> d_;
+    std::size_t pos_{0};
+    bool ok_{true};
+};
+
+} // namespace util
@@ -1 +1,34 @@
-// concurrent_queue.hpp placeholder
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace util {
+
+// Több termelő / több fogyasztó FIFO, mutex-szel. Nem blokkoló try_pop: a render ciklus
+// frame-enként kiüríti (WS barok, háttérfeladatok eredményei).
+template<class T>
+class ConcurrentQueue {
+public:
+    void push(T v){
+        std::lock_guard<std::mutex> lk(m_);
+        q_.push_back(std::move(v));
+    }
+    bool try_pop(T& out){
+        std::lock_guard<std::mutex> lk(m_);
+        if (q_.empty()) return false;
+        out = std::move(q_.front());
+        q_.pop_front();
+        return true;
+    }
+    std::size_t size() const { std::lock_guard<std::mutex> lk(m_); return q_.size(); }
+    bool empty() const { return size() == 0; }
+    void clear(){ std::lock_guard<std::mutex> lk(m_); q_.clear(); }
+
+private:
+    mutable std::mutex m_;
+    std::deque<T> q_;
+};
+
+} // namespace util
@@ -0,0 +1,41 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+namespace util {
+
+enum class JobStatus { Queued, Running, Done, Cancelled, Failed };
+
+// Feladat és felület közös állapota: atomikus előrehaladás-számlálók, kooperatív megszakítás.
+// A hosszú ciklusok (grid, optimizer, walk-forward) opcionálisan kapják; nullptr = nincs jelentés.
+class JobControl {
+public:
+    void set_total(std::size_t n){ total_.store(n, std::memory_order_relaxed); done_.store(0, std::memory_order_relaxed); }
+    void add_total(std::size_t n){ total_.fetch_add(n, std::memory_order_relaxed); }
+    void advance(std::size_t k = 1){ done_.fetch_add(k, std::memory_order_relaxed); }
+    std::size_t done() const { return done_.load(std::memory_order_relaxed); }
+    std::size_t total() const { return total_.load(std::memory_order_relaxed); }
+    float fraction() const {
+        const std::size_t t = total();
+        return t? static_cast<float>(static_cast<double>(std::min(done(), t)) / static_cast<double>(t)) : 0.0f;
+    }
+
+    // rövid állapotszöveg; csak statikus élettartamú literált adjunk át
+    void set_stage(const char* s){ stage_.store(s, std::memory_order_relaxed); }
+    const char* stage() const { return stage_.load(std::memory_order_relaxed); }
+
+    void cancel(){ cancel_.store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return cancel_.load(std::memory_order_relaxed); }
+
+    JobStatus status() const { return status_.load(std::memory_order_acquire); }
+    void set_status(JobStatus s){ status_.store(s, std::memory_order_release); }
+
+private:
+    std::atomic<std::size_t> done_{0}, total_{0};
+    std::atomic<const char*> stage_{""};
+    std::atomic<bool> cancel_{false};
+    std::atomic<JobStatus> status_{JobStatus::Queued};
+};
+
+} // namespace util
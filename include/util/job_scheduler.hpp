@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "util/concurrent_queue.hpp"
+#include "util/job_control.hpp"
+
+namespace util {
+
+// Háttérfeladatok a GUI-hoz: a feladat egy worker szálon fut, a JobControl-on jelenti az
+// előrehaladást és figyeli a megszakítást, végül egy Apply-t ad vissza, ami az eredményt a
+// render szálon (poll()) írja be a felület állapotába. Így a render szál sosem vár feladatra,
+// és a feladat nem ér a felület állapotához.
+//
+// Szálkezelés: submit/poll/cancel/jobs csak a render szálról; a workerek csak a saját
+// JobControl-jukat és az eredménysort érik el.
+class JobScheduler {
+public:
+    using Apply = std::function<void()>;                 // render szálon
+    using Work  = std::function<Apply(JobControl&)>;     // worker szálon; nullptr Apply: nincs mit átadni
+
+    struct Entry {
+        std::uint64_t id{0};
+        std::string label;
+        std::shared_ptr<JobControl> ctl;
+        std::string error;
+        double ms{0.0};
+    };
+
+    explicit JobScheduler(unsigned workers = 1){
+        workers = std::max(1u, workers);
+        th_.reserve(workers);
+        for (unsigned i = 0; i < workers; ++i) th_.emplace_back([this]{ run(); });
+    }
+    // a még futó feladatokat megszakítja és megvárja; a várakozók el sem indulnak
+    ~JobScheduler(){
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+            for (auto& p : pending_) p.ctl->cancel();
+        }
+        for (auto& e : jobs_) e.ctl->cancel();
+        cv_.notify_all();
+        for (auto& t : th_) t.join();
+    }
+    JobScheduler(const JobScheduler&) = delete;
+    JobScheduler& operator=(const JobScheduler&) = delete;
+
+    std::uint64_t submit(std::string label, Work w){
+        const std::uint64_t id = ++next_id_;
+        auto ctl = std::make_shared<JobControl>();
+        jobs_.push_back({id, std::move(label), ctl, {}, 0.0});
+        { std::lock_guard<std::mutex> lk(m_); pending_.push_back({id, ctl, std::move(w)}); }
+        cv_.notify_one();
+        return id;
+    }
+
+    // kész feladatok eredményeinek átadása (render szál, frame-enként); az átadott eredmények száma
+    std::size_t poll(){
+        std::size_t n = 0;
+        Completion c;
+        while (done_q_.try_pop(c)){
+            for (auto& e : jobs_){
+                if (e.id != c.id) continue;
+                e.error = std::move(c.error);
+                e.ms = c.ms;
+                break;
+            }
+            if (c.apply){ c.apply(); ++n; }
+        }
+        return n;
+    }
+
+    void cancel(std::uint64_t id){
+        for (auto& e : jobs_) if (e.id == id) e.ctl->cancel();
+    }
+    void cancel_all(){ for (auto& e : jobs_) e.ctl->cancel(); }
+
+    // a befejezett (kész / megszakított / hibás) sorok törlése a listából
+    void clear_finished(){
+        std::erase_if(jobs_, [](const Entry& e){
+            const auto s = e.ctl->status();
+            return s == JobStatus::Done || s == JobStatus::Cancelled || s == JobStatus::Failed;
+        });
+    }
+
+    const std::vector<Entry>& jobs() const { return jobs_; }
+    bool busy() const {
+        for (const auto& e : jobs_){
+            const auto s = e.ctl->status();
+            if (s == JobStatus::Queued || s == JobStatus::Running) return true;
+        }
+        return false;
+    }
+
+private:
+    struct Pending { std::uint64_t id; std::shared_ptr<JobControl> ctl; Work work; };
+    struct Completion { std::uint64_t id{0}; Apply apply; std::string error; double ms{0.0}; };
+
+    void run(){
+        while (true){
+            Pending p;
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                cv_.wait(lk, [&]{ return stop_ || !pending_.empty(); });
+                if (pending_.empty()) return;
+                p = std::move(pending_.front());
+                pending_.pop_front();
+            }
+            Completion c{p.id, nullptr, {}, 0.0};
+            if (p.ctl->cancelled()){
+                p.ctl->set_status(JobStatus::Cancelled);
+                done_q_.push(std::move(c));
+                continue;
+            }
+            p.ctl->set_status(JobStatus::Running);
+            const auto t0 = std::chrono::steady_clock::now();
+            JobStatus st = JobStatus::Done;
+            try {
+                c.apply = p.work(*p.ctl);
+                if (p.ctl->cancelled()){ c.apply = nullptr; st = JobStatus::Cancelled; }
+            } catch (const std::exception& e){
+                c.error = e.what(); st = JobStatus::Failed;
+            } catch (...){
+                c.error = "unknown error"; st = JobStatus::Failed;
+            }
+            c.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            done_q_.push(std::move(c));
+            p.ctl->set_status(st); // a státusz a sorba tétel után: Done esetén az eredmény már átvehető
+        }
+    }
+
+    std::vector<std::thread> th_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::deque<Pending> pending_;          // m_ alatt
+    bool stop_{false};                     // m_ alatt
+    ConcurrentQueue<Completion> done_q_;
+    std::vector<Entry> jobs_;              // csak render szál
+    std::uint64_t next_id_{0};             // csak render szál
+};
+
+} // namespace util
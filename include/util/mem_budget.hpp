@@ -0,0 +1,47 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace util {
+
+// Bájt-keret párhuzamos feladatokhoz: acquire() blokkol, amíg a kért mennyiség belefér.
+// A keretnél nagyobb kérés a teljes keretet kapja (egyedül fut), így nem akad el.
+class MemBudget {
+public:
+    explicit MemBudget(std::size_t bytes): cap_(std::max<std::size_t>(1, bytes)), free_(cap_) {}
+
+    std::size_t acquire(std::size_t bytes){
+        bytes = std::min(std::max<std::size_t>(1, bytes), cap_);
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [&]{ return free_ >= bytes; });
+        free_ -= bytes;
+        return bytes;
+    }
+    void release(std::size_t bytes){
+        { std::lock_guard<std::mutex> lk(m_); free_ += bytes; }
+        cv_.notify_all();
+    }
+    std::size_t capacity() const { return cap_; }
+
+    // RAII: a konstruktor foglal, a destruktor elenged
+    class Lease {
+    public:
+        Lease(MemBudget& b, std::size_t bytes): b_(b), n_(b.acquire(bytes)) {}
+        ~Lease(){ b_.release(n_); }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+    private:
+        MemBudget& b_;
+        std::size_t n_;
+    };
+
+private:
+    const std::size_t cap_;
+    std::size_t free_;
+    std::mutex m_;
+    std::condition_variable cv_;
+};
+
+} // namespace util
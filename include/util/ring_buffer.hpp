@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <algorithm>
+
+namespace util {
+
+// Fix kapacitású gyűrűpuffer összefüggő tárolással.
+// Minden elemet kétszer tárol (i és i+capacity pozíción), így a teljes tartalom – és bármely
+// utolsó szakasza – egyetlen összefüggő span-ként olvasható, másolás és darabolás nélkül.
+// Allokáció csak a kapacitás beállításakor történik; push_back teli puffernél a legrégebbit írja felül.
+template<class T>
+class RingBuffer {
+public:
+    RingBuffer() = default;
+    explicit RingBuffer(std::size_t cap){ reset(cap); }
+
+    // új kapacitás, a tartalom törlődik
+    void reset(std::size_t cap){ buf_.assign(2*cap, T{}); cap_=cap; head_=0; size_=0; }
+
+    // új kapacitás, a legfrissebb min(size, cap) elem megmarad
+    void set_capacity(std::size_t cap){
+        if (cap==cap_) return;
+        const auto v = view();
+        const std::size_t keep = std::min(v.size(), cap);
+        std::vector<T> tail(v.end()-static_cast<std::ptrdiff_t>(keep), v.end());
+        reset(cap);
+        for (const auto& x : tail) push_back(x);
+    }
+
+    void clear(){ head_=0; size_=0; }
+
+    std::size_t capacity() const { return cap_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_==0; }
+    bool full() const { return size_==cap_; }
+
+    void push_back(const T& v){
+        if (cap_==0) return;
+        buf_[head_] = v; buf_[head_+cap_] = v;
+        head_ = (head_+1==cap_? 0 : head_+1);
+        if (size_<cap_) ++size_;
+    }
+
+    // 0 = legrégebbi, size()-1 = legfrissebb
+    const T& operator[](std::size_t i) const { return buf_[head_+cap_-size_+i]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_-1]; }
+
+    // a teljes tartalom időrendben (legrégebbi -> legfrissebb)
+    std::span<const T> view() const {
+        if (size_==0) return {};
+        return std::span<const T>(buf_.data()+head_+cap_-size_, size_);
+    }
+    // az utolsó n elem (n <= size())
+    std::span<const T> last(std::size_t n) const { return view().last(std::min(n, size_)); }
+
+private:
+    std::vector<T> buf_;
+    std::size_t cap_{0};
+    std::size_t head_{0};   // következő írási pozíció [0, cap_)
+    std::size_t size_{0};
+};
+
+} // namespace util
@@ -0,0 +1,164 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace util {
+
+// Work-stealing szálkészlet: minden workernek saját deque-ja van. A saját sor végéről dolgozik
+// (LIFO, cache-barát), ha kiürült, a többiek elejéről lop. Kívülről érkező feladat round-robin
+// kerül a sorokba, workerből beküldött feladat a worker saját sorába.
+// wait(): blokkol, amíg minden beküldött feladat le nem futott (a hívó közben maga is dolgozik).
+// Több, egymástól független hívó egy közös poolon TaskGroup-ot használjon (lásd lent).
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned n = 0){
+        if (n == 0) n = std::max(1u, std::thread::hardware_concurrency());
+        n_ = n;
+        for (unsigned i = 0; i < n; ++i) qs_.push_back(std::make_unique<Queue>());
+        th_.reserve(n);
+        for (unsigned i = 0; i < n; ++i) th_.emplace_back([this, i]{ run(i); });
+    }
+    ~ThreadPool(){
+        { std::lock_guard<std::mutex> lk(m_); stop_ = true; }
+        cv_.notify_all();
+        for (auto& t : th_) t.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return n_; }
+
+    void submit(std::function<void()> f){
+        const unsigned q = (tl_pool() == this ? tl_index() : rr_.fetch_add(1, std::memory_order_relaxed) % size());
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        { std::lock_guard<std::mutex> lk(m_); ++queued_; } // előbb számláló, így pop nem előzheti meg
+        { std::lock_guard<std::mutex> lk(qs_[q]->m); qs_[q]->q.push_back(std::move(f)); }
+        cv_.notify_one();
+    }
+
+    void wait(){
+        std::function<void()> f;
+        while (pending_.load(std::memory_order_acquire) > 0){
+            if (try_pop(rr_.load(std::memory_order_relaxed) % size(), f)) execute(f);
+            else {
+                std::unique_lock<std::mutex> lk(m_);
+                done_cv_.wait(lk, [&]{ return pending_.load(std::memory_order_acquire) == 0 || queued_ > 0; });
+            }
+        }
+    }
+
+    // a hívó szál ennek a poolnak a workere-e
+    bool in_worker() const { return tl_pool() == this; }
+    // egy várakozó feladat futtatása a hívó szálán (worker szálról); false, ha nincs mit futtatni
+    bool run_one(){
+        std::function<void()> f;
+        if (!try_pop(in_worker()? tl_index() : rr_.load(std::memory_order_relaxed) % size(), f)) return false;
+        execute(f);
+        return true;
+    }
+
+private:
+    struct Queue { std::mutex m; std::deque<std::function<void()>> q; };
+
+    static const ThreadPool*& tl_pool(){ thread_local const ThreadPool* p = nullptr; return p; }
+    static unsigned& tl_index(){ thread_local unsigned i = 0; return i; }
+
+    // saját sor vége, aztán lopás a többiek elejéről
+    bool try_pop(unsigned self, std::function<void()>& f){
+        {
+            auto& q = *qs_[self];
+            std::lock_guard<std::mutex> lk(q.m);
+            if (!q.q.empty()){ f = std::move(q.q.back()); q.q.pop_back(); return take(); }
+        }
+        for (unsigned k = 1; k < size(); ++k){
+            auto& q = *qs_[(self + k) % size()];
+            std::lock_guard<std::mutex> lk(q.m);
+            if (!q.q.empty()){ f = std::move(q.q.front()); q.q.pop_front(); return take(); }
+        }
+        return false;
+    }
+    bool take(){ std::lock_guard<std::mutex> lk(m_); --queued_; return true; }
+
+    void execute(std::function<void()>& f){
+        f();
+        f = nullptr;
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1){
+            std::lock_guard<std::mutex> lk(m_);
+            done_cv_.notify_all();
+        }
+    }
+
+    void run(unsigned i){
+        tl_pool() = this; tl_index() = i;
+        std::function<void()> f;
+        while (true){
+            if (try_pop(i, f)){ execute(f); continue; }
+            std::unique_lock<std::mutex> lk(m_);
+            cv_.wait(lk, [&]{ return stop_ || queued_ > 0; });
+            if (stop_ && queued_ == 0) return;
+        }
+    }
+
+    unsigned n_{0};
+    std::vector<std::unique_ptr<Queue>> qs_;
+    std::vector<std::thread> th_;
+    std::mutex m_;
+    std::condition_variable cv_, done_cv_;
+    std::size_t queued_{0};               // m_ alatt: sorokban várakozó feladatok
+    std::atomic<std::size_t> pending_{0}; // beküldött, még be nem fejezett feladatok
+    std::atomic<unsigned> rr_{0};
+    bool stop_{false};
+};
+
+// Feladatcsoport egy közös poolon: a wait() csak a csoport saját feladataira vár, nem a pool összes
+// feladatára. Így a poolt megosztó hívók (pl. két egyidejű GUI feladat) nem várnak egymásra,
+// és egy megszakított hívó – amint a saját, már üresjáratú feladatai lefutottak – a másiktól
+// függetlenül visszatér. Külső szálról a wait() alszik (nem fut idegen feladatot); pool workerről
+// (beágyazott csoport) közben a pool feladatait futtatja, hogy ne akadjon el.
+// A csoport a wait()-ig (legkésőbb a destruktorig) élnie kell.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool): pool_(pool) {}
+    ~TaskGroup(){ wait(); }
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void submit(std::function<void()> f){
+        { std::lock_guard<std::mutex> lk(m_); ++pending_; }
+        pool_.submit([this, f = std::move(f)]{
+            f();
+            // a számláló a mutex alatt csökken: a wait() csak ennek elengedése után térhet vissza
+            std::lock_guard<std::mutex> lk(m_);
+            if (--pending_ == 0) cv_.notify_all();
+        });
+    }
+
+    void wait(){
+        if (pool_.in_worker()){
+            while (true){
+                { std::lock_guard<std::mutex> lk(m_); if (pending_ == 0) return; }
+                if (pool_.run_one()) continue;
+                std::unique_lock<std::mutex> lk(m_);
+                if (cv_.wait_for(lk, std::chrono::milliseconds(1), [&]{ return pending_ == 0; })) return;
+            }
+        }
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [&]{ return pending_ == 0; });
+    }
+
+private:
+    ThreadPool& pool_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::size_t pending_{0};   // m_ alatt: beküldött, még be nem fejezett feladatok
+};
+
+} // namespace util
@@ -0,0 +1,99 @@
+#include "backtest/checkpoint.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace backtest {
+
+namespace {
+
+constexpr char kMagic[4] = {'B','T','C','K'};
+constexpr std::uint32_t kVersion = 1;
+
+void fail(std::string* err, std::string msg){ if (err) *err = std::move(msg); }
+
+} // namespace
+
+bool Checkpoint::extends(const BarColumns& cols) const {
+    if (cols.size() < bars) return false;
+    if (bars == 0) return true;
+    if (cols.open_time_ms.size() == cols.size() && cols.open_time_ms[bars - 1] != last_open_ms) return false;
+    return dataset_hash(cols.subspan(0, bars)) == data_hash;
+}
+
+void stamp(Checkpoint& ck, const BarColumns& processed){
+    ck.bars = processed.size();
+    ck.last_open_ms = (ck.bars > 0 && processed.open_time_ms.size() == ck.bars)? processed.open_time_ms[ck.bars - 1] : 0;
+    ck.data_hash = dataset_hash(processed);
+}
+
+bool save_checkpoint(const std::string& path, const Checkpoint& ck, std::string* err){
+    util::BinWriter w;
+    w.put(kMagic);
+    w.put(kVersion);
+    w.put_str(ck.config);
+    w.put<std::uint64_t>(ck.bars);
+    w.put(ck.last_open_ms);
+    w.put(ck.data_hash);
+    w.put_span<char>(ck.modules);
+    ck.state.serialize(w);
+    w.put<std::uint64_t>(ck.trades.size());
+    for (const auto& t : ck.trades){
+        w.put<std::uint64_t>(t.entry_i); w.put<std::uint64_t>(t.exit_i);
+        w.put(t.qty); w.put(t.entry_px); w.put(t.exit_px); w.put(t.pnl); w.put(t.ret);
+        w.put<std::uint8_t>(static_cast<std::uint8_t>(t.reason));
+    }
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f){ fail(err, "nem nyithato irasra: " + tmp); return false; }
+        f.write(w.data().data(), static_cast<std::streamsize>(w.size()));
+        if (!f){ fail(err, "irasi hiba: " + tmp); return false; }
+    }
+    // a filesystem::rename felülírja a célt (Windows-on is, MoveFileEx): a régi checkpoint a
+    // csere pillanatáig ép marad, előtte nem törlünk
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec){ fail(err, "rename sikertelen: " + tmp + ": " + ec.message()); return false; }
+    return true;
+}
+
+bool load_checkpoint(const std::string& path, Checkpoint& ck, std::string* err){
+    std::ifstream f(path, std::ios::binary);
+    if (!f){ fail(err, "nem talalhato: " + path); return false; }
+    const std::vector<char> buf((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    util::BinReader r(buf);
+    char magic[4]{};
+    for (char& c : magic) c = r.get<char>();
+    if (!std::equal(magic, magic + 4, kMagic) || r.get<std::uint32_t>() != kVersion){
+        fail(err, "ismeretlen formatum: " + path);
+        return false;
+    }
+    Checkpoint c;
+    c.config = r.get_str();
+    c.bars = r.get<std::uint64_t>();
+    r.get(c.last_open_ms);
+    r.get(c.data_hash);
+    c.modules = r.get_vec<char>();
+    c.state.deserialize(r);
+    const auto nt = r.get<std::uint64_t>();
+    if (nt > r.remaining()) r.fail();
+    for (std::uint64_t k = 0; k < nt && r.ok(); ++k){
+        Trade t;
+        t.entry_i = r.get<std::uint64_t>(); t.exit_i = r.get<std::uint64_t>();
+        r.get(t.qty); r.get(t.entry_px); r.get(t.exit_px); r.get(t.pnl); r.get(t.ret);
+        t.reason = static_cast<ExitReason>(r.get<std::uint8_t>());
+        c.trades.push_back(t);
+    }
+    if (!r.ok() || !r.at_end() || c.state.bars != c.bars){
+        fail(err, "serult fajl: " + path);
+        return false;
+    }
+    ck = std::move(c);
+    return true;
+}
+
+} // namespace backtest
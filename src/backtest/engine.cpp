@@ -0,0 +1,119 @@
+#include "backtest/engine.hpp"
+#include <charconv>
+
+namespace backtest {
+
+void Engine::prepare(std::size_t n){
+    if (equity_.size() < n) equity_.resize(n);
+    if (trades_.capacity() < max_trades(n)) trades_.reserve(max_trades(n));
+}
+
+const Result& Engine::run(const BarColumns& bars, std::span<const double> combined, const Params& p){
+    const std::size_t n = std::min(bars.size(), combined.size());
+    prepare(n);
+    n_ = n;
+    trades_.clear();
+    res_ = backtest::run(bars.subspan(0, n), ScoreThresholds{combined, p.up, p.down}, p,
+                         std::span<double>(equity_.data(), n), &trades_);
+    return res_;
+}
+
+const Result& Engine::resume(const BarColumns& bars, std::span<const double> combined, const Params& p, State& st){
+    const std::size_t n = std::min(bars.size(), combined.size());
+    prepare(n);
+    n_ = n;
+    trades_.clear();
+    const std::span<double> eq(equity_.data(), n);
+    advance(bars.subspan(0, n), ScoreThresholds{combined, p.up, p.down}, p, st, eq, &trades_);
+    res_ = finish(st, p, &trades_);
+    if (n > 0) eq[n-1] = res_.final_eq;
+    return res_;
+}
+
+void State::serialize(util::BinWriter& w) const {
+    w.put(cash); w.put(qty); w.put(entry); w.put(entry_fee); w.put(entry_eq); w.put(sl); w.put(tp);
+    w.put(last_close);
+    w.put<std::uint64_t>(entry_i); w.put<std::uint64_t>(bars);
+    w.put(r.fees);
+    w.put<std::int32_t>(r.stops); w.put<std::int32_t>(r.targets); w.put<std::int32_t>(r.drilled); w.put<std::int32_t>(r.ties);
+    r.metrics.serialize(w);
+}
+
+bool State::deserialize(util::BinReader& rd){
+    rd.get(cash); rd.get(qty); rd.get(entry); rd.get(entry_fee); rd.get(entry_eq); rd.get(sl); rd.get(tp);
+    rd.get(last_close);
+    entry_i = rd.get<std::uint64_t>(); bars = rd.get<std::uint64_t>();
+    r = Result{};
+    rd.get(r.fees);
+    r.stops = rd.get<std::int32_t>(); r.targets = rd.get<std::int32_t>();
+    r.drilled = rd.get<std::int32_t>(); r.ties = rd.get<std::int32_t>();
+    return r.metrics.deserialize(rd);
+}
+
+namespace {
+
+bool num(std::string_view s, double& v){
+    const auto r = std::from_chars(s.data(), s.data() + s.size(), v);
+    return r.ec == std::errc{} && r.ptr == s.data() + s.size();
+}
+
+} // namespace
+
+bool parse_fee(std::string_view s, FeeModel& out){
+    const auto plus = s.find('+');
+    if (plus == std::string_view::npos){
+        double rate = 0.0;
+        if (!num(s, rate) || rate < 0.0) return false;
+        out = PercentFee{rate};
+        return true;
+    }
+    double fixed = 0.0, rate = 0.0;
+    if (!num(s.substr(0, plus), fixed) || !num(s.substr(plus + 1), rate) || fixed < 0.0 || rate < 0.0) return false;
+    out = FixedPlusPercentFee{fixed, rate};
+    return true;
+}
+
+bool parse_sizing(std::string_view s, SizingModel& out){
+    const auto colon = s.find(':');
+    if (colon == std::string_view::npos) return false;
+    const auto kind = s.substr(0, colon);
+    double v = 0.0;
+    if (!num(s.substr(colon + 1), v) || v <= 0.0) return false;
+    if (kind == "cash"){ if (v > 1.0) return false; out = FractionOfCash{v}; }
+    else if (kind == "notional") out = FixedNotional{v};
+    else if (kind == "qty") out = FixedQty{v};
+    else return false;
+    return true;
+}
+
+bool parse_bracket(std::string_view s, Bracket& out){
+    const auto c1 = s.find(':');
+    if (c1 == std::string_view::npos) return false;
+    const auto c2 = s.find(':', c1 + 1);
+    Bracket b;
+    if (!num(s.substr(0, c1), b.tp_pct) || !num(s.substr(c1 + 1, c2 == std::string_view::npos? c2 : c2 - c1 - 1), b.sl_pct)) return false;
+    if (b.tp_pct < 0.0 || b.sl_pct < 0.0 || b.sl_pct >= 100.0) return false;
+    if (c2 != std::string_view::npos){
+        const auto tie = s.substr(c2 + 1);
+        if (tie == "stop") b.tie = TieBreak::StopFirst;
+        else if (tie == "target") b.tie = TieBreak::TargetFirst;
+        else if (tie == "open") b.tie = TieBreak::NearestOpen;
+        else return false;
+    }
+    out = b;
+    return true;
+}
+
+std::string to_string(const FeeModel& f){
+    if (const auto* p = std::get_if<PercentFee>(&f)) return std::to_string(p->rate);
+    const auto& q = std::get<FixedPlusPercentFee>(f);
+    return std::to_string(q.fixed) + "+" + std::to_string(q.rate);
+}
+
+std::string to_string(const SizingModel& s){
+    if (const auto* a = std::get_if<FractionOfCash>(&s)) return "cash:" + std::to_string(a->f);
+    if (const auto* b = std::get_if<FixedNotional>(&s)) return "notional:" + std::to_string(b->quote);
+    return "qty:" + std::to_string(std::get<FixedQty>(s).qty);
+}
+
+} // namespace backtest
@@ -0,0 +1,120 @@
+#include "backtest/monte_carlo.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace backtest {
+
+namespace {
+
+std::uint64_t splitmix64(std::uint64_t& x){
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256**: kicsi, gyors, a futásonkénti vetés splitmix64-gyel
+struct Rng {
+    std::uint64_t s[4];
+    explicit Rng(std::uint64_t seed){ for (auto& v : s) v = splitmix64(seed); }
+    static std::uint64_t rotl(std::uint64_t x, int k){ return (x << k) | (x >> (64 - k)); }
+    std::uint64_t next(){
+        const std::uint64_t r = rotl(s[1]*5, 7)*9, t = s[1] << 17;
+        s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3];
+        s[2] ^= t; s[3] = rotl(s[3], 45);
+        return r;
+    }
+    // [0, n), n < 2^32 (Lemire-szorzás, a torzítás itt elhanyagolható)
+    std::size_t below(std::size_t n){ return static_cast<std::size_t>(((next() >> 32) * n) >> 32); }
+};
+
+Interval interval(std::vector<double>& v){
+    Interval q;
+    if (v.empty()) return q;
+    auto at = [&](double p){
+        const auto k = static_cast<std::size_t>(std::lround(p*static_cast<double>(v.size() - 1)));
+        std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+        return v[k];
+    };
+    q.p5 = at(0.05); q.p50 = at(0.50); q.p95 = at(0.95);
+    return q;
+}
+
+} // namespace
+
+MonteCarloResult monte_carlo(std::span<const Trade> trades, const MonteCarloConfig& cfg, util::JobControl* ctl){
+    const auto t0 = std::chrono::steady_clock::now();
+    MonteCarloResult out;
+    const std::size_t nt = trades.size(), runs = cfg.runs;
+    if (nt == 0 || runs == 0 || cfg.cash <= 0.0) return out;
+
+    std::vector<double> ret(nt);
+    for (std::size_t k = 0; k < nt; ++k) ret[k] = trades[k].ret;
+
+    // futásonként egy slot; a meg nem futott (megszakított) slot NaN marad
+    constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> finals(runs, kNaN), dds(runs, kNaN);
+    if (ctl) ctl->add_total(runs);
+
+    unsigned threads = cfg.threads? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, runs));
+
+    auto work = [&](std::size_t from, std::size_t to){
+        std::vector<std::size_t> perm;
+        if (cfg.mode == Resample::Shuffle){ perm.resize(nt); }
+        constexpr std::size_t kStep = 64;
+        for (std::size_t r0 = from; r0 < to; r0 += kStep){
+            if (ctl && ctl->cancelled()) return;
+            const std::size_t r1 = std::min(to, r0 + kStep);
+            for (std::size_t r = r0; r < r1; ++r){
+                Rng rng(cfg.seed ^ (r * 0xD1B54A32D192ED03ull));
+                if (cfg.mode == Resample::Shuffle){
+                    std::iota(perm.begin(), perm.end(), std::size_t{0});
+                    for (std::size_t k = nt; k > 1; --k) std::swap(perm[k-1], perm[rng.below(k)]);
+                }
+                double eq = cfg.cash, peak = cfg.cash, dd = 0.0;
+                for (std::size_t k = 0; k < nt; ++k){
+                    const double x = ret[cfg.mode == Resample::Shuffle? perm[k] : rng.below(nt)];
+                    eq = std::max(0.0, eq*(1.0 + x));
+                    peak = std::max(peak, eq);
+                    dd = std::max(dd, (peak - eq)/peak);
+                }
+                finals[r] = eq;
+                dds[r] = dd;
+            }
+            if (ctl) ctl->advance(r1 - r0);
+        }
+    };
+    if (threads <= 1) work(0, runs);
+    else {
+        std::vector<std::thread> pool;
+        const std::size_t per = (runs + threads - 1) / threads;
+        for (unsigned t = 0; t < threads; ++t){
+            const std::size_t a = t*per, b = std::min(runs, a + per);
+            if (a < b) pool.emplace_back(work, a, b);
+        }
+        for (auto& th : pool) th.join();
+    }
+
+    std::erase_if(finals, [](double v){ return std::isnan(v); });
+    std::erase_if(dds, [](double v){ return std::isnan(v); });
+    out.runs = finals.size();
+    out.trades = nt;
+    if (out.runs == 0) return out;
+    out.p_loss = static_cast<double>(std::count_if(finals.begin(), finals.end(),
+                                                   [&](double v){ return v < cfg.cash; })) / static_cast<double>(out.runs);
+    std::vector<double> rets(finals.size());
+    std::transform(finals.begin(), finals.end(), rets.begin(), [&](double v){ return v/cfg.cash - 1.0; });
+    out.final_eq = interval(finals);
+    out.ret = interval(rets);
+    out.maxdd = interval(dds);
+    out.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return out;
+}
+
+} // namespace backtest
@@ -0,0 +1,150 @@
+#include "backtest/portfolio.hpp"
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace backtest {
+
+std::int64_t bar_length_ms(const BarColumns& bars){
+    const auto t = bars.open_time_ms;
+    std::int64_t best = std::numeric_limits<std::int64_t>::max();
+    for (std::size_t i = 1; i < t.size(); ++i){
+        const std::int64_t d = t[i] - t[i-1];
+        if (d > 0 && d < best) best = d;
+    }
+    return best == std::numeric_limits<std::int64_t>::max()? 0 : best;
+}
+
+bool bar_timeframe(const BarColumns& bars, Timeframe& tf){
+    return tf_from_ms(bar_length_ms(bars), tf);
+}
+
+namespace {
+
+struct Position {
+    double qty{0.0}, entry{0.0}, entry_fee{0.0}, last{0.0};
+    std::size_t entry_i{0};
+};
+
+template<class Fee>
+PortfolioResult run_impl(std::span<const PortfolioSymbol> syms, const PortfolioParams& p, const Fee& fee,
+                         std::vector<double>* equity, std::vector<std::int64_t>* times){
+    const std::size_t k = syms.size();
+    PortfolioResult out;
+    out.metrics.reset(p.cash);
+    out.symbols.resize(k);
+    std::vector<Position> pos(k);
+    std::vector<std::int64_t> len(k, 0);
+    std::vector<std::size_t> cur(k, 0);
+    for (std::size_t s = 0; s < k; ++s){
+        const auto& b = syms[s].bars;
+        out.symbols[s].name = syms[s].name;
+        // időbélyeg nélkül nem sorolható be: kimarad
+        out.symbols[s].bars = b.open_time_ms.size() == b.size()? std::min(b.size(), syms[s].combined.size()) : 0;
+        len[s] = bar_length_ms(b);
+    }
+
+    double cash = p.cash, held = 0.0;   // held: a nyitott pozíciók értéke az utolsó záróárakon
+    std::size_t open = 0;
+    auto revalue = [&]{
+        held = 0.0;
+        for (const auto& ps : pos) held += ps.qty*ps.last;
+    };
+    auto exit_at = [&](std::size_t s, std::size_t i, double px){
+        auto& ps = pos[s];
+        const double f = fee(ps.qty*px);
+        const double pnl = ps.qty*(px - ps.entry) - ps.entry_fee - f;
+        cash += ps.qty*px - f;
+        auto& sr = out.symbols[s];
+        sr.fees += f; sr.pnl += pnl;
+        sr.metrics.on_trade(pnl, i - ps.entry_i);
+        out.metrics.on_trade(pnl, i - ps.entry_i);
+        out.fees += f;
+        ps.qty = 0.0;
+        --open;
+        revalue();
+    };
+    auto on_event = [&](std::size_t s, std::size_t i){
+        const auto& sym = syms[s];
+        const double c = sym.bars.close[i];
+        auto& ps = pos[s];
+        if (ps.qty > 0.0) held += ps.qty*(c - ps.last);
+        ps.last = c;
+        const double score = sym.combined[i];
+        if (score > p.up && ps.qty == 0.0){
+            auto& sr = out.symbols[s];
+            if ((p.max_positions > 0 && open >= p.max_positions) || cash <= 0.0){ ++sr.rejected; return; }
+            const double cap = std::max(0.0, sym.alloc.max_weight*(cash + held))/c;
+            const double want = std::visit([&](const auto& size){ return size(cash, c); }, sym.alloc.sizing);
+            const double q = std::min({want, fee.max_notional(cash)/c, cap});
+            if (q <= 0.0){ ++sr.rejected; return; }
+            ps.qty = q; ps.entry = c; ps.entry_i = i;
+            ps.entry_fee = fee(q*c);
+            cash -= q*c + ps.entry_fee;
+            sr.fees += ps.entry_fee;
+            out.fees += ps.entry_fee;
+            ++open;
+            revalue();
+        } else if (score < p.down && ps.qty > 0.0){
+            exit_at(s, i, c);
+        }
+    };
+
+    // k-utas összefésülés a bar-zárások szerint; azonos időpontban a symbol indexe dönt
+    using Key = std::pair<std::int64_t, std::size_t>;
+    auto close_ms = [&](std::size_t s, std::size_t i){ return syms[s].bars.open_time_ms[i] + len[s]; };
+    std::priority_queue<Key, std::vector<Key>, std::greater<>> heap;
+    for (std::size_t s = 0; s < k; ++s) if (out.symbols[s].bars > 0) heap.push({close_ms(s, 0), s});
+    while (!heap.empty()){
+        const std::int64_t t = heap.top().first;
+        while (!heap.empty() && heap.top().first == t){
+            const std::size_t s = heap.top().second;
+            heap.pop();
+            const std::size_t i = cur[s]++;
+            on_event(s, i);
+            ++out.events;
+            if (cur[s] < out.symbols[s].bars) heap.push({close_ms(s, cur[s]), s});
+        }
+        const double eq = cash + held;
+        out.metrics.on_bar(eq, open > 0);
+        ++out.steps;
+        if (equity) equity->push_back(eq);
+        if (times) times->push_back(t);
+    }
+    for (std::size_t s = 0; s < k; ++s)
+        if (pos[s].qty > 0.0) exit_at(s, out.symbols[s].bars - 1, pos[s].last);
+    out.final_eq = cash;
+    if (equity && !equity->empty()) equity->back() = cash;
+    return out;
+}
+
+} // namespace
+
+PortfolioResult run_portfolio(std::span<const PortfolioSymbol> syms, const PortfolioParams& p,
+                              std::vector<double>* equity, std::vector<std::int64_t>* times){
+    return std::visit([&](const auto& fee){ return run_impl(syms, p, fee, equity, times); }, p.fee);
+}
+
+bool parse_allocation(std::string_view spec, std::span<PortfolioSymbol> syms, double def){
+    for (auto& s : syms) s.alloc.max_weight = def;
+    while (!spec.empty()){
+        const auto comma = spec.find(',');
+        const auto item = spec.substr(0, comma);
+        spec = (comma == std::string_view::npos)? std::string_view{} : spec.substr(comma + 1);
+        const auto colon = item.find(':');
+        if (colon == std::string_view::npos) return false;
+        const auto name = item.substr(0, colon), num = item.substr(colon + 1);
+        double w = 0.0;
+        const auto r = std::from_chars(num.data(), num.data() + num.size(), w);
+        if (r.ec != std::errc{} || r.ptr != num.data() + num.size() || w <= 0.0 || w > 1.0) return false;
+        auto it = std::find_if(syms.begin(), syms.end(), [&](const PortfolioSymbol& s){ return s.name == name; });
+        if (it == syms.end()) return false;
+        it->alloc.max_weight = w;
+    }
+    return true;
+}
+
+} // namespace backtest
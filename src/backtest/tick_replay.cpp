@@ -0,0 +1,100 @@
+#include "backtest/tick_replay.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace backtest {
+
+TickReplay::TickReplay(const Params& p, const TickParams& tp, SignalFn sig, std::vector<Trade>* trades)
+    : p_(p), tp_(tp), sig_(std::move(sig)), trades_(trades), st_(p.cash) {
+    if (tp_.bar_ms <= 0) tp_.bar_ms = 300'000;
+    tp_.latency_ms = std::max<std::int64_t>(0, tp_.latency_ms);
+}
+
+void TickReplay::close_bar(State& s, const Bar& bar){
+    const Signal sg = sig_? sig_(bar) : Signal::Neutral;
+    s.r.metrics.on_bar(s.cash + s.qty*bar.close, s.qty > 0.0);
+    s.last_close = bar.close;
+    ++s.bars;
+    ++stats_.bars;
+    // egyszerre egy függő megbízás; a pozíciót a teljesüléskor még egyszer nézzük (közben stop zárhatta)
+    if (pending_ != Pending::None) return;
+    if (sg == Signal::Long && s.qty == 0.0) pending_ = Pending::Buy;
+    else if (sg == Signal::Short && s.qty > 0.0) pending_ = Pending::Sell;
+    else return;
+    due_ms_ = bar.open_time_ms + tp_.bar_ms + tp_.latency_ms;
+    ref_px_ = bar.close;
+}
+
+template<class Fee, class Sizing>
+void TickReplay::feed_impl(const TickColumns& ticks, const Fee& fee, const Sizing& size){
+    // lokális másolatok: a tickenkénti ciklusban regiszterben maradhatnak
+    State s = st_;
+    Bar bar = bar_;
+    bool open = has_bar_;
+    std::int64_t end = bar_end_;
+    const std::int64_t len = tp_.bar_ms;
+    const bool bracket = p_.bracket.enabled();
+    const auto time = ticks.time_ms;
+    const auto price = ticks.price;
+    const bool has_qty = ticks.qty.size() == ticks.size();
+
+    for (std::size_t k = 0, n = ticks.size(); k < n; ++k){
+        const std::int64_t t = time[k];
+        const double px = price[k];
+        if (open && t >= end){ close_bar(s, bar); open = false; }
+
+        // nyitott bracket: a belépő kötés után minden kötés (a belépés ugyanebben az iterációban később jön)
+        if (bracket && s.qty > 0.0){
+            if (s.sl > 0.0 && px <= s.sl) detail::exit_at(s, fee, s.bars, px, ExitReason::StopLoss, trades_);
+            else if (s.tp > 0.0 && px >= s.tp) detail::exit_at(s, fee, s.bars, s.tp, ExitReason::TakeProfit, trades_);
+        }
+        if (pending_ != Pending::None && t >= due_ms_){
+            if (pending_ == Pending::Buy && s.qty == 0.0 && s.cash > 0.0){
+                const double q = std::min(size(s.cash, px), fee.max_notional(s.cash)/px);
+                if (q > 0.0){
+                    s.qty = q; s.entry = px; s.entry_i = s.bars; s.entry_eq = s.cash;
+                    s.entry_fee = fee(q*px);
+                    s.cash -= q*px + s.entry_fee;
+                    s.r.fees += s.entry_fee;
+                    s.sl = p_.bracket.sl_pct > 0.0? px*(1.0 - p_.bracket.sl_pct/100.0) : 0.0;
+                    s.tp = p_.bracket.tp_pct > 0.0? px*(1.0 + p_.bracket.tp_pct/100.0) : 0.0;
+                    ++stats_.fills;
+                    stats_.slippage += (px - ref_px_)/ref_px_;
+                }
+            } else if (pending_ == Pending::Sell && s.qty > 0.0){
+                detail::exit_at(s, fee, s.bars, px, ExitReason::Signal, trades_);
+                ++stats_.fills;
+                stats_.slippage += (ref_px_ - px)/ref_px_;
+            }
+            pending_ = Pending::None;
+        }
+
+        const double q = has_qty? ticks.qty[k] : 0.0;
+        if (!open){
+            const std::int64_t r = t % len;
+            bar = {t - (r < 0? r + len : r), px, px, px, px, q};
+            end = bar.open_time_ms + len;
+            open = true;
+        } else {
+            bar.high = std::max(bar.high, px);
+            bar.low = std::min(bar.low, px);
+            bar.close = px;
+            bar.volume += q;
+        }
+    }
+    stats_.ticks += ticks.size();
+    st_ = s; bar_ = bar; has_bar_ = open; bar_end_ = end;
+}
+
+void TickReplay::feed(const TickColumns& ticks){
+    if (ticks.time_ms.size() != ticks.size()) return;
+    std::visit([&](const auto& fee, const auto& size){ feed_impl(ticks, fee, size); }, p_.fee, p_.sizing);
+}
+
+Result TickReplay::finish(){
+    if (has_bar_){ close_bar(st_, bar_); has_bar_ = false; }
+    pending_ = Pending::None;   // a végén beérkező jelre már nincs kötés
+    return backtest::finish(st_, p_, trades_);
+}
+
+} // namespace backtest
@@ -0,0 +1,136 @@
+#include "data/bar_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace data {
+
+static constexpr std::uint64_t kAlign = 64;
+static std::uint64_t align_up(std::uint64_t x){ return (x + kAlign - 1) / kAlign * kAlign; }
+
+bool write_bar_file(const std::string& path, const BarColumns& cols, std::uint32_t index_stride){
+    const std::size_t n = cols.size();
+    if (cols.open_time_ms.size() != n || index_stride == 0) return false;
+
+    BarFileHeader h{};
+    std::memcpy(h.magic, kBarFileMagic, sizeof(h.magic));
+    h.version = kBarFileVersion;
+    h.header_bytes = sizeof(BarFileHeader);
+    h.count = n;
+    h.first_open_ms = n? cols.open_time_ms.front() : 0;
+    h.last_open_ms  = n? cols.open_time_ms.back()  : 0;
+    h.step_ms = (n >= 2? cols.open_time_ms[1] - cols.open_time_ms[0] : 0);
+    for (std::size_t i = 1; i < n && h.step_ms != 0; ++i)
+        if (cols.open_time_ms[i] - cols.open_time_ms[i-1] != h.step_ms) h.step_ms = 0;
+    h.index_stride = index_stride;
+
+    std::uint64_t off = align_up(sizeof(BarFileHeader));
+    for (auto& c : h.col_off){ c = off; off = align_up(off + n * 8); }
+    h.index_off = off;
+    h.index_count = (n + index_stride - 1) / index_stride;
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    std::uint64_t pos = 0;
+    auto write_at = [&](std::uint64_t at, const void* p, std::size_t bytes){
+        static const char zeros[kAlign] = {};
+        while (pos < at){ const auto k = std::min<std::uint64_t>(at - pos, kAlign); f.write(zeros, static_cast<std::streamsize>(k)); pos += k; }
+        f.write(static_cast<const char*>(p), static_cast<std::streamsize>(bytes)); pos += bytes;
+    };
+    write_at(0, &h, sizeof(h));
+    write_at(h.col_off[0], cols.open_time_ms.data(), n * 8);
+
+    // hiányzó oszlop: at() szemantikája szerint close / 0
+    const std::span<const double> src[5] = { cols.open, cols.high, cols.low, cols.close, cols.volume };
+    std::vector<double> fill;
+    for (int k = 0; k < 5; ++k){
+        if (src[k].size() == n){ write_at(h.col_off[k+1], src[k].data(), n * 8); continue; }
+        if (k == 4) fill.assign(n, 0.0);
+        else fill.assign(cols.close.begin(), cols.close.end());
+        write_at(h.col_off[k+1], fill.data(), n * 8);
+    }
+    std::vector<std::int64_t> index(h.index_count);
+    for (std::size_t k = 0; k < index.size(); ++k) index[k] = cols.open_time_ms[k * index_stride];
+    write_at(h.index_off, index.data(), index.size() * 8);
+    return static_cast<bool>(f);
+}
+
+bool is_bar_file(const std::string& path){
+    std::ifstream f(path, std::ios::binary);
+    char m[sizeof(kBarFileMagic)]{};
+    return f.read(m, sizeof(m)) && std::memcmp(m, kBarFileMagic, sizeof(m)) == 0;
+}
+
+MappedBars::~MappedBars(){ close(); }
+
+MappedBars::MappedBars(MappedBars&& o) noexcept { *this = std::move(o); }
+
+MappedBars& MappedBars::operator=(MappedBars&& o) noexcept {
+    if (this == &o) return *this;
+    close();
+    file_ = std::move(o.file_);
+    hdr_ = o.hdr_; cols_ = o.cols_; index_ = o.index_; err_ = std::move(o.err_);
+    o.hdr_ = nullptr; o.cols_ = {}; o.index_ = {};
+    return *this;
+}
+
+bool MappedBars::fail(std::string msg){
+    close();
+    err_ = std::move(msg);
+    return false;
+}
+
+void MappedBars::close(){
+    file_.close();
+    hdr_ = nullptr; cols_ = {}; index_ = {};
+}
+
+bool MappedBars::open(const std::string& path){
+    close();
+    err_.clear();
+    std::string err;
+    if (!file_.open(path, err)) return fail(std::move(err)); // backtest: végigolvasás
+    const char* base = file_.data();
+    const std::size_t bytes = file_.size();
+    if (bytes < sizeof(BarFileHeader)) return fail("túl rövid: " + path);
+
+    hdr_ = reinterpret_cast<const BarFileHeader*>(base);
+    const auto& h = *hdr_;
+    if (std::memcmp(h.magic, kBarFileMagic, sizeof(h.magic)) != 0) return fail("nem .bars fájl: " + path);
+    if (h.version != kBarFileVersion || h.header_bytes != sizeof(BarFileHeader))
+        return fail("nem támogatott .bars verzió: " + std::to_string(h.version));
+    const std::uint64_t n = h.count;
+    if (n > bytes / 8) return fail("sérült fejléc (count)");
+    for (auto off : h.col_off)
+        if (off % 8 != 0 || off > bytes || n * 8 > bytes - off) return fail("sérült fejléc (oszlop)");
+    if (h.index_stride == 0 || h.index_count != (n + h.index_stride - 1) / h.index_stride ||
+        h.index_off % 8 != 0 || h.index_off > bytes || h.index_count * 8 > bytes - h.index_off)
+        return fail("sérült fejléc (index)");
+
+    auto col = [&](int k){ return std::span<const double>(reinterpret_cast<const double*>(base + h.col_off[k]), n); };
+    cols_.open_time_ms = std::span<const std::int64_t>(reinterpret_cast<const std::int64_t*>(base + h.col_off[0]), n);
+    cols_.open = col(1); cols_.high = col(2); cols_.low = col(3); cols_.close = col(4); cols_.volume = col(5);
+    index_ = std::span<const std::int64_t>(reinterpret_cast<const std::int64_t*>(base + h.index_off), h.index_count);
+    return true;
+}
+
+std::size_t MappedBars::lower_bound(std::int64_t t) const {
+    if (!hdr_ || size() == 0) return 0;
+    // az utolsó blokk, aminek az első eleme < t; a keresett pozíció ebben vagy a következő blokk elején van
+    const auto blk = std::lower_bound(index_.begin(), index_.end(), t) - index_.begin();
+    if (blk == 0) return 0;
+    const std::size_t stride = hdr_->index_stride;
+    const std::size_t lo = static_cast<std::size_t>(blk - 1) * stride;
+    const std::size_t hi = std::min(size(), lo + stride);
+    const auto ts = cols_.open_time_ms;
+    return static_cast<std::size_t>(std::lower_bound(ts.begin() + lo, ts.begin() + hi, t) - ts.begin());
+}
+
+BarColumns MappedBars::range(std::int64_t from_ms, std::int64_t to_ms) const {
+    const std::size_t a = lower_bound(from_ms);
+    const std::size_t b = std::max(a, lower_bound(to_ms));
+    return cols_.subspan(a, b - a);
+}
+
+} // namespace data
@@ -0,0 +1,172 @@
+#include "data/bar_loader.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace data {
+
+namespace {
+
+constexpr std::size_t kBlock = 16u << 20;        // olvasási blokk (a következő olvasása a parse alatt fut)
+constexpr std::size_t kMinChunk = 1u << 20;      // ennél kisebb darabot nem adunk külön szálnak
+constexpr std::int64_t kMicrosThreshold = 100'000'000'000'000; // e fölött az open_time µs
+
+// egy mező a következő ','-ig (vagy a sor végéig); p a mező után áll
+template<class T>
+bool field(const char*& p, const char* end, T& v){
+    const auto r = std::from_chars(p, end, v);
+    if (r.ec != std::errc{}) return false;
+    p = r.ptr;
+    if (p < end){ if (*p != ',') return false; ++p; }
+    return true;
+}
+
+bool parse_line(const char* p, const char* end, Bar& b){
+    if (!field(p, end, b.open_time_ms)) return false;
+    if (b.open_time_ms >= kMicrosThreshold) b.open_time_ms /= 1000;
+    // a 6. mező után jöhetnek további oszlopok (close_time, quote volume, ...): nem érdekesek
+    return field(p, end, b.open) && field(p, end, b.high) && field(p, end, b.low)
+        && field(p, end, b.close) && field(p, end, b.volume);
+}
+
+struct Chunk { BarTable bars; std::size_t lines{0}, malformed{0}; };
+
+void parse_chunk(const char* p, const char* end, Chunk& out){
+    out.bars.reserve(static_cast<std::size_t>(end - p) / 48); // ~ egy Binance kline sor hossza
+    while (p < end){
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        const char* le = nl? nl : end;
+        const char* e = le;
+        if (e > p && e[-1] == '\r') --e;
+        if (e > p){
+            ++out.lines;
+            Bar b{};
+            if (parse_line(p, e, b)) out.bars.push_back(b);
+            else ++out.malformed;
+        }
+        p = nl? nl + 1 : end;
+    }
+}
+
+void append(BarTable& dst, const BarTable& src){
+    auto cat = [](auto& d, const auto& s){ d.insert(d.end(), s.begin(), s.end()); };
+    cat(dst.open_time_ms, src.open_time_ms); cat(dst.open, src.open); cat(dst.high, src.high);
+    cat(dst.low, src.low); cat(dst.close, src.close); cat(dst.volume, src.volume);
+}
+
+} // namespace
+
+bool load_csv(const std::string& path, BarTable& out, CsvStats* stats, unsigned threads) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.good()) return false;
+    f.seekg(0, std::ios::end);
+    const auto fsize = static_cast<std::size_t>(std::max<std::streamoff>(0, f.tellg()));
+    f.seekg(0, std::ios::beg);
+    out.reserve(out.size() + fsize / 48);
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    // szálanként legalább két kMinChunk darab jusson; kis fájlnál nem foglalunk teljes blokkot
+    // (a +1 miatt az első olvasás már eof-ot jelez)
+    const std::size_t block = std::min(std::max(kBlock, 2 * threads * kMinChunk), fsize + 1);
+    CsvStats st;
+    bool first = true;
+    std::vector<Chunk> chunks;
+
+    // kettős puffer: amíg a szálak a cur blokkot parse-olják, egy olvasó szál a következőt tölti a next-be
+    // (az előző blokk befejezetlen sora, a carry, a next elejére kerül). Az olvasás és a parse így átfed.
+    std::vector<char> cur(block), next;
+    auto read_block = [&f, block](std::vector<char>& buf, std::size_t at){
+        buf.resize(at + block);
+        f.read(buf.data() + at, static_cast<std::streamsize>(block));
+        return static_cast<std::size_t>(f.gcount());
+    };
+    std::size_t got = read_block(cur, 0);
+    std::size_t len = got;
+
+    while (true){
+        const bool eof = got < block;
+        const char* b = cur.data();
+        const char* e = b + len;
+
+        // a blokk csak teljes sorokat ad tovább; a maradék a következő körbe megy
+        const char* full_end = e;
+        if (!eof){
+            const char* p = e;
+            while (p > b && p[-1] != '\n') --p;
+            full_end = p;
+        }
+        const std::size_t carry = static_cast<std::size_t>(e - full_end);
+        std::jthread reader;
+        if (!eof){
+            next.resize(carry + block);
+            std::memcpy(next.data(), full_end, carry);
+            reader = std::jthread([&]{ got = read_block(next, carry); });
+        }
+
+        // opcionális header: az első nem üres sor, ha nem értelmezhető barként
+        if (first && full_end > b){
+            const char* nl = static_cast<const char*>(std::memchr(b, '\n', static_cast<std::size_t>(full_end - b)));
+            const char* le = nl? nl : full_end;
+            const char* ee = (le > b && le[-1] == '\r')? le - 1 : le;
+            Bar tmp{};
+            if (ee > b && !parse_line(b, ee, tmp)){ st.header = true; b = nl? nl + 1 : full_end; }
+            first = false;
+        }
+
+        // darabolás sorhatáron, szálanként
+        const std::size_t span = static_cast<std::size_t>(full_end - b);
+        const std::size_t parts = std::max<std::size_t>(1, std::min<std::size_t>(threads, span / kMinChunk));
+        std::vector<const char*> cuts{b};
+        for (std::size_t k = 1; k < parts; ++k){
+            const char* c = std::max(cuts.back(), b + span * k / parts);
+            const char* nl = static_cast<const char*>(std::memchr(c, '\n', static_cast<std::size_t>(full_end - c)));
+            cuts.push_back(nl? nl + 1 : full_end);
+        }
+        cuts.push_back(full_end);
+
+        chunks.assign(parts, Chunk{});
+        if (parts == 1) parse_chunk(cuts[0], cuts[1], chunks[0]);
+        else {
+            std::vector<std::thread> pool;
+            for (std::size_t k = 0; k < parts; ++k)
+                pool.emplace_back(parse_chunk, cuts[k], cuts[k+1], std::ref(chunks[k]));
+            for (auto& t : pool) t.join();
+        }
+        for (const auto& c : chunks){ append(out, c.bars); st.lines += c.lines; st.malformed += c.malformed; }
+
+        if (eof) break;
+        reader.join();
+        std::swap(cur, next);
+        len = carry + got;
+    }
+
+    if (stats) *stats = st;
+    return !out.empty();
+}
+
+bool LoadedBars::load(const std::string& path, unsigned csv_threads){
+    map_.close(); table_ = BarTable{}; cols_ = {}; csv_ = {}; err_.clear(); hashed_ = false;
+    if (is_bar_file(path)){
+        if (!map_.open(path)){ err_ = map_.error(); return false; }
+        cols_ = map_.columns();
+    } else {
+        if (!load_csv(path, table_, &csv_, csv_threads)){ err_ = "CSV betoltes sikertelen: " + path; return false; }
+        cols_ = table_.columns();
+    }
+    if (empty()){ err_ = "ures: " + path; return false; }
+    return true;
+}
+
+BarColumns LazyBars::range(std::int64_t from_ms, std::int64_t to_ms){
+    std::call_once(once_, [&]{ loaded_ = bars_.load(path_); });
+    if (!loaded_) return {};
+    const BarColumns c = bars_.columns();
+    const auto ts = c.open_time_ms;
+    const auto a = static_cast<std::size_t>(std::lower_bound(ts.begin(), ts.end(), from_ms) - ts.begin());
+    const auto b = static_cast<std::size_t>(std::lower_bound(ts.begin() + static_cast<std::ptrdiff_t>(a), ts.end(), to_ms) - ts.begin());
+    return c.subspan(a, b - a);
+}
+
+} // namespace data
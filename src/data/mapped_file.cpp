@@ -0,0 +1,92 @@
+#include "data/mapped_file.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace data {
+
+MappedFile::~MappedFile(){ close(); }
+
+MappedFile::MappedFile(MappedFile&& o) noexcept { *this = std::move(o); }
+
+MappedFile& MappedFile::operator=(MappedFile&& o) noexcept {
+    if (this == &o) return *this;
+    close();
+    base_ = o.base_; bytes_ = o.bytes_;
+#ifdef _WIN32
+    file_ = o.file_; mapping_ = o.mapping_; o.file_ = nullptr; o.mapping_ = nullptr;
+#else
+    fd_ = o.fd_; o.fd_ = -1;
+#endif
+    o.base_ = nullptr; o.bytes_ = 0;
+    return *this;
+}
+
+void MappedFile::close(){
+#ifdef _WIN32
+    if (base_) UnmapViewOfFile(base_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+    file_ = nullptr; mapping_ = nullptr;
+#else
+    if (base_) munmap(const_cast<char*>(base_), bytes_);
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+#endif
+    base_ = nullptr; bytes_ = 0;
+}
+
+bool MappedFile::open(const std::string& path, std::string& err, bool sequential){
+    close();
+    auto fail = [&](std::string msg){ close(); err = std::move(msg); return false; };
+#ifdef _WIN32
+    (void)sequential;
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE){ file_ = nullptr; return fail("nem nyitható: " + path); }
+    LARGE_INTEGER sz{};
+    if (!GetFileSizeEx(file_, &sz)) return fail("méret lekérdezés sikertelen: " + path);
+    bytes_ = static_cast<std::size_t>(sz.QuadPart);
+    if (bytes_ == 0) return fail("üres fájl: " + path);
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) return fail("CreateFileMapping sikertelen: " + path);
+    base_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!base_) return fail("MapViewOfFile sikertelen: " + path);
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) return fail("nem nyitható: " + path);
+    struct stat st{};
+    if (fstat(fd_, &st) != 0) return fail("fstat sikertelen: " + path);
+    bytes_ = static_cast<std::size_t>(st.st_size);
+    if (bytes_ == 0) return fail("üres fájl: " + path);
+    void* p = mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED){ bytes_ = 0; return fail("mmap sikertelen: " + path); }
+    base_ = static_cast<const char*>(p);
+    if (sequential) madvise(p, bytes_, MADV_SEQUENTIAL);
+#endif
+    return true;
+}
+
+void MappedFile::release(std::size_t off, std::size_t len) const {
+#ifdef _WIN32
+    (void)off; (void)len;
+#else
+    if (!base_ || off >= bytes_) return;
+    len = std::min(len, bytes_ - off);
+    const auto page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto a = reinterpret_cast<std::uintptr_t>(base_ + off);
+    const auto b = a + len;
+    const std::uintptr_t from = (a + page - 1) / page * page, to = b / page * page;  // csak teljes lapok
+    if (from < to) madvise(reinterpret_cast<void*>(from), to - from, MADV_DONTNEED);
+#endif
+}
+
+} // namespace data
@@ -0,0 +1,115 @@
+#include "data/snapshot.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+namespace data {
+
+static constexpr char kMagic[4] = {'H','S','N','P'};
+static constexpr std::uint32_t kVersion = 1;
+
+std::string snapshot_path(const std::string& dir, const Symbol& sym, Timeframe tf){
+    std::string d = dir.empty()? std::string(".") : dir;
+    if (d.back()!='/' && d.back()!='\\') d += '/';
+    return d + sym.name() + "_" + std::to_string(static_cast<int>(tf)) + ".snap";
+}
+
+bool save_snapshot(const std::string& path, const Symbol& sym, Timeframe tf, const BarSeries& series,
+                   std::span<const std::unique_ptr<IModule>> modules){
+    util::BinWriter w;
+    w.put_bytes(kMagic);
+    w.put(kVersion);
+    w.put_str(sym.name());
+    w.put<std::uint8_t>(static_cast<std::uint8_t>(tf));
+    w.put<std::int64_t>(series.empty()? 0 : series.back().open_time_ms);
+
+    w.put_span(series.open_time());
+    w.put_span(series.open()); w.put_span(series.high()); w.put_span(series.low());
+    w.put_span(series.close()); w.put_span(series.volume());
+
+    w.put<std::uint32_t>(static_cast<std::uint32_t>(modules.size()));
+    util::BinWriter blob;
+    for (const auto& m : modules){
+        blob.clear();
+        w.put_str(m->id());
+        if (!m->serialize(blob)) blob.clear(); // nem támogatott: üres blob, betöltéskor reset
+        w.put<std::uint64_t>(blob.size());
+        w.put_bytes(blob.data());
+    }
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f){ spdlog::warn("snapshot: nem nyitható írásra: {}", tmp); return false; }
+        f.write(w.data().data(), static_cast<std::streamsize>(w.size()));
+        if (!f){ spdlog::warn("snapshot: írási hiba: {}", tmp); return false; }
+    }
+    std::remove(path.c_str()); // Windows-on a rename nem ír felül
+    if (std::rename(tmp.c_str(), path.c_str())!=0){
+        spdlog::warn("snapshot: rename sikertelen: {} -> {}", tmp, path);
+        return false;
+    }
+    return true;
+}
+
+std::optional<SnapshotInfo> load_snapshot(const std::string& path, const Symbol& sym, Timeframe tf,
+                                          BarSeries& series, std::span<const std::unique_ptr<IModule>> modules){
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return std::nullopt;
+    const std::vector<char> buf((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    util::BinReader r(buf);
+    char magic[4]{};
+    for (char& c : magic) c = r.get<char>();
+    if (!std::equal(magic, magic+4, kMagic) || r.get<std::uint32_t>()!=kVersion){
+        spdlog::warn("snapshot: ismeretlen formátum: {}", path);
+        return std::nullopt;
+    }
+    if (r.get_str()!=sym.name() || r.get<std::uint8_t>()!=static_cast<std::uint8_t>(tf)){
+        spdlog::warn("snapshot: más symbol/TF-hez tartozik: {}", path);
+        return std::nullopt;
+    }
+    SnapshotInfo info;
+    info.last_open_time_ms = r.get<std::int64_t>();
+
+    const auto t = r.get_vec<std::int64_t>();
+    const auto o = r.get_vec<double>(), h = r.get_vec<double>(), l = r.get_vec<double>();
+    const auto c = r.get_vec<double>(), v = r.get_vec<double>();
+    const std::size_t n = t.size();
+    if (o.size()!=n || h.size()!=n || l.size()!=n || c.size()!=n || v.size()!=n) r.fail();
+
+    struct Rec { std::string id; util::BinReader blob; bool used{false}; };
+    std::vector<Rec> recs;
+    const auto cnt = r.get<std::uint32_t>();
+    for (std::uint32_t i=0; i<cnt && r.ok(); ++i){
+        std::string id = r.get_str();
+        const auto len = r.get<std::uint64_t>();
+        if (len > r.remaining()){ r.fail(); break; }
+        recs.push_back({std::move(id), r.sub(static_cast<std::size_t>(len))});
+    }
+    if (!r.ok()){
+        spdlog::warn("snapshot: sérült fájl: {}", path);
+        return std::nullopt;
+    }
+
+    series.clear();
+    for (std::size_t i=0; i<n; ++i) series.push({t[i], o[i], h[i], l[i], c[i], v[i]});
+    info.bars = series.size();
+
+    for (const auto& m : modules){
+        const std::string id = m->id();
+        auto it = std::find_if(recs.begin(), recs.end(), [&](const Rec& x){ return !x.used && x.id==id; });
+        bool ok = false;
+        if (it!=recs.end()){
+            it->used = true;
+            ok = it->blob.remaining()>0 && m->deserialize(it->blob) && it->blob.ok();
+        }
+        if (ok) ++info.restored;
+        else { m->reset(); ++info.skipped; }
+    }
+    return info;
+}
+
+} // namespace data
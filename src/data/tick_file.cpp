@@ -0,0 +1,226 @@
+#include "data/tick_file.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace data {
+
+namespace {
+
+constexpr std::size_t kBlock = 64u << 20;        // olvasási blokk
+constexpr std::size_t kFlush = 1u << 20;         // oszloponként ennyi tick után írunk
+constexpr std::int64_t kMicrosThreshold = 100'000'000'000'000; // e fölött az időbélyeg µs
+constexpr std::uint64_t kAlign = 64;
+constexpr std::uint64_t kWidth[4] = {8, 8, 8, 1}; // time, price, qty, flags
+
+std::uint64_t align_up(std::uint64_t x){ return (x + kAlign - 1) / kAlign * kAlign; }
+
+void fail(std::string* err, std::string msg){ if (err) *err = std::move(msg); }
+
+// egy mező a következő ','-ig (vagy a sor végéig); p a mező után áll
+template<class T>
+bool field(const char*& p, const char* end, T& v){
+    const auto r = std::from_chars(p, end, v);
+    if (r.ec != std::errc{}) return false;
+    p = r.ptr;
+    if (p < end){ if (*p != ',') return false; ++p; }
+    return true;
+}
+
+bool flag_field(const char*& p, const char* end, bool& v){
+    const char* e = static_cast<const char*>(std::memchr(p, ',', static_cast<std::size_t>(end - p)));
+    if (!e) e = end;
+    const std::string_view s(p, static_cast<std::size_t>(e - p));
+    if (s == "true" || s == "True" || s == "1") v = true;
+    else if (s == "false" || s == "False" || s == "0") v = false;
+    else return false;
+    p = e < end? e + 1 : end;
+    return true;
+}
+
+struct Tick { std::int64_t id{0}, time{0}; double price{0.0}, qty{0.0}; std::uint8_t flags{0}; };
+
+bool parse_line(const char* p, const char* end, Tick& t){
+    std::int64_t first_id = 0, last_id = 0;
+    bool maker = false;
+    if (!(field(p, end, t.id) && field(p, end, t.price) && field(p, end, t.qty) && field(p, end, first_id)
+          && field(p, end, last_id) && field(p, end, t.time) && flag_field(p, end, maker)))
+        return false;
+    if (t.time >= kMicrosThreshold) t.time /= 1000;
+    t.flags = maker? TickColumns::kTickBuyerMaker : 0;
+    return t.price > 0.0;
+}
+
+// a sorok felső becslése a column régiók méretezéséhez (egy gyors végigolvasás)
+bool count_lines(const std::string& path, std::uint64_t& n){
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    std::vector<char> buf(kBlock);
+    n = 0;
+    char last = '\n';
+    while (f){
+        f.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        const auto got = static_cast<std::size_t>(f.gcount());
+        if (got == 0) break;
+        n += static_cast<std::uint64_t>(std::count(buf.data(), buf.data() + got, '\n'));
+        last = buf[got - 1];
+    }
+    if (last != '\n') ++n;
+    return true;
+}
+
+} // namespace
+
+bool convert_aggtrades_csv(const std::string& csv, const std::string& out, TickCsvStats* stats, std::string* err){
+    std::uint64_t cap = 0;
+    if (!count_lines(csv, cap)){ fail(err, "nem nyitható: " + csv); return false; }
+    std::ifstream in(csv, std::ios::binary);
+    std::ofstream f(out, std::ios::binary | std::ios::trunc);
+    if (!in || !f){ fail(err, "nem nyitható: " + (in? out : csv)); return false; }
+
+    TickFileHeader h{};
+    std::memcpy(h.magic, kTickFileMagic, sizeof(h.magic));
+    h.version = kTickFileVersion;
+    h.header_bytes = sizeof(TickFileHeader);
+    h.capacity = cap;
+    std::uint64_t off = align_up(sizeof(TickFileHeader));
+    for (int k = 0; k < 4; ++k){ h.col_off[k] = off; off = align_up(off + cap * kWidth[k]); }
+    const std::uint64_t file_end = std::max<std::uint64_t>(off, sizeof(TickFileHeader));
+
+    std::vector<std::int64_t> tb; std::vector<double> pb, qb; std::vector<std::uint8_t> fb;
+    tb.reserve(kFlush); pb.reserve(kFlush); qb.reserve(kFlush); fb.reserve(kFlush);
+    std::uint64_t written = 0;
+    auto flush = [&]{
+        auto put = [&](int k, const void* p, std::size_t n){
+            f.seekp(static_cast<std::streamoff>(h.col_off[k] + written * kWidth[k]));
+            f.write(static_cast<const char*>(p), static_cast<std::streamsize>(n * kWidth[k]));
+        };
+        put(0, tb.data(), tb.size()); put(1, pb.data(), pb.size());
+        put(2, qb.data(), qb.size()); put(3, fb.data(), fb.size());
+        written += tb.size();
+        tb.clear(); pb.clear(); qb.clear(); fb.clear();
+    };
+
+    TickCsvStats st;
+    bool first = true, ok = true;
+    std::vector<char> buf;
+    std::size_t carry = 0; // előző blokk befejezetlen sora a buf elején
+    while (ok){
+        buf.resize(carry + kBlock);
+        in.read(buf.data() + carry, static_cast<std::streamsize>(kBlock));
+        const std::size_t got = static_cast<std::size_t>(in.gcount());
+        const bool eof = got < kBlock;
+        const char* p = buf.data();
+        const char* e = p + carry + got;
+        const char* full_end = e;
+        if (!eof){ while (full_end > p && full_end[-1] != '\n') --full_end; }
+
+        while (p < full_end){
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(full_end - p)));
+            const char* le = nl? nl : full_end;
+            if (le > p && le[-1] == '\r') --le;
+            if (le > p){
+                Tick t;
+                if (parse_line(p, le, t)){
+                    ++st.lines;
+                    if (h.count > 0 && t.time < h.last_ms){
+                        fail(err, "az ido visszalep a(z) " + std::to_string(h.count + 1) + ". ticknel");
+                        ok = false; break;
+                    }
+                    if (h.count == 0){ h.first_ms = t.time; h.first_id = t.id; }
+                    else if (t.id != h.last_id + 1) ++st.id_gaps;
+                    h.last_ms = t.time; h.last_id = t.id;
+                    ++h.count;
+                    tb.push_back(t.time); pb.push_back(t.price); qb.push_back(t.qty); fb.push_back(t.flags);
+                    if (tb.size() == kFlush) flush();
+                } else if (first) st.header = true;     // az első nem üres sor: header
+                else { ++st.lines; ++st.malformed; }
+                first = false;
+            }
+            p = nl? nl + 1 : full_end;
+        }
+        if (eof) break;
+        carry = static_cast<std::size_t>(e - full_end);
+        std::memmove(buf.data(), full_end, carry);
+    }
+    if (!ok) return false;
+    if (h.count == 0){ fail(err, "nincs ertelmezheto sor: " + csv); return false; }
+    flush();
+    // a fájl a teljes (capacity szerinti) méretre nyúlik, akkor is, ha a végén hibás sorok voltak
+    f.seekp(static_cast<std::streamoff>(file_end - 1));
+    f.put('\0');
+    f.seekp(0);
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    if (!f){ fail(err, "irasi hiba: " + out); return false; }
+    if (stats) *stats = st;
+    return true;
+}
+
+bool is_tick_file(const std::string& path){
+    std::ifstream f(path, std::ios::binary);
+    char m[sizeof(kTickFileMagic)]{};
+    return f.read(m, sizeof(m)) && std::memcmp(m, kTickFileMagic, sizeof(m)) == 0;
+}
+
+MappedTicks::MappedTicks(MappedTicks&& o) noexcept { *this = std::move(o); }
+
+MappedTicks& MappedTicks::operator=(MappedTicks&& o) noexcept {
+    if (this == &o) return *this;
+    file_ = std::move(o.file_);
+    hdr_ = o.hdr_; cols_ = o.cols_; err_ = std::move(o.err_);
+    o.hdr_ = nullptr; o.cols_ = {};
+    return *this;
+}
+
+bool MappedTicks::fail(std::string msg){
+    close();
+    err_ = std::move(msg);
+    return false;
+}
+
+void MappedTicks::close(){
+    file_.close();
+    hdr_ = nullptr; cols_ = {};
+}
+
+bool MappedTicks::open(const std::string& path){
+    close();
+    err_.clear();
+    std::string err;
+    if (!file_.open(path, err)) return fail(std::move(err)); // replay: végigolvasás
+    const char* base = file_.data();
+    const std::size_t bytes = file_.size();
+    if (bytes < sizeof(TickFileHeader)) return fail("túl rövid: " + path);
+
+    hdr_ = reinterpret_cast<const TickFileHeader*>(base);
+    const auto& h = *hdr_;
+    if (std::memcmp(h.magic, kTickFileMagic, sizeof(h.magic)) != 0) return fail("nem .ticks fájl: " + path);
+    if (h.version != kTickFileVersion || h.header_bytes != sizeof(TickFileHeader))
+        return fail("nem támogatott .ticks verzió: " + std::to_string(h.version));
+    const std::uint64_t n = h.count, cap = h.capacity;
+    if (n > cap || cap > bytes) return fail("sérült fejléc (count)");
+    for (int k = 0; k < 4; ++k){
+        const auto o = h.col_off[k];
+        if (o % kWidth[k] != 0 || o > bytes || cap * kWidth[k] > bytes - o) return fail("sérült fejléc (oszlop)");
+    }
+
+    cols_.time_ms = {reinterpret_cast<const std::int64_t*>(base + h.col_off[0]), n};
+    cols_.price = {reinterpret_cast<const double*>(base + h.col_off[1]), n};
+    cols_.qty = {reinterpret_cast<const double*>(base + h.col_off[2]), n};
+    cols_.flags = {reinterpret_cast<const std::uint8_t*>(base + h.col_off[3]), n};
+    if (n > 0 && (cols_.time_ms.front() != h.first_ms || cols_.time_ms.back() != h.last_ms))
+        return fail("sérült fájl (időbélyegek)");
+    return true;
+}
+
+void MappedTicks::release(std::size_t upto) const {
+    if (!hdr_) return;
+    upto = std::min(upto, size());
+    for (int k = 0; k < 4; ++k) file_.release(hdr_->col_off[k], upto * kWidth[k]);
+}
+
+} // namespace data
@@ -6,6 +6,7 @@
 #include <sstream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
 
 using json = nlohmann::json;
 
@@ -36,6 +37,7 @@ static double to_d(const json& j, const char* k){
 BinanceRest::BinanceRest(ApiConfig cfg) : cfg_(std::move(cfg)) {}
 
 std::string BinanceRest::rest_base() const {
+    if (!cfg_.base_url.empty()) return cfg_.base_url;
     return cfg_.testnet? "https://testnet.binance.vision" : "https://api.binance.com";
 }
 
@@ -63,8 +65,6 @@ json BinanceRest::http_get(const std::string& path, const std::string& query, bo
         q += "&signature="+sig;
     }
     cpr::Header hdr = {{"X-MBX-APIKEY", cfg_.api_key}};
-    auto req = cpr::Get(cpr::Url{url}, cpr::Parameters{}, cpr::Header{signed_req?hdr: cpr::Header{}}, cpr::Parameters{{}}, cpr::Timeout{cfg_.timeout_ms}, cpr::Parameters{}, cpr::Parameters{}, cpr::Body{}, cpr::Proxies{}, cpr::VerifySsl{true});
-    // cpr nem a legszebb itt; egyszerűbb:
     cpr::Response r;
 if (!q.empty())
     r = cpr::Get(cpr::Url{url + "?" + q},
@@ -191,6 +191,46 @@ OcoResult BinanceRest::oco_sell_bracket(const std::string& symbol, double base_q
     return out;
 }
 
+std::vector<Bar> parse_klines(const json& j, std::int64_t now){
+    std::vector<Bar> v;
+    if (!j.is_array()) return v;
+    v.reserve(j.size());
+    auto num = [](const json& x){
+        if (x.is_string()) return std::strtod(x.get_ref<const std::string&>().c_str(), nullptr);
+        return x.is_number()? x.get<double>() : 0.0;
+    };
+    for (const auto& k : j){
+        // [openTime, "open", "high", "low", "close", "volume", closeTime, ...]
+        if (!k.is_array() || k.size()<7 || !k[0].is_number() || !k[6].is_number()) continue;
+        if (now>0 && k[6].get<std::int64_t>()>=now) continue;
+        v.push_back({k[0].get<std::int64_t>(), num(k[1]), num(k[2]), num(k[3]), num(k[4]), num(k[5])});
+    }
+    return v;
+}
+
+std::vector<Bar> BinanceRest::klines(const std::string& symbol, const std::string& interval,
+                                     std::size_t limit, std::int64_t end_time_ms){
+    constexpr std::size_t kPage = 1000; // Binance max limit
+    const std::int64_t now = static_cast<std::int64_t>(now_ms());
+    std::vector<Bar> out; // visszafelé gyűjtött lapok, a végén időrendbe fordítjuk
+    std::int64_t end = end_time_ms;
+    while (out.size()<limit){
+        // +1: a nyitott kline is benne lehet, amit parse_klines eldob
+        const std::size_t n = std::min(kPage, limit-out.size()+1);
+        std::string q = "symbol="+symbol+"&interval="+interval+"&limit="+std::to_string(n);
+        if (end>0) q += "&endTime="+std::to_string(end);
+        auto page = parse_klines(http_get("/api/v3/klines", q), now);
+        if (page.empty()) break;
+        const std::size_t take = std::min(page.size(), limit-out.size());
+        out.insert(out.end(), page.rbegin(), page.rbegin()+static_cast<std::ptrdiff_t>(take));
+        if (page.size()<n-1) break; // elfogyott a history
+        end = page.front().open_time_ms-1;
+    }
+    std::reverse(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end(), [](const Bar& a, const Bar& b){ return a.open_time_ms==b.open_time_ms; }), out.end());
+    return out;
+}
+
 std::vector<OrderInfo> BinanceRest::open_orders(const std::string& symbol){
     auto j = http_get("/api/v3/openOrders", "symbol="+symbol+"&recvWindow=5000", true);
     std::vector<OrderInfo> v;
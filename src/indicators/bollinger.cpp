@@ -1,8 +1,10 @@
 #include "indicators/bollinger.hpp"
+#include "indicators/kernels.hpp"
 #include <cmath>
+#include <vector>
 
 namespace ind {
-BB compute_bb(const std::deque<double>& v, size_t p, double k){
+BB compute_bb(std::span<const double> v, size_t p, double k){
     if (v.size()<p) {
         const double last = v.empty()? 0.0 : v.back();
         return {last, last, last};
@@ -15,16 +17,90 @@ BB compute_bb(const std::deque<double>& v, size_t p, double k){
     const double sd = std::sqrt(std::max(0.0, var/p));
     return {mid, mid + k*sd, mid - k*sd};
 }
-ModuleResult BollModule::on_bar(const Symbol&, Timeframe, const Bar& b){
-    closes.push_back(b.close); if (closes.size()>2000) closes.pop_front();
-    if (closes.size()<warmup_bars()) return {50.0, Signal::Neutral, warmup_bars()};
-    const auto bb = compute_bb(closes, period, k_);
-    const double c = closes.back();
+void BollModule::own_push(double c){
+    if (closes.capacity()<period+1) closes.set_capacity(std::max<size_t>(2000, period+1));
+    closes.push_back(c);
+}
+void BollModule::reanchor(std::span<const double> view){
+    const auto w = view.last(std::min(period, view.size()));
+    st_.anchor(w.begin(), w.end());
+    since_anchor_ = 0; dirty_ = false;
+}
+void BollModule::set_period(size_t p){
+    period = std::max<size_t>(p,1);
+    if (closes.capacity()>0 && closes.capacity()<period+1) closes.set_capacity(period+1);
+    dirty_ = true;
+}
+BB BollModule::bands() const {
+    if (st_.n<period) return {last_, last_, last_};
+    const double sd = std::sqrt(st_.variance());
+    return {st_.mean, st_.mean + k_*sd, st_.mean - k_*sd};
+}
+void BollModule::update(std::span<const double> view){
+    const size_t n = view.size();
+    const double c = view.back();
+    last_ = c;
+    // ha az állapot nem az ablakhoz tartozik (periódusváltás, batch, menet közben csatolt series): újraszámolás
+    if (dirty_ || st_.n!=std::min(n-1, period)) reanchor(view);
+    else if (n-1<period) st_.add(c);
+    else st_.replace(view[n-1-period], c);
+    if (++since_anchor_>=kReanchorEvery) reanchor(view);
+}
+ModuleResult BollModule::step(std::span<const double> view){
+    update(view);
+    if (view.size()<warmup_bars()) return {50.0, Signal::Neutral, warmup_bars()};
+    const double c = view.back();
+    const auto bb = bands();
     double pos = (bb.upper==bb.lower? 0.5 : (c - bb.lower) / (bb.upper - bb.lower));
     pos = std::clamp(pos, 0.0, 1.0);
     const double score = (pos>0.5? pos*100.0 : (1.0-pos)*100.0);
     const Signal s = (pos>0.7? Signal::Short : pos<0.3? Signal::Long : Signal::Neutral);
     return {std::clamp(score,0.0,100.0), s, warmup_bars()};
 }
+ModuleResult BollModule::on_bar(const Symbol&, Timeframe, const Bar& b){
+    own_push(b.close);
+    return step(closes.view());
+}
+ModuleResult BollModule::on_bar(const Symbol&, Timeframe, const BarSeries& series){
+    return step(series.close());
+}
+bool BollModule::serialize(util::BinWriter& w) const {
+    w.put<std::uint64_t>(period); w.put(k_);
+    st_.serialize(w);
+    w.put<std::uint64_t>(since_anchor_); w.put(dirty_); w.put(last_);
+    w.put_span(closes.view()); // üres, ha közös BarSeries-ből olvas
+    return true;
+}
+bool BollModule::deserialize(util::BinReader& r){
+    // a k csak a score-leképezésben szerepel: a mentett értéket visszaállítjuk, a periódusnak egyeznie kell
+    if (r.get<std::uint64_t>()!=period) return false;
+    r.get(k_);
+    st_.deserialize(r);
+    since_anchor_ = r.get<std::uint64_t>(); r.get(dirty_); r.get(last_);
+    const auto c = r.get_vec<double>();
+    closes.clear();
+    for (double x : c) own_push(x);
+    return r.ok();
+}
+void BollModule::on_bars(const Symbol&, Timeframe, const BarColumns& cols, std::span<double> out){
+    const size_t m = cols.size();
+    if (m==0) return;
+    // ugyanaz a gördülő RollingStats frissítés (és anchor-ütemezés), mint on_bar-ban, így a batch és
+    // a streaming score bitre azonos; a score-leképezés megy SIMD-del
+    if (batch_mid_.size()<m){ batch_mid_.resize(m); batch_sd_.resize(m); }
+    const std::span<double> mid(batch_mid_.data(), m), sd(batch_sd_.data(), m);
+    const size_t w = warmup_bars();
+    size_t cold = 0;
+    for (size_t i=0;i<m;++i){
+        own_push(cols.close[i]);
+        update(closes.view());
+        if (closes.size()<w) cold = i+1;
+        const bool full = st_.n>=period;   // bands(): az ablak feltöltéséig a sáv a záróár
+        mid[i] = full? st_.mean : last_;
+        sd[i]  = full? std::sqrt(st_.variance()) : 0.0;
+    }
+    kernels::bb_score(cols.close, mid, sd, k_, out.first(m));
+    std::fill(out.begin(), out.begin()+cold, 50.0);
+}
 } // namespace ind
 // bollinger.cpp from canvas
@@ -0,0 +1,220 @@
+#include "indicators/kernels.hpp"
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define IND_KERNELS_X86 1
+  #include <immintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #endif
+#endif
+
+namespace ind::kernels {
+
+// ---- skalár (mindig elérhető; a SIMD változatok maradékát is ez számolja)
+namespace scalar_impl {
+struct V { double v; };
+using M = bool;
+constexpr std::size_t W = 1;
+inline V load(const double* p){ return {*p}; }
+inline void store(double* p, V a){ *p = a.v; }
+inline V set1(double x){ return {x}; }
+inline V add(V a, V b){ return {a.v + b.v}; }
+inline V sub(V a, V b){ return {a.v - b.v}; }
+inline V mul(V a, V b){ return {a.v * b.v}; }
+inline V div(V a, V b){ return {a.v / b.v}; }
+inline V vmax(V a, V b){ return {std::max(a.v, b.v)}; }
+inline V vmin(V a, V b){ return {std::min(a.v, b.v)}; }
+inline V vabs(V a){ return {std::abs(a.v)}; }
+inline V vsqrt(V a){ return {std::sqrt(a.v)}; }
+inline M gt(V a, V b){ return a.v > b.v; }
+inline M lt(V a, V b){ return a.v < b.v; }
+inline M eq(V a, V b){ return a.v == b.v; }
+inline M mand(M a, M b){ return a && b; }
+inline V select(M m, V a, V b){ return m? a : b; }
+#include "kernels_impl.inl"
+} // namespace scalar_impl
+
+#if IND_KERNELS_X86
+// ---- SSE2 (x86-64 alapkészlet)
+namespace sse2_impl {
+struct V { __m128d v; };
+struct M { __m128d v; };
+constexpr std::size_t W = 2;
+inline V load(const double* p){ return {_mm_loadu_pd(p)}; }
+inline void store(double* p, V a){ _mm_storeu_pd(p, a.v); }
+inline V set1(double x){ return {_mm_set1_pd(x)}; }
+inline V add(V a, V b){ return {_mm_add_pd(a.v, b.v)}; }
+inline V sub(V a, V b){ return {_mm_sub_pd(a.v, b.v)}; }
+inline V mul(V a, V b){ return {_mm_mul_pd(a.v, b.v)}; }
+inline V div(V a, V b){ return {_mm_div_pd(a.v, b.v)}; }
+inline V vmax(V a, V b){ return {_mm_max_pd(a.v, b.v)}; }
+inline V vmin(V a, V b){ return {_mm_min_pd(a.v, b.v)}; }
+inline V vabs(V a){ return {_mm_andnot_pd(_mm_set1_pd(-0.0), a.v)}; }
+inline V vsqrt(V a){ return {_mm_sqrt_pd(a.v)}; }
+inline M gt(V a, V b){ return {_mm_cmpgt_pd(a.v, b.v)}; }
+inline M lt(V a, V b){ return {_mm_cmplt_pd(a.v, b.v)}; }
+inline M eq(V a, V b){ return {_mm_cmpeq_pd(a.v, b.v)}; }
+inline M mand(M a, M b){ return {_mm_and_pd(a.v, b.v)}; }
+inline V select(M m, V a, V b){ return {_mm_or_pd(_mm_and_pd(m.v, a.v), _mm_andnot_pd(m.v, b.v))}; }
+#include "kernels_impl.inl"
+} // namespace sse2_impl
+
+// ---- AVX2 (csak a függvények kapnak AVX2 célt; a TU többi része marad alap x86-64)
+#if defined(__clang__)
+  #pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+  #pragma GCC push_options
+  #pragma GCC target("avx2")
+#endif
+namespace avx2_impl {
+struct V { __m256d v; };
+struct M { __m256d v; };
+constexpr std::size_t W = 4;
+inline V load(const double* p){ return {_mm256_loadu_pd(p)}; }
+inline void store(double* p, V a){ _mm256_storeu_pd(p, a.v); }
+inline V set1(double x){ return {_mm256_set1_pd(x)}; }
+inline V add(V a, V b){ return {_mm256_add_pd(a.v, b.v)}; }
+inline V sub(V a, V b){ return {_mm256_sub_pd(a.v, b.v)}; }
+inline V mul(V a, V b){ return {_mm256_mul_pd(a.v, b.v)}; }
+inline V div(V a, V b){ return {_mm256_div_pd(a.v, b.v)}; }
+inline V vmax(V a, V b){ return {_mm256_max_pd(a.v, b.v)}; }
+inline V vmin(V a, V b){ return {_mm256_min_pd(a.v, b.v)}; }
+inline V vabs(V a){ return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+inline V vsqrt(V a){ return {_mm256_sqrt_pd(a.v)}; }
+inline M gt(V a, V b){ return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)}; }
+inline M lt(V a, V b){ return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)}; }
+inline M eq(V a, V b){ return {_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)}; }
+inline M mand(M a, M b){ return {_mm256_and_pd(a.v, b.v)}; }
+inline V select(M m, V a, V b){ return {_mm256_blendv_pd(b.v, a.v, m.v)}; }
+#include "kernels_impl.inl"
+} // namespace avx2_impl
+#if defined(__clang__)
+  #pragma clang attribute pop
+#elif defined(__GNUC__)
+  #pragma GCC pop_options
+#endif
+#endif // IND_KERNELS_X86
+
+// ---- futásidejű választás
+static bool cpu_has_avx2(){
+#if IND_KERNELS_X86
+  #if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuid(r, 0); if (r[0] < 7) return false;
+    __cpuid(r, 1);
+    const bool osxsave = (r[2] & (1 << 27)) != 0, avx = (r[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 6) != 6) return false;   // YMM állapotot az OS menti
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+  #else
+    return __builtin_cpu_supports("avx2");
+  #endif
+#else
+    return false;
+#endif
+}
+
+static Isa detect_isa(){
+#if IND_KERNELS_X86
+    return cpu_has_avx2()? Isa::AVX2 : Isa::SSE2;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+static std::atomic<Isa>& current_isa(){
+    static std::atomic<Isa> isa{detect_isa()};
+    return isa;
+}
+
+Isa active_isa(){ return current_isa().load(std::memory_order_relaxed); }
+
+const char* isa_name(Isa i){
+    switch (i){
+        case Isa::AVX2: return "AVX2";
+        case Isa::SSE2: return "SSE2";
+        default:        return "scalar";
+    }
+}
+
+void force_isa(Isa i){
+    const Isa best = detect_isa();
+    if (static_cast<int>(i) > static_cast<int>(best)) i = best;
+    current_isa().store(i, std::memory_order_relaxed);
+}
+
+#if IND_KERNELS_X86
+  #define IND_DISPATCH(fn, ...)                                       \
+    switch (active_isa()){                                            \
+        case Isa::AVX2: avx2_impl::fn(__VA_ARGS__); break;            \
+        case Isa::SSE2: sse2_impl::fn(__VA_ARGS__); break;            \
+        default:        scalar_impl::fn(__VA_ARGS__); break;          \
+    }
+#else
+  #define IND_DISPATCH(fn, ...) scalar_impl::fn(__VA_ARGS__);
+#endif
+
+void sma_series(std::span<const double> x, std::size_t p, std::size_t first, std::span<double> out){
+    if (p == 0 || first + 1 < p) return;
+    IND_DISPATCH(sma_series_impl, x.data(), x.size(), p, first, out.data());
+}
+
+void bb_series(std::span<const double> x, std::size_t p, std::size_t first,
+               std::span<double> mid, std::span<double> sd){
+    if (p == 0 || first + 1 < p) return;
+    IND_DISPATCH(bb_series_impl, x.data(), x.size(), p, first, mid.data(), sd.data());
+}
+
+void rsi_window_series(std::span<const double> x, std::size_t p, std::size_t first, std::span<double> out){
+    if (p == 0 || first < p) return;
+    IND_DISPATCH(rsi_window_series_impl, x.data(), x.size(), p, first, out.data());
+}
+
+void ema_step(std::span<double> state, std::span<const double> x, double k){
+    IND_DISPATCH(ema_step_impl, state.data(), x.data(), std::min(state.size(), x.size()), k);
+}
+
+void wilder_step(std::span<double> prev, std::span<double> avg_gain, std::span<double> avg_loss,
+                 std::span<const double> x, std::size_t p){
+    IND_DISPATCH(wilder_step_impl, prev.data(), avg_gain.data(), avg_loss.data(), x.data(), x.size(), static_cast<double>(p));
+}
+
+void rsi_from_gain_loss(std::span<const double> avg_gain, std::span<const double> avg_loss, std::span<double> out){
+    IND_DISPATCH(rsi_from_gain_loss_impl, avg_gain.data(), avg_loss.data(), avg_gain.size(), out.data());
+}
+
+void ema_cross_score(std::span<const double> fast, std::span<const double> slow, std::span<double> out){
+    IND_DISPATCH(ema_cross_score_impl, fast.data(), slow.data(), std::min(fast.size(), slow.size()), out.data());
+}
+
+void rsi_score(std::span<const double> rsi, std::span<double> out){
+    IND_DISPATCH(rsi_score_impl, rsi.data(), rsi.size(), out.data());
+}
+
+void bb_score(std::span<const double> close, std::span<const double> mid, std::span<const double> sd,
+              double k, std::span<double> out){
+    IND_DISPATCH(bb_score_impl, close.data(), mid.data(), sd.data(), close.size(), k, out.data());
+}
+
+void combine_score_rows(std::span<const double* const> rows, std::size_t n, std::span<const double> w, std::span<double> out){
+    const std::size_t m = std::min(w.size(), rows.size());
+    double sumw = 0.0;
+    for (std::size_t k = 0; k < m; ++k) sumw += w[k];
+    IND_DISPATCH(combine_scores_impl, rows.data(), 0, std::min(n, out.size()), w.data(), m, sumw, out.data());
+}
+
+void combine_scores(std::span<const double> scores, std::size_t n, std::span<const double> w, std::span<double> out){
+    if (n == 0) return;
+    std::vector<const double*> rows(std::min(w.size(), scores.size() / n));
+    for (std::size_t k = 0; k < rows.size(); ++k) rows[k] = scores.data() + k*n;
+    combine_score_rows(rows, n, w, out);
+}
+
+#undef IND_DISPATCH
+
+} // namespace ind::kernels
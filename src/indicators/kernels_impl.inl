@@ -0,0 +1,138 @@
+// Kernel törzsek – a kernels.cpp-ből include-oljuk ISA-nként külön névtérbe (scalar / SSE2 / AVX2).
+// Elvárt környezet: V (vektor), M (maszk), W (lane-szám) és a műveletek:
+// load/store/set1/add/sub/mul/div/vmax/vmin/vabs/vsqrt/gt/lt/eq/mand/select.
+// A W-nél rövidebb maradékot a skalár változat számolja.
+// Nem include-olunk semmit: a fájl névtér belsejében landol.
+
+inline V clamp_v(V x, double lo, double hi){ return vmin(vmax(x, set1(lo)), set1(hi)); }
+
+// rsi_from_gain_loss vektorosan
+inline V rsi_from_v(V g, V l){
+    const V zero = set1(0.0);
+    const M lz = eq(l, zero);
+    const V rs = select(lz, set1(1000.0), div(g, l));
+    const V rsi = clamp_v(sub(set1(100.0), div(set1(100.0), add(set1(1.0), rs))), 0.0, 100.0);
+    return select(mand(eq(g, zero), lz), set1(50.0), rsi);
+}
+
+void sma_series_impl(const double* x, std::size_t n, std::size_t p, std::size_t first, double* out){
+    if (first >= n) return;
+    const V vp = set1(static_cast<double>(p));
+    std::size_t i = first;
+    for (; i + W <= n; i += W){
+        V s = set1(0.0);
+        for (std::size_t j = 0; j < p; ++j) s = add(s, load(x + i + 1 - p + j));
+        store(out + (i - first), div(s, vp));
+    }
+    if (i < n) scalar_impl::sma_series_impl(x, n, p, i, out + (i - first));
+}
+
+void bb_series_impl(const double* x, std::size_t n, std::size_t p, std::size_t first, double* mid, double* sd){
+    if (first >= n) return;
+    const V vp = set1(static_cast<double>(p));
+    std::size_t i = first;
+    for (; i + W <= n; i += W){
+        const double* w = x + i + 1 - p;
+        V m = set1(0.0);
+        for (std::size_t j = 0; j < p; ++j) m = add(m, load(w + j));
+        m = div(m, vp);
+        V var = set1(0.0);
+        for (std::size_t j = 0; j < p; ++j){ const V d = sub(load(w + j), m); var = add(var, mul(d, d)); }
+        store(mid + (i - first), m);
+        store(sd + (i - first), vsqrt(vmax(set1(0.0), div(var, vp))));
+    }
+    if (i < n) scalar_impl::bb_series_impl(x, n, p, i, mid + (i - first), sd + (i - first));
+}
+
+void rsi_window_series_impl(const double* x, std::size_t n, std::size_t p, std::size_t first, double* out){
+    if (first >= n) return;
+    const V zero = set1(0.0);
+    std::size_t i = first;
+    for (; i + W <= n; i += W){
+        V g = zero, l = zero;
+        for (std::size_t j = 0; j < p; ++j){
+            const double* c = x + i + 1 - p + j;
+            const V d = sub(load(c), load(c - 1));
+            g = add(g, vmax(d, zero));
+            l = add(l, vmax(sub(zero, d), zero));
+        }
+        store(out + (i - first), rsi_from_v(g, l));
+    }
+    if (i < n) scalar_impl::rsi_window_series_impl(x, n, p, i, out + (i - first));
+}
+
+// ---- szimbólumok közötti (keresztmetszeti) lépések: minden lane egy másik szimbólum
+
+// e[i] = x[i]*k + e[i]*(1-k)   (seedelt állapotokra)
+void ema_step_impl(double* e, const double* x, std::size_t n, double k){
+    const V vk = set1(k), vk1 = set1(1.0 - k);
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) store(e + i, add(mul(load(x + i), vk), mul(load(e + i), vk1)));
+    if (i < n) scalar_impl::ema_step_impl(e + i, x + i, n - i, k);
+}
+
+// Wilder-simítás (seedelt állapotokra): prev, átlag nyereség/veszteség helyben frissül
+void wilder_step_impl(double* prev, double* ag, double* al, const double* x, std::size_t n, double p){
+    const V zero = set1(0.0), vp = set1(p), vp1 = set1(p - 1.0);
+    std::size_t i = 0;
+    for (; i + W <= n; i += W){
+        const V c = load(x + i);
+        const V d = sub(c, load(prev + i));
+        store(ag + i, div(add(mul(load(ag + i), vp1), vmax(d, zero)), vp));
+        store(al + i, div(add(mul(load(al + i), vp1), vmax(sub(zero, d), zero)), vp));
+        store(prev + i, c);
+    }
+    if (i < n) scalar_impl::wilder_step_impl(prev + i, ag + i, al + i, x + i, n - i, p);
+}
+
+void rsi_from_gain_loss_impl(const double* g, const double* l, std::size_t n, double* out){
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) store(out + i, rsi_from_v(load(g + i), load(l + i)));
+    if (i < n) scalar_impl::rsi_from_gain_loss_impl(g + i, l + i, n - i, out + i);
+}
+
+void ema_cross_score_impl(const double* fast, const double* slow, std::size_t n, double* out){
+    std::size_t i = 0;
+    for (; i + W <= n; i += W){
+        const V f = load(fast + i), s = load(slow + i);
+        const V norm = select(gt(vabs(s), set1(1e-12)), div(sub(f, s), s), set1(0.0));
+        store(out + i, clamp_v(add(set1(50.0), mul(norm, set1(5000.0))), 0.0, 100.0));
+    }
+    if (i < n) scalar_impl::ema_cross_score_impl(fast + i, slow + i, n - i, out + i);
+}
+
+void rsi_score_impl(const double* rsi, std::size_t n, double* out){
+    std::size_t i = 0;
+    for (; i + W <= n; i += W){
+        const V r = load(rsi + i);
+        const V s = select(gt(r, set1(70.0)), r, select(lt(r, set1(30.0)), sub(set1(100.0), r), set1(50.0)));
+        store(out + i, clamp_v(s, 0.0, 100.0));
+    }
+    if (i < n) scalar_impl::rsi_score_impl(rsi + i, n - i, out + i);
+}
+
+void combine_scores_impl(const double* const* rows, std::size_t off, std::size_t n,
+                         const double* w, std::size_t m, double sumw, double* out){
+    const V h = set1(100.0);
+    std::size_t i = 0;
+    for (; i + W <= n; i += W){
+        V acc = set1(0.0);
+        for (std::size_t k = 0; k < m; ++k) acc = add(acc, mul(set1(w[k]), div(load(rows[k] + off + i), h)));
+        store(out + i, mul(sumw > 0 ? div(acc, set1(sumw)) : set1(0.5), h));
+    }
+    if (i < n) scalar_impl::combine_scores_impl(rows, off + i, n - i, w, m, sumw, out + i);
+}
+
+void bb_score_impl(const double* close, const double* mid, const double* sd, std::size_t n, double k, double* out){
+    const V vk = set1(k);
+    std::size_t i = 0;
+    for (; i + W <= n; i += W){
+        const V m = load(mid + i), ksd = mul(vk, load(sd + i));
+        const V up = add(m, ksd), lo = sub(m, ksd);
+        V pos = select(eq(up, lo), set1(0.5), div(sub(load(close + i), lo), sub(up, lo)));
+        pos = clamp_v(pos, 0.0, 1.0);
+        const V s = select(gt(pos, set1(0.5)), mul(pos, set1(100.0)), mul(sub(set1(1.0), pos), set1(100.0)));
+        store(out + i, clamp_v(s, 0.0, 100.0));
+    }
+    if (i < n) scalar_impl::bb_score_impl(close + i, mid + i, sd + i, n - i, k, out + i);
+}
@@ -0,0 +1,158 @@
+#include "indicators/multi_engine.hpp"
+#include "indicators/kernels.hpp"
+#include "indicators/rsi.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ind {
+
+MultiSymbolEngine::MultiSymbolEngine(std::size_t n_symbols, MultiEngineConfig cfg)
+    : n_(n_symbols), cfg_(cfg) {
+    cfg_.rsi_period = std::max<std::size_t>(cfg_.rsi_period, 1);
+    cfg_.bb_period  = std::max<std::size_t>(cfg_.bb_period, 1);
+    k_short_ = 2.0/(cfg_.ema_short+1.0);
+    k_long_  = 2.0/(cfg_.ema_long+1.0);
+    // ugyanazok a warmup-ok, mint a moduloknál
+    w_sma_  = std::max(cfg_.ema_short, cfg_.ema_long) + 5;
+    w_rsi_  = std::max<std::size_t>(cfg_.rsi_period+1, 20);
+    w_bb_   = cfg_.bb_period + 5;
+    bb_cap_ = std::max<std::size_t>(2000, cfg_.bb_period+1);
+
+    bars_.assign(n_, 0);
+    ema_s_.assign(n_, 0.0); ema_l_.assign(n_, 0.0);
+    rsi_prev_.assign(n_, 0.0); rsi_ag_.assign(n_, 0.0); rsi_al_.assign(n_, 0.0);
+    bb_win_.assign(n_*cfg_.bb_period, 0.0);
+    bb_mean_.assign(n_, 0.0); bb_m2_.assign(n_, 0.0); bb_since_.assign(n_, 0);
+    tmp_sma_.assign(n_, 0.0); tmp_rsi_.assign(n_, 0.0);
+}
+
+void MultiSymbolEngine::reset(){
+    std::fill(bars_.begin(), bars_.end(), 0);
+    std::fill(ema_s_.begin(), ema_s_.end(), 0.0); std::fill(ema_l_.begin(), ema_l_.end(), 0.0);
+    std::fill(rsi_prev_.begin(), rsi_prev_.end(), 0.0);
+    std::fill(rsi_ag_.begin(), rsi_ag_.end(), 0.0); std::fill(rsi_al_.begin(), rsi_al_.end(), 0.0);
+    std::fill(bb_win_.begin(), bb_win_.end(), 0.0);
+    std::fill(bb_mean_.begin(), bb_mean_.end(), 0.0); std::fill(bb_m2_.begin(), bb_m2_.end(), 0.0);
+    std::fill(bb_since_.begin(), bb_since_.end(), 0);
+}
+
+// ---- Bollinger: RollingStats-szal azonos lépések, szimbólumonkénti gyűrűn
+void MultiSymbolEngine::reanchor_bb(std::size_t s){
+    const std::size_t p = cfg_.bb_period, b = bars_[s] + 1;   // a frissen betett barral együtt
+    const std::size_t cnt = std::min<std::size_t>(b, p);
+    const std::size_t oldest = (b<=p? 0 : b % p);
+    const double* w = bb_win_.data() + s*p;
+    double mean = 0.0, m2 = 0.0;
+    for (std::size_t i=0;i<cnt;++i) mean += w[(oldest+i)%p];
+    mean /= static_cast<double>(cnt);
+    for (std::size_t i=0;i<cnt;++i){ const double d = w[(oldest+i)%p]-mean; m2 += d*d; }
+    bb_mean_[s] = mean; bb_m2_[s] = m2; bb_since_[s] = 0;
+}
+
+void MultiSymbolEngine::update_bb(std::size_t s, double x){
+    const std::size_t p = cfg_.bb_period;
+    const std::uint64_t b = bars_[s];
+    double& slot = bb_win_[s*p + b % p];
+    if (b < p){
+        const double n = static_cast<double>(b+1);
+        const double d = x - bb_mean_[s];
+        bb_mean_[s] += d/n;
+        bb_m2_[s]   += d*(x - bb_mean_[s]);
+    } else {
+        const double x_out = slot, old = bb_mean_[s];
+        bb_mean_[s] += (x - x_out)/static_cast<double>(p);
+        bb_m2_[s]   += (x - x_out)*((x - bb_mean_[s]) + (x_out - old));
+        if (bb_m2_[s] < 0.0) bb_m2_[s] = 0.0;
+    }
+    slot = x;
+    if (++bb_since_[s] >= kReanchorEvery) reanchor_bb(s);
+}
+
+void MultiSymbolEngine::update_one(std::size_t s, double x){
+    const std::uint64_t b = bars_[s];
+    const double p = static_cast<double>(cfg_.rsi_period);
+    if (b==0){
+        ema_s_[s] = x; ema_l_[s] = x;
+        rsi_prev_[s] = x;
+    } else {
+        ema_s_[s] = x*k_short_ + ema_s_[s]*(1.0-k_short_);
+        ema_l_[s] = x*k_long_  + ema_l_[s]*(1.0-k_long_);
+        const double d = x - rsi_prev_[s]; rsi_prev_[s] = x;
+        const double g = (d>=0? d : 0.0), l = (d<0? -d : 0.0);
+        if (b <= cfg_.rsi_period){ rsi_ag_[s] += g/p; rsi_al_[s] += l/p; }
+        else {
+            rsi_ag_[s] = (rsi_ag_[s]*(p-1.0) + g)/p;
+            rsi_al_[s] = (rsi_al_[s]*(p-1.0) + l)/p;
+        }
+    }
+    update_bb(s, x);
+    bars_[s] = b+1;
+}
+
+double MultiSymbolEngine::sma_score(std::size_t s) const {
+    const double diff = ema_s_[s] - ema_l_[s];
+    const double norm = (std::abs(ema_l_[s])>1e-12? diff/ema_l_[s] : 0.0);
+    return std::clamp(50.0 + norm*5000.0, 0.0, 100.0);
+}
+
+MultiResult MultiSymbolEngine::result(std::size_t s, double sma_sc, double rsi) const {
+    MultiResult r;
+    const std::uint64_t b = bars_[s];
+    // SMA_EMA
+    if (b < w_sma_) r.sma_ema = {50.0, Signal::Neutral, w_sma_};
+    else {
+        const double diff = ema_s_[s] - ema_l_[s];
+        r.sma_ema = {sma_sc, (diff>0? Signal::Long : diff<0? Signal::Short : Signal::Neutral), w_sma_};
+    }
+    // RSI
+    if (b < w_rsi_) r.rsi = {50.0, Signal::Neutral, w_rsi_};
+    else {
+        const double score = (rsi>70? rsi : rsi<30? (100-rsi) : 50.0);
+        r.rsi = {std::clamp(score, 0.0, 100.0), (rsi>70? Signal::Short : rsi<30? Signal::Long : Signal::Neutral), w_rsi_};
+    }
+    // BOLL
+    if (std::min<std::uint64_t>(b, bb_cap_) < w_bb_) r.boll = {50.0, Signal::Neutral, w_bb_};
+    else {
+        const std::size_t cnt = std::min<std::size_t>(b, cfg_.bb_period);
+        const double sd = std::sqrt(std::max(0.0, bb_m2_[s]/static_cast<double>(cnt)));
+        const double up = bb_mean_[s] + cfg_.bb_k*sd, lo = bb_mean_[s] - cfg_.bb_k*sd;
+        const double c = bb_win_[s*cfg_.bb_period + (b-1) % cfg_.bb_period];
+        double pos = (up==lo? 0.5 : (c - lo) / (up - lo));
+        pos = std::clamp(pos, 0.0, 1.0);
+        const double score = (pos>0.5? pos*100.0 : (1.0-pos)*100.0);
+        r.boll = {std::clamp(score, 0.0, 100.0), (pos>0.7? Signal::Short : pos<0.3? Signal::Long : Signal::Neutral), w_bb_};
+    }
+    return r;
+}
+
+void MultiSymbolEngine::step(std::span<const std::uint32_t> sym, std::span<const double> closes, std::span<MultiResult> out){
+    for (std::size_t i=0;i<sym.size();++i){
+        const std::size_t s = sym[i];
+        update_one(s, closes[i]);
+        const double rsi = (bars_[s] <= cfg_.rsi_period? 50.0 : rsi_from_gain_loss(rsi_ag_[s], rsi_al_[s]));
+        out[i] = result(s, sma_score(s), rsi);
+    }
+}
+
+void MultiSymbolEngine::step_all(std::span<const double> closes, std::span<MultiResult> out){
+    if (n_==0) return;
+    // a vektoros út csak akkor, ha minden szimbólum túl van az EMA/RSI seedelésen
+    const bool seeded = (*std::min_element(bars_.begin(), bars_.end()) > cfg_.rsi_period);
+    if (seeded){
+        kernels::ema_step(ema_s_, closes, k_short_);
+        kernels::ema_step(ema_l_, closes, k_long_);
+        kernels::wilder_step(rsi_prev_, rsi_ag_, rsi_al_, closes.first(n_), cfg_.rsi_period);
+        for (std::size_t s=0;s<n_;++s){ update_bb(s, closes[s]); ++bars_[s]; }
+        kernels::ema_cross_score(ema_s_, ema_l_, tmp_sma_);
+        kernels::rsi_from_gain_loss(rsi_ag_, rsi_al_, tmp_rsi_);
+    } else {
+        for (std::size_t s=0;s<n_;++s){
+            update_one(s, closes[s]);
+            tmp_sma_[s] = sma_score(s);
+            tmp_rsi_[s] = (bars_[s] <= cfg_.rsi_period? 50.0 : rsi_from_gain_loss(rsi_ag_[s], rsi_al_[s]));
+        }
+    }
+    for (std::size_t s=0;s<n_;++s) out[s] = result(s, tmp_sma_[s], tmp_rsi_[s]);
+}
+
+} // namespace ind
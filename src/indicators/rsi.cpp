@@ -1,27 +1,87 @@
 #include "indicators/rsi.hpp"
+#include "indicators/kernels.hpp"
 #include <numeric>
 #include <cmath>
+#include <vector>
 
 namespace ind {
-double compute_rsi(const std::deque<double>& c, size_t p){
+double compute_rsi(std::span<const double> c, size_t p){
     if (c.size() <= p) return 50.0;
     double g=0.0,l=0.0;
     for (size_t i=c.size()-p; i<c.size(); ++i){
         const double d = c[i]-c[i-1];
         if (d>=0) g+=d; else l-=d;
     }
-    if (g==0 && l==0) return 50.0;
-    const double rs  = (l==0? 1000.0 : g/l);
-    const double rsi = 100.0 - (100.0/(1.0+rs));
-    return std::clamp(rsi, 0.0, 100.0);
+    return rsi_from_gain_loss(g, l);
+}
+void RsiModule::own_push(double c){
+    if (closes.capacity()==0) closes.reset(std::max<size_t>(2000, period+1));
+    closes.push_back(c);
 }
 ModuleResult RsiModule::on_bar(const Symbol&, Timeframe, const Bar& b){
-    closes.push_back(b.close); if (closes.size()>2000) closes.pop_front();
-    if (closes.size()<warmup_bars()) return {50.0, Signal::Neutral, warmup_bars()};
-    const double rsi = compute_rsi(closes, period);
+    double rsi = 50.0;
+    if (mode==RsiMode::Wilder){
+        rsi = st.update(b.close);
+    } else {
+        own_push(b.close);
+    }
+    if (n<warmup_bars()) ++n;
+    if (n<warmup_bars()) return {50.0, Signal::Neutral, warmup_bars()};
+    if (mode==RsiMode::Window) rsi = compute_rsi(closes.view(), period);
+    return result(rsi);
+}
+ModuleResult RsiModule::on_bar(const Symbol& sym, Timeframe tf, const BarSeries& series){
+    if (mode==RsiMode::Wilder) return on_bar(sym, tf, series.back());
+    const auto v = series.close();
+    if (v.size()<warmup_bars()) return {50.0, Signal::Neutral, warmup_bars()};
+    return result(compute_rsi(v, period));
+}
+bool RsiModule::serialize(util::BinWriter& w) const {
+    w.put<std::uint64_t>(period); w.put<std::uint8_t>(static_cast<std::uint8_t>(mode));
+    w.put<std::uint64_t>(n);
+    st.serialize(w);
+    w.put_span(closes.view()); // üres, ha közös BarSeries-ből olvas vagy Wilder módban fut
+    return true;
+}
+bool RsiModule::deserialize(util::BinReader& r){
+    if (r.get<std::uint64_t>()!=period || r.get<std::uint8_t>()!=static_cast<std::uint8_t>(mode)) return false;
+    n = std::min<size_t>(r.get<std::uint64_t>(), warmup_bars());
+    st.deserialize(r);
+    const auto c = r.get_vec<double>();
+    closes.clear();
+    for (double x : c) own_push(x);
+    return r.ok();
+}
+ModuleResult RsiModule::result(double rsi) const {
     const double score = (rsi>70? rsi : rsi<30? (100-rsi) : 50.0);
     const Signal s = (rsi>70? Signal::Short : rsi<30? Signal::Long : Signal::Neutral);
     return {std::clamp(score, 0.0, 100.0), s, warmup_bars()};
 }
+void RsiModule::on_bars(const Symbol&, Timeframe, const BarColumns& cols, std::span<double> out){
+    const size_t m = cols.size();
+    if (m==0) return;
+    if (batch_rsi.size()<m) batch_rsi.resize(m);
+    const std::span<double> rsi(batch_rsi.data(), m);
+    if (mode==RsiMode::Wilder){
+        for (size_t i=0;i<m;++i) rsi[i] = st.update(cols.close[i]);
+    } else {
+        std::fill(rsi.begin(), rsi.end(), 50.0);
+        // history vége + új záróárak egy összefüggő pufferben, a kernel ablakosan számol
+        const auto hist = closes.last(period);
+        if (batch_x.size()<hist.size()+m) batch_x.resize(hist.size()+m);
+        const std::span<double> x(batch_x.data(), hist.size()+m);
+        std::copy(hist.begin(), hist.end(), x.begin());
+        std::copy(cols.close.begin(), cols.close.end(), x.begin()+hist.size());
+        const size_t first = std::max(hist.size(), period);
+        if (first<x.size())
+            kernels::rsi_window_series(x, period, first, rsi.subspan(first-hist.size()));
+        for (double c : cols.close.last(std::min<size_t>(m, std::max<size_t>(2000, period+1)))) own_push(c);
+    }
+    kernels::rsi_score(rsi, out.first(m));
+    const size_t w = warmup_bars();
+    const size_t cold = (n+1>=w? 0 : std::min(m, w-n-1));
+    std::fill(out.begin(), out.begin()+cold, 50.0);
+    n = std::min(w, n+m);
+}
 } // namespace ind
 // rsi.cpp from canvas
@@ -1,14 +1,16 @@
 #include "indicators/sma_ema.hpp"
+#include "indicators/kernels.hpp"
 #include <numeric>
 #include <cmath>
+#include <vector>
 
 namespace ind {
-double compute_sma(const std::deque<double>& v, size_t p){
+double compute_sma(std::span<const double> v, size_t p){
     if (v.size()<p) return v.empty()?0.0:v.back();
     double s=0; for (size_t i=v.size()-p;i<v.size();++i) s+=v[i];
     return s/static_cast<double>(p);
 }
-double compute_ema(const std::deque<double>& v, size_t p){
+double compute_ema(std::span<const double> v, size_t p){
     if (v.empty()) return 0.0;
     const double k = 2.0/(p+1.0);
     double e = v[0];
@@ -16,15 +18,40 @@ double compute_ema(const std::deque<double>& v, size_t p){
     return e;
 }
 ModuleResult SmaEmaModule::on_bar(const Symbol&, Timeframe, const Bar& b){
-    closes.push_back(b.close); if (closes.size()>2000) closes.pop_front();
-    if (closes.size()<warmup_bars()) return {50.0, Signal::Neutral, warmup_bars()};
-    const double ema_s = compute_ema(closes, short_p);
-    const double ema_l = compute_ema(closes, long_p);
-    const double diff  = ema_s - ema_l;
-    const double norm  = (std::abs(ema_l)>1e-12? diff/ema_l : 0.0);
+    // az EMA-k minden baron frissülnek (warmup alatt is), így nem kell a history
+    const double es = ema_s.update(b.close);
+    const double el = ema_l.update(b.close);
+    if (n<warmup_bars()) ++n;
+    if (n<warmup_bars()) return {50.0, Signal::Neutral, warmup_bars()};
+    const double diff  = es - el;
+    const double norm  = (std::abs(el)>1e-12? diff/el : 0.0);
     const double score = std::clamp(50.0 + norm*5000.0, 0.0, 100.0);
     const Signal s = (diff>0? Signal::Long : diff<0? Signal::Short : Signal::Neutral);
     return {score, s, warmup_bars()};
 }
+bool SmaEmaModule::serialize(util::BinWriter& w) const {
+    w.put<std::uint64_t>(short_p); w.put<std::uint64_t>(long_p); w.put<std::uint64_t>(n);
+    ema_s.serialize(w); ema_l.serialize(w);
+    return true;
+}
+bool SmaEmaModule::deserialize(util::BinReader& r){
+    if (r.get<std::uint64_t>()!=short_p || r.get<std::uint64_t>()!=long_p) return false;
+    n = std::min<size_t>(r.get<std::uint64_t>(), warmup_bars());
+    return ema_s.deserialize(r) && ema_l.deserialize(r);
+}
+void SmaEmaModule::on_bars(const Symbol&, Timeframe, const BarColumns& cols, std::span<double> out){
+    const size_t m = cols.size();
+    if (m==0) return;
+    // az EMA rekurzió szekvenciális; a score-leképezés megy SIMD-del
+    if (batch_s.size()<m){ batch_s.resize(m); batch_l.resize(m); }
+    const std::span<double> es(batch_s.data(), m), el(batch_l.data(), m);
+    for (size_t i=0;i<m;++i){ es[i] = ema_s.update(cols.close[i]); el[i] = ema_l.update(cols.close[i]); }
+    kernels::ema_cross_score(es, el, out.first(m));
+    // warmup: az i. bar után n = min(n0+i+1, w)
+    const size_t w = warmup_bars();
+    const size_t cold = (n+1>=w? 0 : std::min(m, w-n-1));
+    std::fill(out.begin(), out.begin()+cold, 50.0);
+    n = std::min(w, n+m);
+}
 } // namespace ind
 // sma_ema.cpp from canvas
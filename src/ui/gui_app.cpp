@@ -10,7 +10,12 @@
 #include <sstream>
 #include <unordered_map>
 #include <atomic>
+#include <mutex>
 #include <algorithm>
+#include <filesystem>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
 #include "core/module.hpp"   // core::IModule teljes definíciója
 
 #include "indicators/rsi.hpp"
@@ -19,6 +24,17 @@
 #include "indicators/mtfa.hpp"
 #include "data/binance_ws.hpp"
 #include "data/binance_userstream.hpp"
+#include "data/snapshot.hpp"
+#include "data/bar_loader.hpp"
+#include "backtest/engine.hpp"
+#include "backtest/monte_carlo.hpp"
+#include "backtest/portfolio.hpp"
+#include "strategy/grid_search.hpp"
+#include "strategy/optimizer.hpp"
+#include "strategy/param_presets.hpp"
+#include "util/thread_pool.hpp"
+#include "util/job_scheduler.hpp"
+#include "indicators/kernels.hpp"
 #include "util/concurrent_queue.hpp"
 #include "telemetry/telegram_notifier.hpp"
 #include "exec/binance_rest.hpp"
@@ -53,6 +69,13 @@ static Timeframe idx_to_tf(int idx){
     Timeframe map[8] = {Timeframe::M1,Timeframe::M3,Timeframe::M5,Timeframe::M15,Timeframe::M30,Timeframe::H1,Timeframe::H4,Timeframe::D1};
     return map[std::clamp(idx,0,7)];
 }
+// betöltött adatsor bar-hossza Timeframe-ként (az MTF bucket ehhez igazodik); nem szabványosnál M5
+static Timeframe data_timeframe(const BarColumns& cols, const std::string& path){
+    Timeframe tf = Timeframe::M5;
+    if (!backtest::bar_timeframe(cols, tf))
+        spdlog::warn("{}: a bar hossza ({} ms) nem szabvanyos TF, M5-kent szamolva", path, backtest::bar_length_ms(cols));
+    return tf;
+}
 
 struct GuiApp::Impl {
     sf::RenderWindow window{sf::VideoMode(1280, 900), "Crypto Modular Bot (GUI)"};
@@ -64,17 +87,138 @@ struct GuiApp::Impl {
     int tf_idx = 2; // M5
     const char* tf_labels[8] = {"M1","M3","M5","M15","M30","H1","H4","D1"};
 
-    // Modules & decision
+    // Modules & decision (id -> index internálás add_module-ban, utána csak index)
     std::vector<std::unique_ptr<IModule>> modules;
-    Weights weights; Scores scores;
+    std::vector<std::size_t> module_idx; // modules[i] registry-indexe
+    ModuleRegistry registry;
+    DenseWeights weights; DenseScores scores;
     double combined{50.0};
     Signal last_action{Signal::Neutral};
 
     // Market data (kline + last price)
     std::unique_ptr<BinanceWsClient> ws;
     util::ConcurrentQueue<Bar> bar_q;
+    BarStore bars; // közös (Symbol, TF) history, a modulok ebből olvasnak
     std::atomic<double> last_price{0.0};
 
+    // Állapot-snapshot (gyors újraindítás): indításkor/symbol-TF váltáskor betölt, időnként ment
+    std::string snap_dir{"snapshots"};
+    double snap_sec{60.0};
+    Clock::time_point last_snap{Clock::now()};
+    bool snap_dirty{false};
+    std::string snap_msg;
+
+    void save_snapshot(){
+        if (!snap_dirty) return;
+        std::error_code ec; std::filesystem::create_directories(snap_dir, ec);
+        const auto* ser = bars.find(sym, cfg.tf);
+        if (ser && data::save_snapshot(data::snapshot_path(snap_dir, sym, cfg.tf), sym, cfg.tf, *ser, modules)){
+            snap_dirty = false;
+            snap_msg = fmt::format("saved {} bars", ser->size());
+        }
+        last_snap = Clock::now();
+    }
+    void load_snapshot(){
+        auto& ser = bars.series(sym, cfg.tf);
+        const auto info = data::load_snapshot(data::snapshot_path(snap_dir, sym, cfg.tf), sym, cfg.tf, ser, modules);
+        if (!info){
+            for (auto& m : modules) m->reset();
+            ser.clear();
+            snap_msg = "no snapshot";
+            return;
+        }
+        snap_msg = fmt::format("restored {}/{} modules, {} bars", info->restored, modules.size(), info->bars);
+        spdlog::info("snapshot {}@{}: {}", sym.name(), tf_to_str(cfg.tf), snap_msg);
+    }
+
+    // Induló history REST klinekből: a letöltés a warm_jobs workerén fut, az eredményt a render szál
+    // alkalmazza (apply_warmup). Addig a WS barjai a bar_q-ban várnak, utána a bar loop a REST-tel
+    // átfedőket eldobja. A series vége utáni lezárt barok egy batch-ben mennek a modulokba (on_bars).
+    // Ha a snapshot vége és a REST ablak között hiány van, tisztán a REST ablakból indulunk.
+    int warm_bars{1000};
+    char rest_base_buf[128] = "";   // üres: api.binance.com; teszthez helyi stand-in URL
+    std::string warm_msg;
+    bool warm_pending{false};       // letöltés folyamatban: a bar loop nem fogyaszt
+    std::uint64_t warm_gen{0};      // symbol/TF váltáskor nő; a régi letöltés eredménye eldobódik
+    std::uint64_t warm_job{0};
+
+    // A series-ablakból dolgozó modulok (history_bars() > 1: Boll, ablakos RSI) a saját history-jukat
+    // nem mentik (élőben a közös series-ből olvasnak), így snapshot után a batch út (on_bars) üres
+    // ablakról indulna. Az állapotuk az ablak függvénye: a visszatöltött series-ből újraépítjük, és a
+    // score-juk is innen jön. A rekurzív állapotú modulok (EMA, Wilder, MTF) a snapshotból folytatnak.
+    void replay_series_window(){
+        const auto* ser = bars.find(sym, cfg.tf);
+        if (!ser || ser->empty()) return;
+        const BarColumns cols = ser->columns();
+        std::vector<double> out(cols.size());
+        for (std::size_t i=0;i<modules.size();++i){
+            if (modules[i]->history_bars() <= 1) continue;
+            modules[i]->reset();
+            modules[i]->on_bars(sym, cfg.tf, cols, out);
+            scores.s[module_idx[i]] = out.back();
+        }
+        const auto d = decide(scores, weights, cfg.thr_long, cfg.thr_short);
+        combined = d.combined_score; last_action = d.action;
+    }
+
+    void warmup_from_rest(){
+        const std::uint64_t gen = ++warm_gen;
+        warm_pending = true;
+        warm_msg = "REST: loading...";
+        exec::ApiConfig c; c.testnet = false; c.base_url = rest_base_buf; // piaci adat: éles, nyilvános végpont
+        const std::string name = sym.name(), interval = tf_to_str(cfg.tf);
+        const std::size_t n = static_cast<std::size_t>(std::max(warm_bars, 0));
+        warm_jobs.cancel(warm_job);     // még el sem indult: ki se menjen
+        warm_jobs.clear_finished();
+        warm_job = warm_jobs.submit(fmt::format("Warm-up {}@{}", name, interval),
+                         [impl = this, gen, c, name, interval, n](util::JobControl&) -> util::JobScheduler::Apply {
+            std::vector<Bar> v; std::string err;
+            try { v = exec::BinanceRest(c).klines(name, interval, n); }
+            catch (const std::exception& e){ err = e.what(); }
+            return [impl, gen, v = std::move(v), err = std::move(err)]{
+                if (gen != impl->warm_gen) return;   // közben symbol/TF váltás volt
+                impl->warm_pending = false;
+                if (!err.empty()){
+                    impl->replay_series_window();
+                    impl->warm_msg = "REST: " + err;
+                    spdlog::warn("warm-up {}@{}: {}", impl->sym.name(), tf_to_str(impl->cfg.tf), err);
+                    return;
+                }
+                impl->apply_warmup(v);
+            };
+        });
+    }
+
+    void apply_warmup(const std::vector<Bar>& v){
+        auto& ser = bars.series(sym, cfg.tf);
+        const std::int64_t last = ser.empty()? INT64_MIN : ser.back().open_time_ms;
+        auto first = std::find_if(v.begin(), v.end(), [&](const Bar& b){ return b.open_time_ms > last; });
+        if (first==v.end()){
+            replay_series_window();
+            warm_msg = fmt::format("REST: 0 new of {}", v.size());
+            return;
+        }
+        if (!ser.empty() && first->open_time_ms > last + tf_ms(cfg.tf)){
+            for (auto& m : modules) m->reset();
+            ser.clear();
+            first = v.begin();
+        }
+        replay_series_window();
+
+        BarTable t; t.reserve(static_cast<std::size_t>(v.end()-first));
+        for (auto it=first; it!=v.end(); ++it){ t.push_back(*it); ser.push(*it); }
+        std::vector<double> out(t.size());
+        for (std::size_t i=0;i<modules.size();++i){
+            modules[i]->on_bars(sym, cfg.tf, t.columns(), out);
+            scores.s[module_idx[i]] = out.back();
+        }
+        const auto d = decide(scores, weights, cfg.thr_long, cfg.thr_short);
+        combined = d.combined_score; last_action = d.action;
+        snap_dirty = true;
+        warm_msg = fmt::format("REST: {} bars applied", t.size());
+        spdlog::info("warm-up {}@{}: {}", sym.name(), tf_to_str(cfg.tf), warm_msg);
+    }
+
     // Paper/demo
     sim::DemoAccount account{10000.0};
     double order_qty{100.0};
@@ -124,24 +268,83 @@ struct GuiApp::Impl {
     // Backtest
     char bt_path[256] = "";
     bool bt_use_mtf{false}; int bt_mtf_factor{12};
-    std::vector<float> bt_equity; float bt_min=0, bt_max=0; int bt_trades=0; float bt_maxdd=0; bool bt_has=false;
+    std::vector<float> bt_equity; float bt_min=0, bt_max=0; int bt_trades=0; float bt_maxdd=0, bt_pf=0; bool bt_has=false;
+    char bt_fee[32] = "0.0004"; char bt_sizing[32] = "cash:0.2";
+    bool bt_bracket{false}; double bt_tp_pct{2.0}, bt_sl_pct{1.5}; int bt_tie{0};   // TieBreak sorrendben
+    char bt_intrabar_path[256] = "";                                                 // opcionális 1m adat a döntetlenekhez
+    std::shared_ptr<data::LazyBars> bt_intrabar; std::string bt_intrabar_key;
+    int bt_stops=0, bt_targets=0, bt_drilled=0, bt_ties=0;
+    backtest::Metrics bt_metrics; double bt_ppy{1.0};                                // bar / év az évesítéshez
+    bool bt_mc{false}; int bt_mc_runs{5000}; backtest::MonteCarloResult bt_mc_res;   // trade-újramintavételezés
     struct WeightRow { float w1,w2,w3,final_eq,pf,winrate; };
     std::vector<WeightRow> grid_top;
 
-    Impl(){ window.setFramerateLimit(60); }
+    // Paraméter-optimalizáló (modul-paraméterek × súlyok); a score-cache futások között megmarad.
+    // Az opt_pool a backtest grid és az optimize feladatok közös számítási poolja (hardware_concurrency
+    // szál); a feladatok util::TaskGroup-pal csak a saját részfeladataikra várnak.
+    std::unique_ptr<util::ThreadPool> opt_pool;
+    SeriesCache opt_cache;
+    // optimize bemenet: ugyanaz a fájl (útvonal, méret, módosítási idő) nem töltődik és hash-elődik
+    // újra minden futásnál; az utolsó dataset rezidens marad
+    struct OptDataset {
+        std::string path;
+        std::uintmax_t size{0};
+        std::filesystem::file_time_type mtime{};
+        std::shared_ptr<const data::LoadedBars> bars;
+    };
+    std::mutex opt_data_m;
+    OptDataset opt_data;   // opt_data_m alatt
+
+    // worker szálon (optimize feladat)
+    std::shared_ptr<const data::LoadedBars> opt_dataset(const std::string& path){
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
+        const auto mtime = ec? std::filesystem::file_time_type{} : std::filesystem::last_write_time(path, ec);
+        {
+            std::lock_guard<std::mutex> lk(opt_data_m);
+            if (!ec && opt_data.bars && opt_data.path==path && opt_data.size==size && opt_data.mtime==mtime) return opt_data.bars;
+        }
+        auto b = std::make_shared<data::LoadedBars>();
+        if (!b->load(path)) throw std::runtime_error(b->error());
+        b->hash();   // egyszer, még a megosztás előtt
+        std::lock_guard<std::mutex> lk(opt_data_m);
+        if (!ec) opt_data = {path, size, mtime, b};
+        return b;
+    }
+    char opt_csv[256] = "optimizer_results.csv";
+    std::vector<std::string> opt_slots;
+    std::vector<OptResult> opt_top;
+    OptimizerStats opt_stats;
+
+    // Háttérfeladatok (backtest, optimizer): a render szál és az élő bar feldolgozás nem vár rájuk.
+    // Utolsó tag, így elsőként bomlik le: a futó feladatokat megszakítja és megvárja, mielőtt
+    // az általuk használt opt_pool / opt_cache megszűnne.
+    util::JobScheduler jobs{2};
+    // az élő út saját workere (REST warm-up), hogy ne várjon a hosszú backtest/optimize feladatokra
+    util::JobScheduler warm_jobs{1};
+
+    Impl(){
+        window.setFramerateLimit(60);
+        if (const char* b = std::getenv("BOT_REST_BASE")) std::snprintf(rest_base_buf, sizeof(rest_base_buf), "%s", b);
+    }
 };
 
 GuiApp::GuiApp(): self(std::make_unique<Impl>()){
     ImGui::SFML::Init(self->window);
 }
 GuiApp::~GuiApp(){
+    self->save_snapshot();
     if (self->ws) self->ws->stop();
     if (self->uds && self->uds_connected) self->uds->stop();
     ImGui::SFML::Shutdown();
 }
 
 void GuiApp::add_module(std::unique_ptr<IModule> m, double weight){
-    self->weights.w[m->id()] = weight;
+    const std::size_t idx = self->registry.intern(m->id());
+    self->weights.set(idx, weight);
+    self->scores.resize(self->registry.size());
+    self->module_idx.push_back(idx);
+    self->bars.reserve_history(m->history_bars());
     self->modules.emplace_back(std::move(m));
 }
 
@@ -158,7 +361,9 @@ void GuiApp::run(){
         self->ws->start();
     };
     self->cfg.tf = idx_to_tf(self->tf_idx);
+    self->load_snapshot();
     start_ws();
+    self->warmup_from_rest();
 
     bool running=true;
     while (running){
@@ -169,12 +374,21 @@ void GuiApp::run(){
         }
         ImGui::SFML::Update(self->window, delta.restart());
 
+        // --- Háttérfeladatok kész eredményei (backtest / grid / optimizer)
+        self->jobs.poll();
+        self->warm_jobs.poll();
+
         // --- Bar feldolgozás
         Bar bar;
-        while (self->bar_q.try_pop(bar)){
-            for (auto& m : self->modules){
-                auto r = m->on_bar(self->sym, self->cfg.tf, bar);
-                self->scores.s[m->id()] = r.score;
+        while (!self->warm_pending && self->bar_q.try_pop(bar)){
+            auto& series = self->bars.series(self->sym, self->cfg.tf);
+            // visszatöltött snapshot / újracsatlakozás után az átfedő bar már bent van
+            if (!series.empty() && bar.open_time_ms <= series.back().open_time_ms) continue;
+            series.push(bar);
+            self->snap_dirty = true;
+            for (std::size_t i=0;i<self->modules.size();++i){
+                auto r = self->modules[i]->on_bar(self->sym, self->cfg.tf, series);
+                self->scores.s[self->module_idx[i]] = r.score;
             }
             auto d = decide(self->scores, self->weights, self->cfg.thr_long, self->cfg.thr_short);
             self->combined = d.combined_score; self->last_action = d.action;
@@ -190,6 +404,8 @@ void GuiApp::run(){
             self->account.on_price(bar.close);
         }
 
+        if (std::chrono::duration<double>(Clock::now() - self->last_snap).count() > self->snap_sec) self->save_snapshot();
+
         // --- LIVE: open order polling (részfill követéshez)
         if (self->live_enabled && self->spot){
             auto now = Clock::now();
@@ -230,13 +446,21 @@ void GuiApp::run(){
             ImGui::Text("Last price: %.2f", self->last_price.load());
             ImGui::Text("Combined score: %.1f", self->combined);
             ImGui::Text("Decision: %s", to_string(self->last_action));
+            ImGui::Text("Snapshot: %s", self->snap_msg.c_str());
+            ImGui::Text("Warm-up: %s", self->warm_msg.c_str());
+            ImGui::InputInt("Warm-up bars", &self->warm_bars);
+            ImGui::InputText("REST base (opt.)", self->rest_base_buf, IM_ARRAYSIZE(self->rest_base_buf));
             if (ImGui::Button("Apply symbol/TF & Reconnect WS")){
                 if (self->ws) self->ws->stop();
+                self->save_snapshot();
+                { Bar stale; while (self->bar_q.try_pop(stale)){} } // a régi symbol/TF barjai
                 self->cfg.tf = idx_to_tf(self->tf_idx);
                 // base/quote frissítés (durva): utolsó 4 char USDT feltételezés
                 std::string s = self->symbol_buf;
                 if (s.size()>=6){ self->sym.base = s.substr(0, s.size()-4); self->sym.quote = s.substr(s.size()-4); }
+                self->load_snapshot();
                 start_ws();
+                self->warmup_from_rest();
             }
         }
         ImGui::End();
@@ -246,11 +470,11 @@ void GuiApp::run(){
             if (ImGui::BeginTable("modtbl", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)){
                 ImGui::TableSetupColumn("Module"); ImGui::TableSetupColumn("Weight"); ImGui::TableSetupColumn("Score");
                 ImGui::TableHeadersRow();
-                for (auto& [id, w] : self->weights.w){
+                for (std::size_t idx=0; idx<self->registry.size(); ++idx){
                     ImGui::TableNextRow();
-                    ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(id.c_str());
-                    ImGui::TableSetColumnIndex(1); ImGui::Text("%.2f", w);
-                    ImGui::TableSetColumnIndex(2); ImGui::Text("%.1f", self->scores.s[id]);
+                    ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(self->registry.name(idx).c_str());
+                    ImGui::TableSetColumnIndex(1); ImGui::Text("%.2f", self->weights.w[idx]);
+                    ImGui::TableSetColumnIndex(2); ImGui::Text("%.1f", self->scores.s[idx]);
                 }
                 ImGui::EndTable();
             }
@@ -500,89 +724,162 @@ void GuiApp::run(){
 
         // --- UI: Backtest (egyszerűsített, equity plot + grid top)
         if (ImGui::Begin("Backtest")){
-            ImGui::InputText("CSV path", self->bt_path, IM_ARRAYSIZE(self->bt_path));
+            ImGui::InputText("Data path (CSV/.bars)", self->bt_path, IM_ARRAYSIZE(self->bt_path));
             ImGui::Checkbox("Use MTF module", &self->bt_use_mtf); ImGui::SameLine(); ImGui::InputInt("MTF factor", &self->bt_mtf_factor);
-            if (ImGui::Button("Run backtest")){
-                struct Row { long long t; double o,h,l,c,v; };
-                std::ifstream f(self->bt_path); std::string line; std::vector<Row> rows; rows.reserve(200000);
-                if (f.good()){
-                    std::getline(f,line);
-                    while (std::getline(f,line)){
-                        if (line.empty()) continue; std::stringstream ss(line); std::string x; Row r{};
-                        std::getline(ss,x,','); r.t = std::stoll(x);
-                        std::getline(ss,x,','); r.o = std::stod(x);
-                        std::getline(ss,x,','); r.h = std::stod(x);
-                        std::getline(ss,x,','); r.l = std::stod(x);
-                        std::getline(ss,x,','); r.c = std::stod(x);
-                        std::getline(ss,x,','); r.v = std::stod(x);
-                        rows.push_back(r);
+            ImGui::InputText("Fee (rate | fixed+rate)", self->bt_fee, IM_ARRAYSIZE(self->bt_fee)); ImGui::SameLine();
+            ImGui::InputText("Sizing (cash:f | notional:q | qty:q)", self->bt_sizing, IM_ARRAYSIZE(self->bt_sizing));
+            // díj- és méretmodell: a fő futás, a grid és az optimalizáló is ezt használja
+            SimParams sim;
+            const bool sim_ok = backtest::parse_fee(self->bt_fee, sim.fee) && backtest::parse_sizing(self->bt_sizing, sim.sizing);
+            if (!sim_ok) ImGui::TextColored(ImVec4(1,0.4f,0.4f,1), "Ervenytelen fee/sizing");
+            // OCO bracket a bar high/low-ján (mint élesben az oco_sell_bracket)
+            ImGui::Checkbox("TP/SL bracket", &self->bt_bracket);
+            if (self->bt_bracket){
+                ImGui::SameLine(); ImGui::SetNextItemWidth(100); ImGui::InputDouble("TP %", &self->bt_tp_pct, 0.1, 1.0, "%.2f");
+                ImGui::SameLine(); ImGui::SetNextItemWidth(100); ImGui::InputDouble("SL %", &self->bt_sl_pct, 0.1, 1.0, "%.2f");
+                ImGui::SameLine(); ImGui::SetNextItemWidth(140); ImGui::Combo("Tie", &self->bt_tie, "Stop first\0Target first\0Nearest to open\0");
+                ImGui::InputText("1m data for ties (CSV/.bars)", self->bt_intrabar_path, IM_ARRAYSIZE(self->bt_intrabar_path));
+                sim.bracket = backtest::Bracket{std::max(0.0, self->bt_tp_pct), std::clamp(self->bt_sl_pct, 0.0, 99.0),
+                                                static_cast<backtest::TieBreak>(std::clamp(self->bt_tie, 0, 2))};
+                if (self->bt_intrabar_path[0]){
+                    // lusta forrás: csak az első döntetlen bar tölti be; útvonal-váltásnál új példány
+                    if (!self->bt_intrabar || self->bt_intrabar_key != self->bt_intrabar_path){
+                        self->bt_intrabar = std::make_shared<data::LazyBars>(self->bt_intrabar_path);
+                        self->bt_intrabar_key = self->bt_intrabar_path;
                     }
-                    ind::SmaEmaModule m1(20,50); ind::RsiModule m2(14); ind::BollModule m3(20,2.0); ind::MtfSmaModule m4(self->bt_mtf_factor, 10, 30);
-                    std::vector<IModule*> mods{ &m1, &m2, &m3 }; if (self->bt_use_mtf) mods.push_back(&m4);
-                    Weights w; w.w["SMA_EMA"]=0.4; w.w["RSI"]=0.3; w.w["BOLL"]=0.3; if (self->bt_use_mtf) w.w["MTF_SMA"]=0.2; Scores s;
-
-                    double cash=10000.0, pos=0.0, entry=0.0, fee=0.0004; double eq_peak=cash, maxdd=0.0; int trades=0;
-                    self->bt_equity.clear(); self->bt_equity.reserve(rows.size());
+                    sim.intrabar = [lb = self->bt_intrabar](std::int64_t a, std::int64_t b){ return lb->range(a, b); };
+                }
+            }
+            if (ImGui::Button("Run backtest") && sim_ok){
+                // háttérfeladat: a bemeneteket érték szerint viszi, az eredményt a render szál írja be (jobs.poll)
+                const std::string path = self->bt_path;
+                const bool use_mtf = self->bt_use_mtf; const int mtf_factor = self->bt_mtf_factor;
+                const std::size_t mc_runs = self->bt_mc? (std::size_t)std::max(0, self->bt_mc_runs) : 0;
+                if (!self->opt_pool) self->opt_pool = std::make_unique<util::ThreadPool>();
+                self->jobs.submit(fmt::format("Backtest {}", path), [impl = self.get(), pool = self->opt_pool.get(), path, use_mtf, mtf_factor, sim, mc_runs](util::JobControl& ctl) -> util::JobScheduler::Apply {
+                    ctl.add_total(3);   // betöltés, score-ok, backtest; a grid a saját lépéseit adja hozzá
+                    ctl.set_stage("load");
+                    // .bars (mmap) vagy CSV, a fájl tartalma alapján
+                    data::LoadedBars src;
+                    if (!src.load(path)) throw std::runtime_error(src.error());
+                    const BarColumns rows = src.columns();
+                    if (src.csv_stats().malformed) spdlog::warn("backtest: {} hibas CSV sor kihagyva", src.csv_stats().malformed);
+                    ctl.advance();
+
+                    ctl.set_stage("scores");
+                    ind::SmaEmaModule m1(20,50); ind::RsiModule m2(14); ind::BollModule m3(20,2.0); ind::MtfSmaModule m4(mtf_factor, 10, 30);
+                    std::vector<IModule*> mods{ &m1, &m2, &m3 }; if (use_mtf) mods.push_back(&m4);
                     Symbol sym{"BTC","USDT"};
-
-                    for (auto& r : rows){
-                        Bar b{r.t,r.o,r.h,r.l,r.c,r.v};
-                        for (auto* m : mods){ auto R=m->on_bar(sym, Timeframe::M5, b); s.s[m->id()] = R.score; }
-                        auto d = decide(s,w,70,30);
-                        if (d.action==Signal::Long && pos<=0){
-                            if (pos<0){ cash += (-pos)*(entry - b.close) - std::abs(pos)*entry*fee - std::abs(pos)*b.close*fee; pos=0; ++trades; if (cash>eq_peak) eq_peak=cash; }
-                            double qty = cash * 0.2 / b.close; if (qty>0){ pos += qty; cash -= qty*b.close; cash -= qty*b.close*fee; entry=b.close; }
-                        } else if (d.action==Signal::Short && pos>0){
-                            cash += pos*(b.close - entry) - std::abs(pos)*entry*fee - std::abs(pos)*b.close*fee; pos=0; ++trades; if (cash>eq_peak) eq_peak=cash;
-                        }
-                        double eq = cash + pos*b.close;
-                        self->bt_equity.push_back((float)eq);
-                        if (eq>eq_peak) eq_peak=eq;
-                        maxdd = std::max(maxdd, (float)((eq_peak-eq)/std::max(1.0,eq_peak)));
-                    }
-                    if (pos>0){ double last=rows.back().c; cash += pos*last - std::abs(pos)*entry*fee - std::abs(pos)*last*fee; pos=0; ++trades; }
-                    self->bt_trades = trades; self->bt_maxdd = (float)maxdd; self->bt_has=true;
-                    auto [mn,mx] = std::minmax_element(self->bt_equity.begin(), self->bt_equity.end());
-                    self->bt_min = (mn!=self->bt_equity.end()? *mn : 0); self->bt_max = (mx!=self->bt_equity.end()? *mx : 0);
-
-                    // Gyors grid a súlyokra (0.1 lépés, 3 modul)
-                    self->grid_top.clear();
-                    for (int i=1;i<=8;++i){
-                        for (int j=1;j<=8-i;++j){
-                            int k=10-i-j; if (k<=0) continue;
-                            float w1=i/10.f, w2=j/10.f, w3=k/10.f;
-                            Weights wg; wg.w["SMA_EMA"]=w1; wg.w["RSI"]=w2; wg.w["BOLL"]=w3; if (self->bt_use_mtf) wg.w["MTF_SMA"]=0.2f;
-                            double c2=10000.0, p2=0.0, e2=0.0; int tr=0; double eqp=c2;
-                            for (auto& r2 : rows){
-                                Bar b2{r2.t,r2.o,r2.h,r2.l,r2.c,r2.v}; Scores ss;
-                                ind::SmaEmaModule mm1(20,50); ind::RsiModule mm2(14); ind::BollModule mm3(20,2.0); ind::MtfSmaModule mm4(self->bt_mtf_factor,10,30);
-                                std::vector<IModule*> mlist{&mm1,&mm2,&mm3}; if(self->bt_use_mtf) mlist.push_back(&mm4);
-                                for (auto* m : mlist){ auto R=m->on_bar(sym, Timeframe::M5, b2); ss.s[m->id()] = R.score; }
-                                auto d2=decide(ss,wg,70,30);
-                                if (d2.action==Signal::Long && p2<=0){
-                                    if (p2<0){ c2 += (-p2)*(e2 - b2.close); p2=0; ++tr; if (c2>eqp) eqp=c2; }
-                                    double qty=c2*0.2/b2.close; if (qty>0){ p2+=qty; c2-=qty*b2.close; e2=b2.close; }
-                                } else if (d2.action==Signal::Short && p2>0){
-                                    c2 += p2*(b2.close-e2); p2=0; ++tr; if (c2>eqp) eqp=c2;
-                                }
-                                double eq=c2+p2*b2.close; if (eq>eqp) eqp=eq;
-                            }
-                            if (p2>0){ c2 += p2*rows.back().c; p2=0; ++tr; }
-                            self->grid_top.push_back({w1,w2,w3,(float)c2,0.0f,0.0f});
-                        }
+                    const Timeframe tf = data_timeframe(rows, path);
+                    // modul-score-ok egyszer, a teljes sorozatra; a súlyozás ezen a mátrixon megy
+                    const ScoreMatrix sm = ScoreMatrix::build(mods, sym, tf, rows);
+                    ctl.advance();
+                    if (ctl.cancelled()) return nullptr;
+
+                    // súlyok a mods sorrendjében
+                    ctl.set_stage("backtest");
+                    std::vector<double> w{0.4, 0.3, 0.3}; if (use_mtf) w.push_back(0.2);
+                    std::vector<double> combined(rows.size());
+                    ind::kernels::combine_scores(sm.flat(), sm.n, w, combined);
+                    // közös backtest-mag (ugyanaz, mint a CLI-ben)
+                    backtest::Engine engine;
+                    const auto r = engine.run(rows, combined, sim);
+                    std::vector<float> eq(engine.equity().begin(), engine.equity().end());
+                    const double ppy = backtest::periods_per_year(rows.size() >= 2? rows.open_time_ms[1] - rows.open_time_ms[0] : 0);
+                    ctl.advance();
+
+                    backtest::MonteCarloResult mc;
+                    if (mc_runs > 0){
+                        ctl.set_stage("monte carlo");
+                        backtest::MonteCarloConfig cfg;
+                        cfg.runs = mc_runs; cfg.cash = sim.cash;
+                        mc = backtest::monte_carlo(engine.trades(), cfg, &ctl);
+                        if (ctl.cancelled()) return nullptr;
                     }
-                    std::sort(self->grid_top.begin(), self->grid_top.end(), [](auto&a,auto&b){ return a.final_eq>b.final_eq; });
-                    if (self->grid_top.size()>10) self->grid_top.resize(10);
+
+                    // Grid a súlyokra (0.1 lépés, 3 modul; MTF fix 0.2) ugyanazon a mátrixon, a közös poolon
+                    // (a párhuzamos feladatok így együtt sem futnak több szálon, mint ahány mag van)
+                    ctl.set_stage("grid");
+                    auto wsets = weight_simplex(3, 10);
+                    if (use_mtf) for (auto& ws : wsets) ws.push_back(0.2);
+                    const auto top = grid_search(sm, rows, wsets, sim, 10, *pool, &ctl);
+                    // megszakított grid: a részleges top-lista félrevezető, az előző eredmény marad
+                    if (ctl.cancelled()) return nullptr;
+                    std::vector<Impl::WeightRow> grid;
+                    for (const auto& g : top)
+                        grid.push_back({(float)g.w[0], (float)g.w[1], (float)g.w[2], (float)g.r.final_eq,
+                                        (float)std::min(g.r.pf(), 999.0), (float)(g.r.winrate()*100.0)});
+
+                    return [impl, r, ppy, mc, eq = std::move(eq), grid = std::move(grid)]() mutable {
+                        impl->bt_equity = std::move(eq);
+                        impl->bt_trades = r.trades; impl->bt_maxdd = (float)r.maxdd; impl->bt_pf = (float)std::min(r.pf(), 999.0); impl->bt_has=true;
+                        impl->bt_stops = r.stops; impl->bt_targets = r.targets; impl->bt_drilled = r.drilled; impl->bt_ties = r.ties;
+                        impl->bt_metrics = r.metrics; impl->bt_ppy = ppy; impl->bt_mc_res = mc;
+                        auto [mn,mx] = std::minmax_element(impl->bt_equity.begin(), impl->bt_equity.end());
+                        impl->bt_min = (mn!=impl->bt_equity.end()? *mn : 0); impl->bt_max = (mx!=impl->bt_equity.end()? *mx : 0);
+                        impl->grid_top = std::move(grid);
+                    };
+                });
+            }
+            ImGui::SameLine(); ImGui::Checkbox("Monte Carlo", &self->bt_mc);
+            if (self->bt_mc){ ImGui::SameLine(); ImGui::SetNextItemWidth(120); ImGui::InputInt("runs", &self->bt_mc_runs, 1000, 10000); }
+            ImGui::SameLine();
+            if (ImGui::Button("Optimize params") && sim_ok){
+                const std::string path = self->bt_path, csv = self->opt_csv;
+                const bool use_mtf = self->bt_use_mtf;
+                if (!self->opt_pool) self->opt_pool = std::make_unique<util::ThreadPool>();
+                self->jobs.submit(fmt::format("Optimize {}", path), [impl = self.get(), pool = self->opt_pool.get(), path, csv, use_mtf, sim](util::JobControl& ctl) -> util::JobScheduler::Apply {
+                    ctl.set_stage("load");
+                    const auto src = impl->opt_dataset(path);
+                    // slotonként a kipróbált konfigurációk (közös preset a backtester --wf módjával)
+                    auto ps = default_param_slots(use_mtf);
+                    ctl.set_stage("sweep");
+                    OptimizerStats st;
+                    auto top = optimize(ps.slots, default_weight_grid(ps.slots.size()), src->columns(),
+                                        Symbol{"BTC","USDT"}, data_timeframe(src->columns(), path), sim, impl->opt_cache, *pool, 20, &st, &ctl, src->hash());
+                    if (ctl.cancelled()) return nullptr;
+                    if (!write_results_csv(csv, top, ps.names)) spdlog::warn("optimizer: CSV iras sikertelen: {}", csv);
+                    return [impl, top = std::move(top), names = std::move(ps.names), st]() mutable {
+                        impl->opt_top = std::move(top); impl->opt_slots = std::move(names); impl->opt_stats = st;
+                    };
+                });
+            }
+            ImGui::InputText("Optimizer CSV", self->opt_csv, IM_ARRAYSIZE(self->opt_csv));
+            if (!self->jobs.jobs().empty()){
+                ImGui::Separator();
+                static const char* st_names[] = {"queued", "running", "done", "cancelled", "failed"};
+                for (const auto& j : self->jobs.jobs()){
+                    ImGui::PushID((int)j.id);
+                    const auto st = j.ctl->status();
+                    const bool active = (st == util::JobStatus::Queued || st == util::JobStatus::Running);
+                    const std::string overlay = active
+                        ? fmt::format("{} {}/{}", j.ctl->stage(), j.ctl->done(), j.ctl->total())
+                        : fmt::format("{} ({:.0f} ms)", st_names[(int)st], j.ms);
+                    ImGui::ProgressBar(st == util::JobStatus::Done? 1.0f : j.ctl->fraction(), ImVec2(220, 0), overlay.c_str());
+                    ImGui::SameLine(); ImGui::TextUnformatted(j.label.c_str());
+                    if (active){ ImGui::SameLine(); if (ImGui::SmallButton("Cancel")) j.ctl->cancel(); }
+                    if (st == util::JobStatus::Failed) ImGui::TextColored(ImVec4(1,0.4f,0.4f,1), "%s", j.error.c_str());
+                    ImGui::PopID();
                 }
+                if (ImGui::SmallButton("Clear finished")) self->jobs.clear_finished();
             }
             if (self->bt_has){
-                ImGui::Text("Trades: %d  MaxDD: %.2f%%", self->bt_trades, self->bt_maxdd*100.0f);
+                ImGui::Text("Trades: %d  MaxDD: %.2f%%  PF: %.2f", self->bt_trades, self->bt_maxdd*100.0f, self->bt_pf);
+                const auto& m = self->bt_metrics;
+                ImGui::Text("Win: %.1f%%  Sharpe: %.2f  Sortino: %.2f  Exposure: %.1f%%  Avg trade: %.2f  Longest DD: %zu bars",
+                            m.winrate()*100.0, m.sharpe(self->bt_ppy), m.sortino(self->bt_ppy), m.exposure()*100.0,
+                            m.avg_trade(), m.longest_dd_bars());
+                if (const auto& mc = self->bt_mc_res; mc.runs > 0)
+                    ImGui::Text("Monte Carlo (%zu runs): return 5/50/95%%: %.1f / %.1f / %.1f  MaxDD 95%%: %.1f%%  P(loss): %.1f%%",
+                                mc.runs, mc.ret.p5*100.0, mc.ret.p50*100.0, mc.ret.p95*100.0, mc.maxdd.p95*100.0, mc.p_loss*100.0);
+                if (self->bt_stops + self->bt_targets > 0)
+                    ImGui::Text("Bracket: TP %d  SL %d  ties: 1m %d / rule %d", self->bt_targets, self->bt_stops, self->bt_drilled, self->bt_ties);
                 ImGui::PlotLines("Equity", self->bt_equity.data(), (int)self->bt_equity.size(), 0, nullptr, self->bt_min, self->bt_max, ImVec2(-1, 160));
             }
             if (!self->grid_top.empty()){
                 if (ImGui::BeginTable("grid", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)){
                     ImGui::TableSetupColumn("w(SMA)"); ImGui::TableSetupColumn("w(RSI)"); ImGui::TableSetupColumn("w(BOLL)");
-                    ImGui::TableSetupColumn("Final Eq"); ImGui::TableSetupColumn("PF"); ImGui::TableSetupColumn("Winrate");
+                    ImGui::TableSetupColumn("Final Eq"); ImGui::TableSetupColumn("PF"); ImGui::TableSetupColumn("Winrate %");
                     ImGui::TableHeadersRow();
                     for (auto& r : self->grid_top){
                         ImGui::TableNextRow();
@@ -591,7 +888,33 @@ void GuiApp::run(){
                         ImGui::TableSetColumnIndex(2); ImGui::Text("%.1f", r.w3);
                         ImGui::TableSetColumnIndex(3); ImGui::Text("%.2f", r.final_eq);
                         ImGui::TableSetColumnIndex(4); ImGui::Text("%.2f", r.pf);
-                        ImGui::TableSetColumnIndex(5); ImGui::Text("%.2f", r.winrate);
+                        ImGui::TableSetColumnIndex(5); ImGui::Text("%.1f", r.winrate);
+                    }
+                    ImGui::EndTable();
+                }
+            }
+            if (!self->opt_top.empty()){
+                ImGui::Text("Optimizer: %zu evals, %zu series computed, %zu cached, %.0f ms | cache %.0f MB, %zu evicted",
+                            self->opt_stats.evaluations, self->opt_stats.series_computed, self->opt_stats.series_cached, self->opt_stats.ms,
+                            self->opt_cache.bytes()/1048576.0, self->opt_cache.evicted());
+                const int ns = (int)self->opt_slots.size();
+                if (ImGui::BeginTable("opt", 2*ns + 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)){
+                    ImGui::TableSetupColumn("#");
+                    for (auto& s : self->opt_slots) ImGui::TableSetupColumn(s.c_str());
+                    for (auto& s : self->opt_slots) ImGui::TableSetupColumn(("w(" + s + ")").c_str());
+                    ImGui::TableSetupColumn("Final Eq"); ImGui::TableSetupColumn("PF"); ImGui::TableSetupColumn("Winrate %"); ImGui::TableSetupColumn("Trades");
+                    ImGui::TableHeadersRow();
+                    for (std::size_t i=0; i<self->opt_top.size(); ++i){
+                        const auto& r = self->opt_top[i];
+                        ImGui::TableNextRow();
+                        int c = 0;
+                        ImGui::TableSetColumnIndex(c++); ImGui::Text("%zu", i+1);
+                        for (auto& k : r.keys){ ImGui::TableSetColumnIndex(c++); ImGui::TextUnformatted(k.c_str()); }
+                        for (double w : r.w){ ImGui::TableSetColumnIndex(c++); ImGui::Text("%.2f", w); }
+                        ImGui::TableSetColumnIndex(c++); ImGui::Text("%.2f", r.r.final_eq);
+                        ImGui::TableSetColumnIndex(c++); ImGui::Text("%.2f", std::min(r.r.pf(), 999.0));
+                        ImGui::TableSetColumnIndex(c++); ImGui::Text("%.1f", r.r.winrate()*100.0);
+                        ImGui::TableSetColumnIndex(c++); ImGui::Text("%d", r.r.trades);
                     }
                     ImGui::EndTable();
                 }
@@ -0,0 +1,163 @@
+// .bars fájl: write_bar_file -> MappedBars::open után az oszlopok bitre egyeznek a kiírtakkal,
+// a lower_bound / range minden időpontra (blokkhatárokon, a barok között, a sorozaton kívül is)
+// ugyanazt adja, mint a teljes time oszlopon futó std::lower_bound; a sérült fájlt elutasítja.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "data/bar_file.hpp"
+#include "data/bar_loader.hpp"
+#include "test_util.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+template<class T>
+bool same(std::span<const T> a, std::span<const T> b){
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size_bytes()) == 0);
+}
+
+// n bar 5 perces lépéssel; gaps esetén minden 37. bar után kimarad néhány
+BarTable make_table(std::size_t n, bool gaps){
+    const auto c = random_walk(n, 9, 2000.0);
+    BarTable t;
+    std::int64_t ts = 1'700'000'000'000;
+    for (std::size_t i = 0; i < n; ++i){
+        t.push_back({ts, c[i]*0.999, c[i]*1.002, c[i]*0.997, c[i], 1.0 + static_cast<double>(i % 11)});
+        ts += 300'000 * ((gaps && i % 37 == 36) ? 4 : 1);
+    }
+    return t;
+}
+
+std::size_t ref_lower_bound(std::span<const std::int64_t> ts, std::int64_t t){
+    return static_cast<std::size_t>(std::lower_bound(ts.begin(), ts.end(), t) - ts.begin());
+}
+
+// minden bar időpontja, ±1 ms, a blokkhatárok és a sorozat két vége körül
+void check_lookup(const data::MappedBars& mb, std::span<const std::int64_t> ts, std::uint32_t stride, const char* what){
+    std::vector<std::int64_t> probes;
+    for (const auto t : ts){ probes.push_back(t - 1); probes.push_back(t); probes.push_back(t + 1); }
+    for (std::size_t k = 0; k < ts.size(); k += stride)
+        for (const std::size_t i : {k, k ? k - 1 : 0, std::min(k + 1, ts.size() - 1)}) probes.push_back(ts[i] - 150'000);
+    probes.push_back(ts.front() - 10'000'000);
+    probes.push_back(ts.back() + 10'000'000);
+    probes.push_back(INT64_MIN);
+    probes.push_back(INT64_MAX);
+
+    std::size_t diff = 0;
+    for (const auto t : probes) diff += (mb.lower_bound(t) != ref_lower_bound(ts, t));
+    CHECK_MSG(diff == 0, "%s: %zu elteres lower_bound-ban (%zu probe)", what, diff, probes.size());
+
+    // range: [a, b) a blokkhatárokon átnyúló szeletekre
+    diff = 0;
+    for (std::size_t a = 0; a < ts.size(); a += stride/2 + 1){
+        const std::size_t b = std::min(ts.size() - 1, a + 3*stride + 5);
+        const BarColumns r = mb.range(ts[a], ts[b]);
+        diff += (r.size() != b - a) || (r.size() && r.open_time_ms.front() != ts[a]) || (r.size() && r.close.data() != mb.columns().close.data() + a);
+    }
+    diff += (mb.range(ts.back() + 1, ts.back() + 2).size() != 0);
+    diff += (mb.range(ts[5], ts[2]).size() != 0);
+    diff += (mb.range(INT64_MIN, INT64_MAX).size() != ts.size());
+    CHECK_MSG(diff == 0, "%s: %zu elteres range-ben", what, diff);
+}
+
+} // namespace
+
+int main(){
+    const fs::path dir = fs::temp_directory_path() / "bar_file_test";
+    fs::create_directories(dir);
+    const std::string path = (dir / "t.bars").string();
+
+    for (const bool gaps : {false, true}){
+        for (const std::uint32_t stride : {1u, 16u, 4096u}){
+            const char* what = gaps ? "gaps" : "egyenletes";
+            const BarTable t = make_table(10'007, gaps);
+            CHECK(data::write_bar_file(path, t.columns(), stride));
+            CHECK(data::is_bar_file(path));
+
+            data::MappedBars mb;
+            CHECK_MSG(mb.open(path), "%s", mb.error().c_str());
+            if (!mb.is_open()) continue;
+            CHECK(mb.size() == t.size());
+            CHECK(mb.header().step_ms == (gaps ? 0 : 300'000));
+            CHECK(mb.header().first_open_ms == t.open_time_ms.front() && mb.header().last_open_ms == t.open_time_ms.back());
+            const BarColumns c = mb.columns();
+            CHECK(same<std::int64_t>(c.open_time_ms, t.open_time_ms));
+            CHECK(same<double>(c.open, t.open) && same<double>(c.high, t.high) && same<double>(c.low, t.low));
+            CHECK(same<double>(c.close, t.close) && same<double>(c.volume, t.volume));
+            for (int k = 0; k < 6; ++k) CHECK(mb.header().col_off[k] % 64 == 0);
+
+            check_lookup(mb, t.open_time_ms, stride, what);
+        }
+    }
+
+    // hiányzó oszlopok: open/high/low = close, volume = 0 (a BarColumns::at szemantikája)
+    {
+        const BarTable t = make_table(100, false);
+        const BarColumns only{t.open_time_ms, {}, {}, {}, t.close, {}};
+        CHECK(data::write_bar_file(path, only));
+        data::MappedBars mb;
+        CHECK(mb.open(path));
+        const BarColumns c = mb.columns();
+        CHECK(same<double>(c.open, t.close) && same<double>(c.high, t.close) && same<double>(c.low, t.close));
+        CHECK(c.volume.size() == 100 && std::all_of(c.volume.begin(), c.volume.end(), [](double v){ return v == 0.0; }));
+    }
+
+    // üres sorozat
+    {
+        CHECK(data::write_bar_file(path, BarColumns{}));
+        data::MappedBars mb;
+        CHECK(mb.open(path));
+        CHECK(mb.size() == 0 && mb.lower_bound(0) == 0 && mb.range(INT64_MIN, INT64_MAX).size() == 0);
+    }
+
+    // LoadedBars a fájl eleje alapján ismeri fel (kiterjesztéstől függetlenül), és mmap-pel tölt
+    {
+        const BarTable t = make_table(500, true);
+        const std::string odd = (dir / "t.csv").string();
+        CHECK(data::write_bar_file(odd, t.columns()));
+        data::LoadedBars lb;
+        CHECK_MSG(lb.load(odd), "%s", lb.error().c_str());
+        CHECK(lb.mapped() && lb.size() == t.size());
+        CHECK(same<double>(lb.columns().close, t.close));
+    }
+
+    // sérült fájl: csonkolt, rossz magic, más verzió
+    {
+        const BarTable t = make_table(1000, false);
+        CHECK(data::write_bar_file(path, t.columns(), 64));
+        std::vector<char> good;
+        {
+            std::ifstream f(path, std::ios::binary);
+            good.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        }
+        auto try_open = [&](const std::vector<char>& buf, std::size_t len){
+            const std::string bad = (dir / "bad.bars").string();
+            { std::ofstream f(bad, std::ios::binary | std::ios::trunc); f.write(buf.data(), static_cast<std::streamsize>(len)); }
+            data::MappedBars mb;
+            const bool ok = mb.open(bad);
+            CHECK(ok || (!mb.is_open() && !mb.error().empty() && mb.size() == 0));
+            return ok;
+        };
+        CHECK(try_open(good, good.size()));
+        for (const std::size_t len : {std::size_t{0}, std::size_t{64}, sizeof(data::BarFileHeader), good.size()/2, good.size() - 1})
+            CHECK_MSG(!try_open(good, len), "csonkolt (%zu bajt) fajl megnyilt", len);
+        auto buf = good;
+        buf[0] = 'X';
+        CHECK(!try_open(buf, buf.size()));
+        buf = good;
+        buf[offsetof(data::BarFileHeader, version)] += 1;
+        CHECK(!try_open(buf, buf.size()));
+    }
+
+    fs::remove_all(dir);
+    return check_exit();
+}
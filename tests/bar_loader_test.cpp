@@ -0,0 +1,143 @@
+// data::load_csv: a blokkhatáron (kBlock) átnyúló sor, a hibás sorok számolása, a hiányzó záró
+// újsor, header / CRLF / µs open_time, és hogy több szálon bitre ugyanazt adja, mint egy szálon.
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "data/bar_loader.hpp"
+#include "test_util.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// a bar_loader.cpp olvasási blokkja (kBlock); 1–7 szálnál ez a blokkméret
+constexpr std::size_t kBlock = 16u << 20;
+
+// a generált árak negyedekre kerekítettek, így a szöveges alak pontosan visszaolvasható
+struct Csv {
+    std::string text;
+    BarTable bars;
+    std::size_t lines{0}, malformed{0};
+
+    void bar(std::size_t i, const char* eol = "\n"){
+        const Bar b{1'600'000'000'000 + static_cast<std::int64_t>(i)*60'000, 1000.0 + static_cast<double>(i % 4000)*0.25,
+                    1001.0 + static_cast<double>(i % 4000)*0.25, 999.0 + static_cast<double>(i % 4000)*0.25,
+                    1000.5 + static_cast<double>(i % 4000)*0.25, static_cast<double>(i % 977)*0.5};
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "%lld,%.2f,%.2f,%.2f,%.2f,%.1f%s", static_cast<long long>(b.open_time_ms),
+                      b.open, b.high, b.low, b.close, b.volume, eol);
+        text += buf;
+        bars.push_back(b);
+        ++lines;
+    }
+    void bad(const char* line){ text += line; ++lines; ++malformed; }
+    // üres sorokkal (nem számítanak sornak) a következő sor a kBlock - before pozícióra kerül
+    void pad_to(std::size_t pos){ if (text.size() < pos) text.append(pos - text.size(), '\n'); }
+};
+
+bool same_table(const BarTable& a, const BarTable& b){
+    auto eq = [](const auto& x, const auto& y){
+        return x.size() == y.size() && (x.empty() || std::memcmp(x.data(), y.data(), x.size()*sizeof(x[0])) == 0);
+    };
+    return eq(a.open_time_ms, b.open_time_ms) && eq(a.open, b.open) && eq(a.high, b.high)
+        && eq(a.low, b.low) && eq(a.close, b.close) && eq(a.volume, b.volume);
+}
+
+void write(const std::string& path, const std::string& s){
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+// betölti threads szálon, és összeveti a várt táblával / számlálókkal
+void check_load(const std::string& path, const Csv& c, unsigned threads, bool header, const char* what){
+    BarTable got;
+    data::CsvStats st;
+    CHECK_MSG(data::load_csv(path, got, &st, threads), "%s: %u szal", what, threads);
+    CHECK_MSG(same_table(got, c.bars), "%s: %u szal: %zu bar, vart %zu", what, threads, got.size(), c.bars.size());
+    CHECK_MSG(st.lines == c.lines && st.malformed == c.malformed && st.header == header,
+              "%s: %u szal: lines %zu/%zu malformed %zu/%zu header %d", what, threads,
+              st.lines, c.lines, st.malformed, c.malformed, int(st.header));
+}
+
+} // namespace
+
+int main(){
+    const fs::path dir = fs::temp_directory_path() / "bar_loader_test";
+    fs::create_directories(dir);
+    const std::string path = (dir / "t.csv").string();
+    const unsigned thread_counts[] = {1, 2, 4, 7, 0};
+
+    // kis fájl: header, CRLF, hibás sorok, extra oszlopok, záró újsor nélkül
+    {
+        Csv c;
+        c.text = "open_time,open,high,low,close,volume\r\n";
+        for (std::size_t i = 0; i < 50; ++i) c.bar(i, i % 2 ? "\r\n" : "\n");
+        c.bad("1600000000000,1,2,3\n");                       // kevés mező
+        c.bad("1600000000000,abc,2,3,4,5\n");                  // nem szám
+        c.bad("1600000000000,1,2,,4,5\n");                     // üres mező
+        c.bad("1600000000000,1,2,3,4,5x\n");                   // szemét a volume után
+        c.text += "\n\r\n";                                    // üres sorok: nem számítanak
+        c.text += "1600003000000,1.5,2.5,0.5,2,7,1600003059999,123.4,99\n"; // további oszlopok
+        c.bars.push_back({1600003000000, 1.5, 2.5, 0.5, 2.0, 7.0}); ++c.lines;
+        c.text += "1600003060000000,1,2,0.5,1.5,3\n";          // µs open_time
+        c.bars.push_back({1600003060000, 1.0, 2.0, 0.5, 1.5, 3.0}); ++c.lines;
+        c.bar(60, "");                                         // záró újsor nélkül
+        write(path, c.text);
+        for (unsigned t : thread_counts) check_load(path, c, t, true, "kicsi");
+    }
+
+    // header nélkül is: az első sor bar
+    {
+        Csv c;
+        for (std::size_t i = 0; i < 10; ++i) c.bar(i);
+        write(path, c.text);
+        check_load(path, c, 1, false, "header nelkul");
+    }
+
+    // blokkhatár: a kBlock-ot átlépő sor (before bájt a határ előtt; 0: a sor pont a határon kezdődik),
+    // jó és hibás változatban, a fájl vége újsorral / anélkül. A határ előtti rész közös.
+    {
+        Csv base;
+        std::size_t i = 0;
+        while (base.text.size() + 100 < kBlock - 40){
+            if (i % 50'000 == 7) base.bad("1600000000000,x,2,3,4,5\n");
+            base.bar(i++);
+        }
+        for (const std::size_t before : {std::size_t{0}, std::size_t{1}, std::size_t{17}, std::size_t{40}}){
+            for (const bool straddle_bad : {false, true}){
+                Csv c = base;
+                std::size_t j = i;
+                c.pad_to(kBlock - before);
+                if (straddle_bad) c.bad("1600000000000,1000.25,1001.25,999.25,1000.75,not-a-volume\n");
+                else c.bar(j++);
+                for (std::size_t k = 0; k < 2000; ++k){
+                    if (k == 999) c.bad("1600000000000,1,2,3,4\n");
+                    c.bar(j++);
+                }
+                const bool trailing_nl = (before % 2 == 0);
+                c.bar(j++, trailing_nl ? "\n" : "");
+                write(path, c.text);
+
+                char what[64];
+                std::snprintf(what, sizeof(what), "hatar-%zu%s%s", before, straddle_bad ? " hibas" : "", trailing_nl ? "" : " noeol");
+                for (unsigned t : thread_counts) check_load(path, c, t, false, what);
+            }
+        }
+    }
+
+    // hiányzó / üres fájl
+    {
+        BarTable got;
+        CHECK(!data::load_csv((dir / "nincs.csv").string(), got));
+        write(path, "");
+        CHECK(!data::load_csv(path, got));
+        CHECK(got.empty());
+    }
+
+    fs::remove_all(dir);
+    return check_exit();
+}
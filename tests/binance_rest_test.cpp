@@ -0,0 +1,197 @@
+// BinanceRest::klines egy helyi HTTP stand-in ellen (127.0.0.1, véletlen port): a /api/v3/klines
+// végpont egy fix 5m-es history-ból szolgál ki limit/endTime szerint, mint a Binance. Ellenőrzi a
+// lapozást, az időrendet, az egyediséget, a még nyitott kline eldobását és az elérhetetlen szervert.
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "exec/binance_rest.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+constexpr std::int64_t kBarMs = 300'000;
+
+// query paraméter értéke ("" ha nincs)
+std::string param(const std::string& target, const std::string& key){
+    const auto q = target.find('?');
+    if (q == std::string::npos) return {};
+    std::size_t p = q + 1;
+    while (p < target.size()){
+        const auto e = target.find('&', p);
+        const std::string kv = target.substr(p, e == std::string::npos ? std::string::npos : e - p);
+        if (kv.compare(0, key.size() + 1, key + "=") == 0) return kv.substr(key.size() + 1);
+        if (e == std::string::npos) break;
+        p = e + 1;
+    }
+    return {};
+}
+
+// Egyszálú HTTP/1.1 stand-in: kérésenként egy kapcsolat (Connection: close).
+// A history utolsó klineje még nyitott (closeTime a jövőben), azt a kliensnek el kell dobnia.
+class KlinesStandIn {
+public:
+    explicit KlinesStandIn(std::size_t bars){
+        const std::int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        // pontosan egy nyitott kline: a closeTime-ja fél bar múlva jön, az előző fél bar óta lezárt
+        last_open_ = now - kBarMs / 2;
+        first_open_ = last_open_ - static_cast<std::int64_t>(bars - 1) * kBarMs;
+
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        a.sin_port = 0;
+        socklen_t len = sizeof(a);
+        if (fd_ < 0 || ::bind(fd_, reinterpret_cast<sockaddr*>(&a), sizeof(a)) != 0 || ::listen(fd_, 8) != 0
+            || ::getsockname(fd_, reinterpret_cast<sockaddr*>(&a), &len) != 0){
+            std::perror("stand-in");
+            return;
+        }
+        port_ = ntohs(a.sin_port);
+        th_ = std::thread([this]{ serve(); });
+    }
+    ~KlinesStandIn(){
+        stop_ = true;
+        ::shutdown(fd_, SHUT_RDWR);   // az accept felébred
+        if (th_.joinable()) th_.join();
+        ::close(fd_);
+    }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+    int requests() const { return requests_; }
+    std::int64_t first_open() const { return first_open_; }
+    std::int64_t last_closed_open() const { return last_open_ - kBarMs; }
+
+private:
+    void serve(){
+        while (!stop_){
+            const int c = ::accept(fd_, nullptr, nullptr);
+            if (c < 0) break;
+            std::string req;
+            char buf[4096];
+            while (req.find("\r\n\r\n") == std::string::npos){
+                const auto n = ::recv(c, buf, sizeof(buf), 0);
+                if (n <= 0) break;
+                req.append(buf, static_cast<std::size_t>(n));
+            }
+            const auto sp1 = req.find(' '), sp2 = req.find(' ', sp1 + 1);
+            const std::string target = (sp1 == std::string::npos || sp2 == std::string::npos) ? "" : req.substr(sp1 + 1, sp2 - sp1 - 1);
+            respond(c, target);
+            ::close(c);
+        }
+    }
+
+    void respond(int c, const std::string& target){
+        std::string status = "200 OK", body;
+        if (target.compare(0, 15, "/api/v3/klines?") != 0){
+            status = "404 Not Found";
+            body = R"({"code":-1,"msg":"not found"})";
+        } else {
+            ++requests_;
+            const std::string lim = param(target, "limit"), end = param(target, "endTime");
+            const std::size_t limit = lim.empty() ? 500 : std::stoul(lim);
+            const std::int64_t end_ms = end.empty() ? last_open_ : std::min<std::int64_t>(last_open_, std::stoll(end));
+            // a legutolsó limit darab kline, aminek az openTime-ja <= endTime
+            std::int64_t hi = end_ms - (end_ms - first_open_) % kBarMs;
+            std::int64_t lo = std::max(first_open_, hi - static_cast<std::int64_t>(limit - 1) * kBarMs);
+            body = "[";
+            for (std::int64_t t = lo; end_ms >= first_open_ && t <= hi; t += kBarMs){
+                const double px = 100.0 + static_cast<double>((t - first_open_) / kBarMs) * 0.01;
+                char row[256];
+                std::snprintf(row, sizeof(row), R"(%s[%lld,"%.2f","%.2f","%.2f","%.2f","1.5",%lld,"150.0",10,"0.7","70.0","0"])",
+                              t == lo ? "" : ",", static_cast<long long>(t), px, px + 1.0, px - 1.0, px,
+                              static_cast<long long>(t + kBarMs - 1));
+                body += row;
+            }
+            body += "]";
+        }
+        const std::string resp = "HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\nContent-Length: "
+                               + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        std::size_t off = 0;
+        while (off < resp.size()){
+            const auto n = ::send(c, resp.data() + off, resp.size() - off, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            off += static_cast<std::size_t>(n);
+        }
+    }
+
+    int fd_{-1};
+    unsigned short port_{0};
+    std::thread th_;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> requests_{0};
+    std::int64_t first_open_{0}, last_open_{0};
+};
+
+bool ordered(const std::vector<Bar>& v){
+    for (std::size_t i = 1; i < v.size(); ++i)
+        if (v[i].open_time_ms != v[i - 1].open_time_ms + kBarMs) return false;
+    return true;
+}
+
+exec::BinanceRest client(const std::string& base){
+    exec::ApiConfig c;
+    c.testnet = false;
+    c.base_url = base;
+    c.timeout_ms = 2000;
+    return exec::BinanceRest(c);
+}
+
+} // namespace
+
+int main(){
+    KlinesStandIn srv(2500);   // 2499 lezárt + 1 nyitott
+    auto rest = client(srv.url());
+
+    // egy lap: a nyitott kline kiesik, az utolsó a legfrissebb lezárt
+    {
+        const auto v = rest.klines("BTCUSDT", "5m", 10);
+        CHECK(v.size() == 10);
+        CHECK(ordered(v));
+        CHECK(!v.empty() && v.back().open_time_ms == srv.last_closed_open());
+        CHECK(!v.empty() && v.back().high > v.back().close && v.back().volume == 1.5);
+        CHECK(srv.requests() == 1);
+    }
+    // lapozás 1000 fölött: két kérés, átfedés és hiány nélkül
+    {
+        const int before = srv.requests();
+        const auto v = rest.klines("BTCUSDT", "5m", 1500);
+        CHECK_MSG(v.size() == 1500, "%zu", v.size());
+        CHECK(ordered(v));
+        CHECK(!v.empty() && v.back().open_time_ms == srv.last_closed_open());
+        CHECK_MSG(srv.requests() - before == 2, "%d", srv.requests() - before);
+    }
+    // több kell, mint amennyi history van: a teljes lezárt history, időrendben
+    {
+        const auto v = rest.klines("BTCUSDT", "5m", 5000);
+        CHECK_MSG(v.size() == 2499, "%zu", v.size());
+        CHECK(ordered(v));
+        CHECK(!v.empty() && v.front().open_time_ms == srv.first_open());
+    }
+    // end_time_ms: csak addig
+    {
+        const std::int64_t end = srv.first_open() + 99 * kBarMs;
+        const auto v = rest.klines("BTCUSDT", "5m", 50, end);
+        CHECK(v.size() == 50);
+        CHECK(!v.empty() && v.back().open_time_ms == end);
+    }
+    // nem válaszoló szerver: üres eredmény, kivétel nélkül
+    {
+        std::string dead;
+        { KlinesStandIn tmp(1); dead = tmp.url(); }
+        const auto v = client(dead).klines("BTCUSDT", "5m", 10);
+        CHECK(v.empty());
+    }
+    return check_exit();
+}
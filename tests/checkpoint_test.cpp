@@ -0,0 +1,238 @@
+// Checkpoint + folytatás (a backtester --checkpoint útja): a félúton mentett állapotból
+// (save/load_checkpoint, pipeline deserialize, Engine::resume) a végeredmény – final_eq, trade-ek,
+// metrikák – bitre ugyanaz, mint a teljes futásé; más config, megváltozott adatsor-eleje, rövidebb
+// adatsor vagy nem tölthető modulállapot esetén teljes futás lesz. A mentés felülírja a régit.
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "backtest/checkpoint.hpp"
+#include "backtest/engine.hpp"
+#include "indicators/bollinger.hpp"
+#include "indicators/kernels.hpp"
+#include "indicators/mtfa.hpp"
+#include "indicators/rsi.hpp"
+#include "indicators/sma_ema.hpp"
+#include "strategy/pipeline.hpp"
+#include "test_util.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Pipeline = StaticPipeline<ind::SmaEmaModule, ind::RsiModule, ind::BollModule, ind::MtfSmaModule>;
+
+Pipeline make_pipeline(std::size_t mtf_factor = 12){
+    return Pipeline{ ind::SmaEmaModule(20,50), ind::RsiModule(14), ind::BollModule(20,2.0),
+                     ind::MtfSmaModule(mtf_factor, 10, 30) };
+}
+
+// a backtester score_pipeline-ja: slotonkénti batch score-ok, majd súlyozott kombinálás
+void score(Pipeline& pipe, const BarColumns& cols, std::vector<double>& combined){
+    const double w[Pipeline::N] = { 0.4, 0.3, 0.2, 0.1 };
+    const std::size_t n = cols.size();
+    std::vector<double> buf(Pipeline::N * n);
+    std::array<std::span<double>, Pipeline::N> out;
+    std::array<const double*, Pipeline::N> rows;
+    for (std::size_t m = 0; m < Pipeline::N; ++m){ out[m] = {buf.data() + m*n, n}; rows[m] = out[m].data(); }
+    pipe.on_bars(Symbol{}, Timeframe::M5, cols, out);
+    combined.resize(n);
+    ind::kernels::combine_score_rows(rows, n, w, combined);
+}
+
+struct Data {
+    std::vector<std::int64_t> t;
+    std::vector<double> open, high, low, close;
+    Data(std::size_t n, std::uint64_t seed){
+        close = random_walk(n, seed, 2000.0, 0.004);
+        t.resize(n); open.resize(n); high.resize(n); low.resize(n);
+        for (std::size_t i = 0; i < n; ++i){
+            t[i] = 1'700'000'000'000 + static_cast<std::int64_t>(i)*300'000;
+            open[i] = i ? close[i-1] : close[i];
+            high[i] = std::max(open[i], close[i])*1.002;
+            low[i] = std::min(open[i], close[i])*0.998;
+        }
+    }
+    BarColumns cols() const { return {t, open, high, low, close, {}}; }
+};
+
+struct Outcome {
+    std::size_t from{0};            // 0: teljes futás, egyébként a folytatás első barja
+    backtest::Result r;
+    std::vector<backtest::Trade> trades;
+    std::vector<char> metrics;      // Metrics::serialize – minden belső összeg bitre
+};
+
+// a backtester main --checkpoint ága: betöltés, ellenőrzés, folytatás (vagy teljes futás), mentés
+Outcome run_with_checkpoint(const std::string& path, const std::string& config, const BarColumns& cols,
+                            const backtest::Params& p, std::size_t mtf_factor = 12){
+    Pipeline pipe = make_pipeline(mtf_factor);
+    backtest::Checkpoint ck;
+    ck.config = config;
+    ck.state = backtest::State(p.cash);
+    Outcome o;
+    backtest::Checkpoint saved;
+    if (fs::exists(path) && backtest::load_checkpoint(path, saved) && saved.config == ck.config && saved.extends(cols)){
+        util::BinReader mr(saved.modules);
+        if (!pipe.deserialize(mr) || !mr.at_end()) pipe = make_pipeline(mtf_factor);
+        else {
+            o.from = saved.bars;
+            ck.state = saved.state;
+            ck.trades = std::move(saved.trades);
+        }
+    }
+    const BarColumns fresh = cols.subspan(o.from, cols.size() - o.from);
+    std::vector<double> combined;
+    score(pipe, fresh, combined);
+    backtest::Engine eng;
+    o.r = eng.resume(fresh, combined, p, ck.state);
+    o.trades = ck.trades;
+    o.trades.insert(o.trades.end(), eng.trades().begin(), eng.trades().end());
+    util::BinWriter mw;
+    o.r.metrics.serialize(mw);
+    o.metrics = mw.data();
+
+    for (const auto& t : eng.trades())
+        if (t.reason != backtest::ExitReason::End) ck.trades.push_back(t);
+    util::BinWriter pw;
+    pipe.serialize(pw);
+    ck.modules = pw.data();
+    backtest::stamp(ck, cols);
+    std::string err;
+    CHECK_MSG(backtest::save_checkpoint(path, ck, &err), "%s", err.c_str());
+    return o;
+}
+
+bool same_trades(const std::vector<backtest::Trade>& a, const std::vector<backtest::Trade>& b){
+    if (a.size() != b.size()) return false;
+    for (std::size_t k = 0; k < a.size(); ++k){
+        const auto& x = a[k]; const auto& y = b[k];
+        if (x.entry_i != y.entry_i || x.exit_i != y.exit_i || x.qty != y.qty || x.entry_px != y.entry_px ||
+            x.exit_px != y.exit_px || x.pnl != y.pnl || x.ret != y.ret || x.reason != y.reason) return false;
+    }
+    return true;
+}
+
+bool same_outcome(const Outcome& a, const Outcome& b){
+    return a.r.final_eq == b.r.final_eq && a.r.maxdd == b.r.maxdd && a.r.trades == b.r.trades &&
+           a.r.wins == b.r.wins && a.r.fees == b.r.fees && a.r.stops == b.r.stops && a.r.targets == b.r.targets &&
+           a.metrics == b.metrics && same_trades(a.trades, b.trades);
+}
+
+} // namespace
+
+int main(){
+    const fs::path dir = fs::temp_directory_path() / "checkpoint_test";
+    fs::create_directories(dir);
+    const std::string path = (dir / "run.ck").string();
+
+    const std::size_t n = 8000;
+    const Data d(n, 21);
+    const BarColumns cols = d.cols();
+
+    backtest::Params p;
+    p.up = 60.0; p.down = 45.0;
+    p.fee = backtest::FixedPlusPercentFee{0.2, 0.0004};
+    p.bracket = {1.5, 1.0, backtest::TieBreak::StopFirst};
+    const std::string cfg = "test-cfg-A";
+
+    fs::remove(path);
+    const Outcome full = run_with_checkpoint(path, cfg, cols, p);
+    CHECK(full.from == 0);
+    CHECK(full.r.trades > 5 && full.r.stops > 0 && full.r.targets > 0);
+
+    // vágási pontok: N/2, a széleken, és egy nyitott pozíció közepén (a checkpointban qty > 0)
+    std::vector<std::size_t> cuts{n/2, 1, n - 1};
+    for (const auto& t : full.trades)
+        if (t.exit_i > t.entry_i + 2){ cuts.push_back((t.entry_i + t.exit_i)/2); break; }
+    CHECK(cuts.size() == 4);
+
+    bool open_position = false;
+    for (const std::size_t cut : cuts){
+        fs::remove(path);
+        const Outcome first = run_with_checkpoint(path, cfg, cols.subspan(0, cut), p);
+        CHECK(first.from == 0);
+        backtest::Checkpoint ck;
+        CHECK(backtest::load_checkpoint(path, ck));
+        CHECK(ck.bars == cut && ck.state.bars == cut && ck.last_open_ms == d.t[cut - 1]);
+        open_position |= ck.state.qty > 0.0;
+
+        const Outcome resumed = run_with_checkpoint(path, cfg, cols, p);
+        CHECK_MSG(resumed.from == cut, "cut %zu: from %zu", cut, resumed.from);
+        CHECK_MSG(same_outcome(resumed, full), "cut %zu: final %.17g vs %.17g, trades %d vs %d", cut,
+                  resumed.r.final_eq, full.r.final_eq, resumed.r.trades, full.r.trades);
+    }
+    CHECK_MSG(open_position, "egyik checkpoint sem nyitott pozícióban készült");
+
+    // fallback-ek: minden esetben teljes futás, ami egyezik az ellenőrzés nélküli teljes futással
+    auto checkpoint_at_half = [&](std::size_t mtf = 12){
+        fs::remove(path);
+        run_with_checkpoint(path, cfg, cols.subspan(0, n/2), p, mtf);
+    };
+    {   // más config
+        checkpoint_at_half();
+        const Outcome o = run_with_checkpoint(path, "test-cfg-B", cols, p);
+        CHECK(o.from == 0 && same_outcome(o, full));
+    }
+    {   // megváltozott adatsor-eleje (egy close a mentett tartományon belül): a hash nem egyezik
+        checkpoint_at_half();
+        Data d2 = d;
+        d2.close[100] *= 1.0001;
+        const Outcome o = run_with_checkpoint(path, cfg, d2.cols(), p);
+        fs::remove(path);
+        const Outcome ref = run_with_checkpoint(path, cfg, d2.cols(), p);
+        CHECK(o.from == 0 && ref.from == 0 && same_outcome(o, ref));
+    }
+    {   // eltérő időbélyeg az utolsó mentett baron
+        checkpoint_at_half();
+        Data d2 = d;
+        for (std::size_t i = n/2 - 1; i < n; ++i) d2.t[i] += 60'000;
+        const Outcome o = run_with_checkpoint(path, cfg, d2.cols(), p);
+        CHECK(o.from == 0);
+    }
+    {   // rövidebb adatsor, mint a checkpoint
+        checkpoint_at_half();
+        const Outcome o = run_with_checkpoint(path, cfg, cols.subspan(0, n/4), p);
+        CHECK(o.from == 0);
+    }
+    {   // azonos config-szöveg, de más modulkonfiguráció: a deserialize elutasítja, friss pipeline
+        checkpoint_at_half(6);
+        const Outcome o = run_with_checkpoint(path, cfg, cols, p);
+        CHECK(o.from == 0 && same_outcome(o, full));
+    }
+
+    // sérült fájl: load_checkpoint false, a ck változatlan; a mentés a meglévőt cseréli
+    {
+        checkpoint_at_half();
+        std::vector<char> good;
+        {
+            std::ifstream f(path, std::ios::binary);
+            good.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        }
+        const std::string bad = (dir / "bad.ck").string();
+        std::size_t accepted = 0;
+        for (std::size_t len = 0; len < good.size(); len += (len < 64 ? 1 : 61)){
+            { std::ofstream f(bad, std::ios::binary | std::ios::trunc); f.write(good.data(), static_cast<std::streamsize>(len)); }
+            backtest::Checkpoint ck;
+            ck.config = "untouched";
+            std::string err;
+            if (backtest::load_checkpoint(bad, ck, &err)) ++accepted;
+            else CHECK(ck.config == "untouched" && !err.empty());
+        }
+        CHECK_MSG(accepted == 0, "%zu csonkolt checkpoint betoltve", accepted);
+
+        backtest::Checkpoint a, b;
+        CHECK(backtest::load_checkpoint(path, a));
+        a.config = "felulirva";
+        CHECK(backtest::save_checkpoint(path, a));
+        CHECK(backtest::load_checkpoint(path, b) && b.config == "felulirva" && b.bars == a.bars);
+        CHECK(!fs::exists(path + ".tmp"));
+    }
+
+    fs::remove_all(dir);
+    return check_exit();
+}
@@ -0,0 +1,39 @@
+#include <span>
+#include <vector>
+#include "core/bar_columns.hpp"
+#include "indicators/sma_ema.hpp"
+#include "test_util.hpp"
+
+// EmaState (streaming, baronként O(1)) == compute_ema (batch) egy hosszú sorozat minden ellenőrzőpontján,
+// bitre; és a SmaEmaModule on_bar / on_bars útja ugyanazt a score-sorozatot adja.
+int main(){
+    const std::size_t n = 1'000'000;
+    const auto x = random_walk(n, 7);
+
+    for (std::size_t p : {2u, 20u, 50u, 200u}) {
+        ind::EmaState e(p);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double v = e.update(x[i]);
+            if (i % 9973 == 0 || i + 1 == n) {
+                const double b = ind::compute_ema(std::span<const double>(x.data(), i + 1), p);
+                CHECK_MSG(v == b, "p=%zu i=%zu stream=%.17g batch=%.17g", p, i, v, b);
+            }
+        }
+    }
+
+    // modul: streaming vs batch (két darabban, hogy a folytatás is le legyen fedve)
+    const std::size_t m = 20'000;
+    std::vector<std::int64_t> t(m);
+    for (std::size_t i = 0; i < m; ++i) t[i] = static_cast<std::int64_t>(i) * 300'000;
+    const BarColumns cols{t, {}, {}, {}, std::span<const double>(x.data(), m), {}};
+    ind::SmaEmaModule stream(20, 50), batch(20, 50);
+    std::vector<double> out(m);
+    const std::size_t cut = 37;
+    batch.on_bars(Symbol{}, Timeframe::M5, cols.subspan(0, cut), std::span<double>(out).first(cut));
+    batch.on_bars(Symbol{}, Timeframe::M5, cols.subspan(cut, m - cut), std::span<double>(out).subspan(cut));
+    std::size_t diff = 0;
+    for (std::size_t i = 0; i < m; ++i)
+        if (stream.on_bar(Symbol{}, Timeframe::M5, cols.at(i)).score != out[i]) ++diff;
+    CHECK_MSG(diff == 0, "%zu elteres a %zu barbol", diff, m);
+    return check_exit();
+}
@@ -0,0 +1,97 @@
+// Engine::run / resume prepare() után baronként nem foglal: a globális operator new számlálója a
+// futás alatt nem nőhet (díj- és méretmodellek, bracket, trade-lista). Mellette a díjas méretezés:
+// fix + százalékos díjjal, a cash-nél nagyobb notional kéréssel sem lesz az equity negatív.
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "backtest/engine.hpp"
+#include "test_util.hpp"
+
+namespace {
+std::atomic<std::size_t> g_allocs{0};
+}
+
+void* operator new(std::size_t n){
+    ++g_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n){ return operator new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// close + OHLC egy bolyongásból, a combined score pedig váltakozó be/ki jelek
+struct Data {
+    std::vector<double> open, high, low, close, combined;
+    explicit Data(std::size_t n, double vol = 0.002){
+        close = random_walk(n, 7, 100.0, vol);
+        open.resize(n); high.resize(n); low.resize(n); combined.resize(n);
+        for (std::size_t i = 0; i < n; ++i){
+            open[i] = i ? close[i-1] : close[i];
+            high[i] = std::max(open[i], close[i])*1.001;
+            low[i] = std::min(open[i], close[i])*0.999;
+            combined[i] = 50.0 + 45.0*std::sin(static_cast<double>(i)*0.37);
+        }
+    }
+    BarColumns cols() const { return {{}, open, high, low, close, {}}; }
+};
+
+} // namespace
+
+int main(){
+    const std::size_t n = 20000;
+    const Data d(n);
+    const BarColumns bars = d.cols();
+
+    std::vector<backtest::Params> ps(3);
+    ps[1].fee = backtest::FixedPlusPercentFee{0.5, 0.001};
+    ps[1].sizing = backtest::FixedNotional{3000.0};
+    ps[1].bracket = {0.5, 0.4, backtest::TieBreak::NearestOpen};
+    ps[2].sizing = backtest::FixedQty{5.0};
+    ps[2].bracket = {1.0, 0.0, backtest::TieBreak::StopFirst};
+
+    backtest::Engine eng;
+    eng.prepare(n);
+    for (const auto& p : ps){
+        const std::size_t before = g_allocs.load();
+        const auto& r = eng.run(bars, d.combined, p);
+        const std::size_t allocs = g_allocs.load() - before;
+        CHECK_MSG(allocs == 0, "run: %zu foglalás", allocs);
+        CHECK(r.trades > 0);
+        CHECK(static_cast<std::size_t>(r.trades) == eng.trades().size());
+    }
+    // folytatás: két fél, ugyanazzal a motorral
+    {
+        backtest::State st(ps[1].cash);
+        const std::size_t before = g_allocs.load();
+        eng.resume(bars.subspan(0, n/2), std::span<const double>(d.combined).subspan(0, n/2), ps[1], st);
+        eng.resume(bars.subspan(n/2, n - n/2), std::span<const double>(d.combined).subspan(n/2), ps[1], st);
+        const std::size_t allocs = g_allocs.load() - before;
+        CHECK_MSG(allocs == 0, "resume: %zu foglalás", allocs);
+    }
+
+    // a cash-t többszörösen meghaladó notional + fix díj: a cash a teljes körök után sem negatív –
+    // sem leapadt (a zárás fix díjánál alig több) cash-ről indulva, sem erősen eső piacon
+    for (double cash : {1.5, 3.0, 1000.0}){
+        const Data down(n, 0.02);
+        backtest::Params p;
+        p.cash = cash;
+        p.fee = backtest::FixedPlusPercentFee{1.0, 0.001};
+        p.sizing = backtest::FixedNotional{3000.0};
+        p.bracket = {0.5, 0.4, backtest::TieBreak::NearestOpen};
+        eng.prepare(n);
+        const auto& r = eng.run(down.cols(), down.combined, p);
+        CHECK_MSG(r.final_eq >= 0.0, "cash %g: %g", cash, r.final_eq);
+        CHECK_MSG(r.maxdd <= 1.0, "cash %g: %g", cash, r.maxdd);
+        CHECK(std::all_of(eng.equity().begin(), eng.equity().end(), [](double e){ return e >= 0.0; }));
+    }
+    return check_exit();
+}
@@ -0,0 +1,124 @@
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "core/bar_columns.hpp"
+#include "indicators/bollinger.hpp"
+#include "indicators/kernels.hpp"
+#include "indicators/mtfa.hpp"
+#include "indicators/rsi.hpp"
+#include "indicators/sma_ema.hpp"
+#include "test_util.hpp"
+
+// A batch kernelek minden támogatott ISA-n (force_isa) bitre azonosak a skalár változattal, a skalár
+// ablakos kernelek a compute_* referenciával; és minden modul on_bars útja (darabokban hívva is)
+// ugyanazt a score-sorozatot adja, mint a baronkénti on_bar – ISA-nként.
+namespace kn = ind::kernels;
+
+namespace {
+
+bool same(std::span<const double> a, std::span<const double> b){
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size_bytes()) == 0;
+}
+
+// az összes kernel kimenete egy vektorban (a hossz páratlan, így a SIMD maradék ág is fut)
+std::vector<std::vector<double>> run_kernels(const std::vector<double>& x, const std::vector<double>& y){
+    const std::size_t n = x.size(), p = 14, first = 20, len = n - first;
+    std::vector<std::vector<double>> out;
+    auto slot = [&](std::size_t k) -> std::vector<double>& { out.emplace_back(k); return out.back(); };
+
+    kn::sma_series(x, p, first, slot(len));
+    { auto& mid = slot(len); auto& sd = slot(len); kn::bb_series(x, p, first, mid, sd); }
+    kn::rsi_window_series(x, p, first, slot(len));
+
+    { auto& e = slot(n); e = y; kn::ema_step(e, x, 2.0/15.0); }
+    {
+        auto& prev = slot(n); auto& ag = slot(n); auto& al = slot(n);
+        prev = y;
+        for (std::size_t i = 0; i < n; ++i){ ag[i] = 0.01*static_cast<double>(i % 7); al[i] = 0.02*static_cast<double>(i % 5); }
+        kn::wilder_step(prev, ag, al, x, p);
+        kn::rsi_from_gain_loss(ag, al, slot(n));
+    }
+    kn::ema_cross_score(x, y, slot(n));
+    {
+        std::vector<double> r(n);
+        for (std::size_t i = 0; i < n; ++i) r[i] = static_cast<double>(i % 101);
+        kn::rsi_score(r, slot(n));
+    }
+    {
+        std::vector<double> mid(n), sd(n);
+        for (std::size_t i = 0; i < n; ++i){ mid[i] = y[i]; sd[i] = (i % 13 == 0)? 0.0 : 0.5 + 0.01*static_cast<double>(i % 17); }
+        kn::bb_score(x, mid, sd, 2.0, slot(n));
+    }
+    {
+        std::vector<double> s(3*n);
+        for (std::size_t i = 0; i < 3*n; ++i) s[i] = static_cast<double>((i*37) % 100);
+        const double w[] = {0.4, 0.35, 0.25};
+        kn::combine_scores(s, n, w, slot(n));
+        const double* rows[] = {s.data(), s.data() + n, s.data() + 2*n};
+        kn::combine_score_rows(rows, n, w, slot(n));
+    }
+    return out;
+}
+
+// modul score-sorozata baronként (on_bar) és batch-ben (on_bars, egyenetlen darabokban)
+template<class Make>
+void check_module(const char* name, Make make, const BarColumns& cols){
+    const std::size_t m = cols.size();
+    auto stream = make();
+    auto batch = make();
+    std::vector<double> ref(m), out(m);
+    for (std::size_t i = 0; i < m; ++i) ref[i] = stream->on_bar(Symbol{}, Timeframe::M5, cols.at(i)).score;
+    const std::size_t cuts[] = {0, 1, 8, 45, 1000, m};
+    for (std::size_t k = 0; k + 1 < std::size(cuts); ++k){
+        const std::size_t a = cuts[k], b = cuts[k+1];
+        batch->on_bars(Symbol{}, Timeframe::M5, cols.subspan(a, b - a), std::span<double>(out).subspan(a, b - a));
+    }
+    std::size_t diff = 0;
+    for (std::size_t i = 0; i < m; ++i) diff += (ref[i] != out[i]);
+    CHECK_MSG(diff == 0, "%s [%s]: %zu elteres a %zu barbol", name, kn::isa_name(kn::active_isa()), diff, m);
+}
+
+} // namespace
+
+int main(){
+    const std::size_t n = 4099;
+    const auto x = random_walk(n, 11, 100.0);
+    const auto y = random_walk(n, 12, 100.0);
+
+    // skalár referencia, és az ablakos kernelek a compute_* függvényekkel
+    kn::force_isa(kn::Isa::Scalar);
+    CHECK(kn::active_isa() == kn::Isa::Scalar);
+    const auto ref = run_kernels(x, y);
+    {
+        const std::size_t p = 14, first = 20;
+        std::size_t diff = 0;
+        for (std::size_t i = first; i < n; ++i){
+            const std::span<const double> h(x.data(), i + 1);
+            diff += (ref[0][i - first] != ind::compute_sma(h, p));
+            diff += (ref[3][i - first] != ind::compute_rsi(h, p));
+        }
+        CHECK_MSG(diff == 0, "skalar kernel vs compute_*: %zu elteres", diff);
+    }
+
+    std::vector<std::int64_t> t(n);
+    for (std::size_t i = 0; i < n; ++i) t[i] = 1'700'000'000'000 + static_cast<std::int64_t>(i) * 300'000;
+    const BarColumns cols{t, {}, {}, {}, x, {}};
+
+    for (const kn::Isa isa : {kn::Isa::Scalar, kn::Isa::SSE2, kn::Isa::AVX2}){
+        kn::force_isa(isa);
+        if (kn::active_isa() != isa){ std::printf("%s: nem tamogatott, kihagyva\n", kn::isa_name(isa)); continue; }
+        const auto got = run_kernels(x, y);
+        CHECK(got.size() == ref.size());
+        for (std::size_t k = 0; k < std::min(got.size(), ref.size()); ++k)
+            CHECK_MSG(same(got[k], ref[k]), "%s: a %zu. kernelkimenet elter a skalartol", kn::isa_name(isa), k);
+
+        check_module("SMA_EMA", []{ return std::make_unique<ind::SmaEmaModule>(20, 50); }, cols);
+        check_module("RSI wilder", []{ return std::make_unique<ind::RsiModule>(14, ind::RsiMode::Wilder); }, cols);
+        check_module("RSI window", []{ return std::make_unique<ind::RsiModule>(14, ind::RsiMode::Window); }, cols);
+        check_module("BOLL", []{ return std::make_unique<ind::BollModule>(20, 2.0); }, cols);
+        check_module("MTF_SMA", []{ return std::make_unique<ind::MtfSmaModule>(12, 10, 30); }, cols);
+    }
+    return check_exit();
+}
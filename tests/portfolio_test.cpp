@@ -0,0 +1,155 @@
+// backtest::run_portfolio: egy symbollal ugyanazt adja, mint a backtest::run; eltérő timeframe-ű
+// symbolok a bar-zárás szerint sorakoznak (az 1h bar a 12. 5m barral együtt zár, azonos záráskor a
+// symbol-sorrend dönt); a max_positions korlát elutasít, a max_weight a belépő méretet vágja.
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "backtest/engine.hpp"
+#include "backtest/portfolio.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+constexpr std::int64_t kT0 = 1'700'000'000'000;
+constexpr std::int64_t kM5 = 300'000, kH1 = 3'600'000;
+
+struct Series {
+    std::vector<std::int64_t> t;
+    std::vector<double> open, high, low, close, combined;
+    Series(std::size_t n, std::int64_t step, double px = 100.0): t(n), open(n, px), high(n, px), low(n, px), close(n, px), combined(n, 50.0) {
+        for (std::size_t i = 0; i < n; ++i) t[i] = kT0 + static_cast<std::int64_t>(i)*step;
+    }
+    BarColumns cols() const { return {t, open, high, low, close, {}}; }
+};
+
+bool close_rel(double a, double b, double eps = 1e-12){ return std::fabs(a - b) <= eps*std::max(1.0, std::fabs(b)); }
+
+} // namespace
+
+int main(){
+    // egy symbol == backtest::run (díj, méret, a végén nyitva maradt pozíció zárása)
+    for (const double f : {1.0, 0.3}){
+        const std::size_t n = 5000;
+        Series s(n, kM5);
+        s.close = random_walk(n, 17, 100.0, 0.004);
+        for (std::size_t i = 0; i < n; ++i){
+            s.open[i] = i ? s.close[i-1] : s.close[i];
+            s.combined[i] = 50.0 + 45.0*std::sin(static_cast<double>(i)*0.11);
+        }
+        s.combined[n-1] = 99.0;     // utolsó baron belép: a lezárás az End ágon megy
+
+        backtest::Params bp;
+        bp.fee = backtest::FixedPlusPercentFee{0.3, 0.001};
+        bp.sizing = backtest::FractionOfCash{f};
+        std::vector<double> beq(n);
+        const auto r = backtest::run(s.cols(), backtest::ScoreThresholds{s.combined, bp.up, bp.down}, bp, beq);
+
+        const backtest::PortfolioSymbol sym{"AAA", s.cols(), s.combined, {1.0, backtest::FractionOfCash{f}}};
+        backtest::PortfolioParams pp;
+        pp.fee = bp.fee;
+        std::vector<double> peq;
+        std::vector<std::int64_t> times;
+        const auto pr = backtest::run_portfolio(std::span(&sym, 1), pp, &peq, &times);
+
+        CHECK_MSG(pr.final_eq == r.final_eq, "f=%g: %.17g vs %.17g", f, pr.final_eq, r.final_eq);
+        CHECK(pr.fees == r.fees);
+        CHECK(r.trades > 10 && pr.metrics.trades() == r.trades && pr.metrics.wins() == r.wins);
+        CHECK(pr.metrics.gross_win() == r.gross_win && pr.metrics.gross_loss() == r.gross_loss);
+        CHECK(pr.symbols.size() == 1 && pr.symbols[0].rejected == 0 && pr.symbols[0].bars == n);
+        CHECK(pr.events == n && pr.steps == n && peq.size() == n && times.size() == n);
+        CHECK(times.front() == kT0 + kM5 && times.back() == kT0 + static_cast<std::int64_t>(n)*kM5);
+        // a portfólió-equity növekményesen értékel: a mark-to-market csak kerekítésben térhet el
+        std::size_t diff = 0;
+        for (std::size_t i = 0; i < n; ++i) diff += !close_rel(peq[i], beq[i]);
+        CHECK_MSG(diff == 0, "f=%g: %zu equity elteres", f, diff);
+        CHECK(close_rel(pr.metrics.maxdd(), r.maxdd, 1e-9));
+        CHECK(pr.metrics.exposure() == r.metrics.exposure());
+    }
+
+    // vegyes timeframe: A 5m (24 bar), B 1h (2 bar) ugyanattól az időtől. B első barja a 12. A barral
+    // együtt zár; ott mindkettő belépne, de max_positions = 1: a symbol-sorrendben első nyer.
+    for (const bool a_first : {true, false}){
+        Series a(24, kM5), b(2, kH1, 200.0);
+        a.combined[11] = 90.0; a.combined[23] = 10.0;
+        b.combined[0] = 90.0;  b.combined[1] = 10.0;
+        std::vector<backtest::PortfolioSymbol> syms{
+            {"A5M", a.cols(), a.combined, {1.0, backtest::FractionOfCash{0.5}}},
+            {"B1H", b.cols(), b.combined, {1.0, backtest::FractionOfCash{0.5}}}};
+        if (!a_first) std::swap(syms[0], syms[1]);
+        backtest::PortfolioParams pp;
+        pp.max_positions = 1;
+        std::vector<double> eq;
+        std::vector<std::int64_t> times;
+        const auto pr = backtest::run_portfolio(syms, pp, &eq, &times);
+
+        CHECK(pr.events == 26 && pr.steps == 24 && times.size() == 24);
+        bool ordered = true;
+        for (std::size_t j = 0; j < times.size(); ++j) ordered &= times[j] == kT0 + static_cast<std::int64_t>(j + 1)*kM5;
+        CHECK(ordered);
+        const auto& ra = pr.symbols[a_first ? 0 : 1];
+        const auto& rb = pr.symbols[a_first ? 1 : 0];
+        CHECK_MSG(ra.rejected == (a_first ? 0 : 1) && rb.rejected == (a_first ? 1 : 0),
+                  "a_first=%d: A rejected %d, B rejected %d", int(a_first), ra.rejected, rb.rejected);
+        CHECK(ra.metrics.trades() == (a_first ? 1 : 0) && rb.metrics.trades() == (a_first ? 0 : 1));
+        // a pozíció a 12. zárásponttól (index 11) nyitott; konstans áron csak a díj látszik
+        CHECK(eq[10] == pp.cash && eq[11] < pp.cash);
+        // nyitva a 11.–22. zárásponton: a 24. záráskor (A 24. bar / B 2. bar) a jel zár
+        CHECK(pr.metrics.exposure() == 12.0/24.0);
+    }
+
+    // max_weight: a belépő notional a portfólió-equity adott része, akkor is, ha a sizing többet kérne
+    {
+        Series a(10, kM5), b(10, kM5, 50.0);
+        a.combined[2] = 90.0;
+        b.combined[5] = 90.0;
+        const double fee_rate = 0.001;
+        std::vector<backtest::PortfolioSymbol> syms{
+            {"A", a.cols(), a.combined, {0.25, backtest::FractionOfCash{1.0}}},
+            {"B", b.cols(), b.combined, {0.4, backtest::FractionOfCash{1.0}}}};
+        backtest::PortfolioParams pp;
+        pp.fee = backtest::PercentFee{fee_rate};
+        const auto pr = backtest::run_portfolio(syms, pp);
+        // konstans ár: a symbol díja = 2 * rate * notional (belépés + a végén zárás)
+        const double na = pr.symbols[0].fees/(2.0*fee_rate);
+        const double nb = pr.symbols[1].fees/(2.0*fee_rate);
+        const double eq_b = pp.cash - 0.25*pp.cash*fee_rate;    // B belépésekor: az A belépő díja hiányzik
+        CHECK_MSG(close_rel(na, 0.25*pp.cash, 1e-9), "A notional %.17g", na);
+        CHECK_MSG(close_rel(nb, 0.4*eq_b, 1e-9), "B notional %.17g vs %.17g", nb, 0.4*eq_b);
+        CHECK(pr.symbols[0].rejected == 0 && pr.symbols[1].rejected == 0);
+        CHECK(close_rel(pr.final_eq, pp.cash - pr.fees, 1e-12));
+    }
+
+    // max_positions: a harmadik belépés elutasítva, amíg kettő nyitott; az egyik zárása után belép
+    {
+        Series a(10, kM5), b(10, kM5), c(10, kM5);
+        a.combined[1] = 90.0; a.combined[6] = 10.0;
+        b.combined[2] = 90.0;
+        c.combined[3] = 90.0; c.combined[4] = 90.0; c.combined[7] = 90.0;
+        std::vector<backtest::PortfolioSymbol> syms{
+            {"A", a.cols(), a.combined, {1.0, backtest::FractionOfCash{0.2}}},
+            {"B", b.cols(), b.combined, {1.0, backtest::FractionOfCash{0.2}}},
+            {"C", c.cols(), c.combined, {1.0, backtest::FractionOfCash{0.2}}}};
+        backtest::PortfolioParams pp;
+        pp.max_positions = 2;
+        const auto pr = backtest::run_portfolio(syms, pp);
+        CHECK(pr.symbols[0].rejected == 0 && pr.symbols[1].rejected == 0);
+        CHECK_MSG(pr.symbols[2].rejected == 2, "C rejected %d", pr.symbols[2].rejected);
+        CHECK(pr.symbols[2].metrics.trades() == 1);
+        CHECK(pr.metrics.trades() == 3);
+    }
+
+    // parse_allocation
+    {
+        Series a(2, kM5), b(2, kM5);
+        std::vector<backtest::PortfolioSymbol> syms{{"BTCUSDT", a.cols(), a.combined, {}}, {"ETHUSDT", b.cols(), b.combined, {}}};
+        CHECK(backtest::parse_allocation("ETHUSDT:0.3", syms, 0.5));
+        CHECK(syms[0].alloc.max_weight == 0.5 && syms[1].alloc.max_weight == 0.3);
+        CHECK(!backtest::parse_allocation("XRPUSDT:0.3", syms, 0.5));
+        CHECK(!backtest::parse_allocation("BTCUSDT:1.5", syms, 0.5));
+        CHECK(!backtest::parse_allocation("BTCUSDT", syms, 0.5));
+    }
+    return check_exit();
+}
@@ -0,0 +1,66 @@
+#include <cmath>
+#include <span>
+#include <vector>
+#include "core/bar_columns.hpp"
+#include "indicators/bollinger.hpp"
+#include "test_util.hpp"
+
+// RollingStats drift: a BollModule O(1) replace()-szel görgeti az ablakot és időnként anchor()-ral
+// újraszámol. 10M frissítés alatt minden baron a sávok (átlag, átlag ± k·szórás) és a szórás a friss
+// kétmenetes compute_bb-től legfeljebb kTol relatív eltérésű. A batch on_bars ugyanazt a score-sorozatot
+// adja, mint a baronkénti on_bar (bitre).
+namespace {
+constexpr double kTol = 1e-9;
+
+double rel(double a, double b){ return std::abs(a - b) / std::max(std::abs(b), 1e-300); }
+}
+
+int main(){
+    const std::size_t n = 10'000'000, p = 20;
+    const double k = 2.0;
+    const auto x = random_walk(n, 11);
+
+    ind::BollModule boll(p, k);
+    double worst_mid = 0.0, worst_sd = 0.0, worst_band = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        Bar b{}; b.close = x[i];
+        boll.on_bar(Symbol{}, Timeframe::M5, b);
+        if (i + 1 < p) continue;
+        const auto got = boll.bands();
+        const auto ref = ind::compute_bb(std::span<const double>(x.data(), i + 1), p, k);
+        worst_mid = std::max(worst_mid, rel(got.mid, ref.mid));
+        worst_sd = std::max(worst_sd, rel((got.upper - got.mid) / k, (ref.upper - ref.mid) / k));
+        worst_band = std::max({worst_band, rel(got.upper, ref.upper), rel(got.lower, ref.lower)});
+    }
+    std::printf("10M bar, max rel. hiba: atlag %.3g | szoras %.3g | savok %.3g (tol %.0e)\n",
+                worst_mid, worst_sd, worst_band, kTol);
+    CHECK(worst_mid <= kTol);
+    CHECK(worst_sd <= kTol);
+    CHECK(worst_band <= kTol);
+
+    // a szerializált állapotból folytatva ugyanaz marad (anchor-ciklus közepén mentve)
+    util::BinWriter w;
+    boll.serialize(w);
+    ind::BollModule copy(p, k);
+    util::BinReader r(w.data());
+    CHECK(copy.deserialize(r));
+    for (std::size_t i = 0; i < 5000; ++i) {
+        Bar b{}; b.close = x[i];
+        CHECK(boll.on_bar(Symbol{}, Timeframe::M5, b).score == copy.on_bar(Symbol{}, Timeframe::M5, b).score);
+    }
+
+    // batch vs streaming: több darabban (a folytatás és az anchor-határok is le vannak fedve)
+    const std::size_t m = 300'000;
+    const BarColumns cols{{}, {}, {}, {}, std::span<const double>(x.data(), m), {}};
+    ind::BollModule stream(p, k), batch(p, k);
+    std::vector<double> out(m);
+    for (std::size_t a = 0, len = 1; a < m; a += len, len = len*5 + 3) {
+        len = std::min(len, m - a);
+        batch.on_bars(Symbol{}, Timeframe::M5, cols.subspan(a, len), std::span<double>(out).subspan(a, len));
+    }
+    std::size_t diff = 0;
+    for (std::size_t i = 0; i < m; ++i)
+        if (stream.on_bar(Symbol{}, Timeframe::M5, cols.at(i)).score != out[i]) ++diff;
+    CHECK_MSG(diff == 0, "%zu elteres a %zu barbol", diff, m);
+    return check_exit();
+}
@@ -0,0 +1,76 @@
+// SeriesCache: méretkorlát és LRU kiesés; a kiesett sorozat a tartójánál érvényes marad; a timeframe
+// a kulcs része. compute_series 1m adaton a valódi TF-fel: az MTF modul óránként egy H1 zárást lát.
+#include "backtest/portfolio.hpp"
+#include "indicators/mtfa.hpp"
+#include "strategy/optimizer.hpp"
+#include "test_util.hpp"
+
+namespace {
+SeriesCache::Series series(std::size_t n, double v = 1.0){ return std::make_shared<const std::vector<double>>(n, v); }
+}
+
+int main(){
+    constexpr std::size_t n = 1000, bytes = n * sizeof(double);
+    constexpr Timeframe tf = Timeframe::M5;
+    {
+        SeriesCache c(3 * bytes);
+        c.put("a", tf, 1, series(n)); c.put("b", tf, 1, series(n)); c.put("c", tf, 1, series(n));
+        CHECK(c.size() == 3 && c.bytes() == 3 * bytes);
+        const auto held = c.find("b", tf, 1);
+        CHECK(c.find("a", tf, 1) != nullptr);          // a sorrend: a, b, c (elöl a legutóbbi)
+        CHECK(c.find("b", tf, 1) != nullptr);
+        c.put("d", tf, 1, series(n));                   // a legrégebben használt a "c"
+        CHECK(c.find("c", tf, 1) == nullptr);
+        CHECK(c.find("a", tf, 1) && c.find("b", tf, 1) && c.find("d", tf, 1));
+        CHECK(c.size() == 3 && c.bytes() == 3 * bytes && c.evicted() == 1);
+        CHECK(held && held->size() == n);
+        // ugyanaz a kulcs más datasettel külön bejegyzés
+        c.put("a", tf, 2, series(n, 2.0));
+        CHECK(c.find("a", tf, 2) && (*c.find("a", tf, 2))[0] == 2.0);
+        CHECK(c.size() == 3 && c.evicted() == 2);
+        // ismételt put nem duplikál
+        c.put("a", tf, 2, series(n));
+        CHECK(c.size() == 3 && c.bytes() == 3 * bytes && (*c.find("a", tf, 2))[0] == 2.0);
+        // ugyanaz a kulcs és dataset más timeframe-mel is külön bejegyzés
+        CHECK(!c.find("a", Timeframe::M1, 2));
+    }
+    {
+        // a korlátnál nagyobb sorozat is bekerül, de csak egyedül marad bent
+        SeriesCache c(bytes / 2);
+        c.put("x", tf, 1, series(n));
+        CHECK(c.size() == 1);
+        c.put("y", tf, 1, series(n));
+        CHECK(c.size() == 1 && c.find("y", tf, 1) && !c.find("x", tf, 1));
+        c.clear();
+        CHECK(c.size() == 0 && c.bytes() == 0);
+    }
+    {
+        // 1m adat, 12 órányi bar: a bar_timeframe M1-et ad, és a TF a cache-kulcsban van
+        const std::size_t m = 12 * 60;
+        const auto close = random_walk(m, 5, 100.0);
+        std::vector<std::int64_t> t(m);
+        for (std::size_t i = 0; i < m; ++i) t[i] = 1'700'000'000'000 - 1'700'000'000'000 % 3'600'000 + static_cast<std::int64_t>(i) * 60'000;
+        const BarColumns cols{t, {}, {}, {}, close, {}};
+        Timeframe dtf = Timeframe::D1;
+        CHECK(backtest::bar_timeframe(cols, dtf) && dtf == Timeframe::M1);
+
+        // factor 60: M1 -> H1; a 3 HTF-bar warmup (fast=slow=1) után a score óránként egyszer változhat
+        const std::vector<SlotChoices> slots{{{"MTF(60)", []{ return std::make_unique<ind::MtfSmaModule>(60, 1, 2); }}}};
+        SeriesCache c;
+        util::ThreadPool pool(1);
+        const auto s1 = compute_series(slots, cols, Symbol{}, dtf, c, pool);
+        std::size_t changes = 0;
+        for (std::size_t i = 1; i < m; ++i){
+            if ((*s1[0][0])[i] == (*s1[0][0])[i-1]) continue;
+            ++changes;
+            CHECK_MSG(i % 60 == 59, "valtozas a(z) %zu. baron (nem oraveg)", i);
+        }
+        CHECK(changes > 0);
+        // ugyanaz az adat M5-nek mondva más sorozat, és nem a cache-ből jön
+        OptimizerStats st;
+        const auto s5 = compute_series(slots, cols, Symbol{}, Timeframe::M5, c, pool, &st);
+        CHECK(st.series_computed == 1 && st.series_cached == 0);
+        CHECK(*s5[0][0] != *s1[0][0]);
+    }
+    return check_exit();
+}
@@ -0,0 +1,164 @@
+// data::save_snapshot / load_snapshot: a visszatöltött series és modulok a mentés pontjától
+// ugyanazt a score-sorozatot adják, mint a megszakítás nélküli futás; eltérő konfigurációjú modul
+// reset-et kap; csonkolt, más verziójú vagy más symbolhoz tartozó fájlnál nullopt, és semmi nem változik.
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "data/snapshot.hpp"
+#include "indicators/bollinger.hpp"
+#include "indicators/mtfa.hpp"
+#include "indicators/rsi.hpp"
+#include "indicators/sma_ema.hpp"
+#include "test_util.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::vector<std::unique_ptr<IModule>> make_modules(std::size_t sma_short = 20){
+    std::vector<std::unique_ptr<IModule>> v;
+    v.push_back(std::make_unique<ind::SmaEmaModule>(sma_short, 50));
+    v.push_back(std::make_unique<ind::RsiModule>(14, ind::RsiMode::Wilder));
+    v.push_back(std::make_unique<ind::RsiModule>(14, ind::RsiMode::Window));
+    v.push_back(std::make_unique<ind::BollModule>(20, 2.0));
+    v.push_back(std::make_unique<ind::MtfSmaModule>(12, 10, 30));
+    return v;
+}
+
+Bar make_bar(std::size_t i, double c){
+    return {1'700'000'000'000 + static_cast<std::int64_t>(i)*300'000, c*0.999, c*1.002, c*0.997, c, 10.0 + static_cast<double>(i % 7)};
+}
+
+// a bar a series-be kerül, és minden modul score-ja (a series-ből olvasva) out-ba
+void step(BarSeries& ser, std::vector<std::unique_ptr<IModule>>& mods, const Bar& b, std::vector<double>& out){
+    ser.push(b);
+    for (auto& m : mods) out.push_back(m->on_bar(Symbol{}, Timeframe::M5, ser).score);
+}
+
+std::vector<char> read_all(const std::string& path){
+    std::ifstream f(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+}
+void write_all(const std::string& path, const std::vector<char>& buf, std::size_t n){
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(buf.data(), static_cast<std::streamsize>(n));
+}
+
+} // namespace
+
+int main(){
+    spdlog::set_level(spdlog::level::err); // az elutasítások warn-t írnak, az itt elvárt
+    const fs::path dir = fs::temp_directory_path() / "snapshot_test";
+    fs::create_directories(dir);
+    const Symbol sym{"ETH", "USDT"};
+    const std::string path = data::snapshot_path(dir.string(), sym, Timeframe::M5);
+
+    const std::size_t n = 3000, cut = 1700;
+    const auto close = random_walk(n, 5, 2000.0);
+
+    // referencia: megszakítás nélkül
+    BarSeries ref_ser(300);
+    auto ref_mods = make_modules();
+    std::vector<double> ref;
+    for (std::size_t i = 0; i < n; ++i) step(ref_ser, ref_mods, make_bar(i, close[i]), ref);
+
+    // cut barig, mentés
+    {
+        BarSeries ser(300);
+        auto mods = make_modules();
+        std::vector<double> tmp;
+        for (std::size_t i = 0; i < cut; ++i) step(ser, mods, make_bar(i, close[i]), tmp);
+        CHECK(data::save_snapshot(path, sym, Timeframe::M5, ser, mods));
+        CHECK(!fs::exists(path + ".tmp"));
+    }
+
+    // visszatöltés friss modulokba, majd folytatás: a score-ok bitre egyeznek a referenciával
+    {
+        BarSeries ser(300);
+        auto mods = make_modules();
+        const auto info = data::load_snapshot(path, sym, Timeframe::M5, ser, mods);
+        CHECK(info.has_value());
+        if (info){
+            CHECK(info->bars == 300);
+            CHECK(info->restored == mods.size() && info->skipped == 0);
+            CHECK(info->last_open_time_ms == make_bar(cut - 1, 0.0).open_time_ms);
+        }
+        CHECK(ser.size() == 300 && ser.back().close == close[cut - 1]);
+        std::vector<double> got;
+        for (std::size_t i = cut; i < n; ++i) step(ser, mods, make_bar(i, close[i]), got);
+        const std::size_t k = mods.size();
+        std::size_t diff = 0;
+        for (std::size_t j = 0; j < got.size(); ++j) diff += (got[j] != ref[cut*k + j]);
+        CHECK_MSG(diff == 0, "%zu elteres a folytatasban", diff);
+    }
+
+    // eltérő konfigurációjú modul: reset, a többi visszaáll
+    {
+        BarSeries ser(300);
+        auto mods = make_modules(10);
+        const auto info = data::load_snapshot(path, sym, Timeframe::M5, ser, mods);
+        CHECK(info.has_value());
+        if (info) CHECK(info->restored == mods.size() - 1 && info->skipped == 1);
+    }
+
+    // más symbol / TF: nullopt, a series érintetlen
+    {
+        BarSeries ser(300);
+        ser.push(make_bar(0, 1.0));
+        auto mods = make_modules();
+        CHECK(!data::load_snapshot(path, Symbol{"BTC", "USDT"}, Timeframe::M5, ser, mods));
+        CHECK(!data::load_snapshot(path, sym, Timeframe::M1, ser, mods));
+        CHECK(ser.size() == 1 && ser.back().close == 1.0);
+    }
+
+    const auto good = read_all(path);
+    const std::string bad = (dir / "bad.snap").string();
+
+    // csonkolt fájl: minden rövidebb előtagra nullopt, a series érintetlen
+    {
+        std::vector<std::size_t> lens;
+        for (std::size_t len = 0; len < good.size(); len += (len < 64 ? 1 : 97)) lens.push_back(len);
+        lens.push_back(good.size() - 1); // csak az utolsó modulblob vége hiányzik
+        std::size_t accepted = 0;
+        for (const std::size_t len : lens){
+            write_all(bad, good, len);
+            BarSeries ser(300);
+            ser.push(make_bar(0, 1.0));
+            auto mods = make_modules();
+            if (data::load_snapshot(bad, sym, Timeframe::M5, ser, mods)) ++accepted;
+            CHECK(ser.size() == 1);
+        }
+        CHECK_MSG(accepted == 0, "%zu csonkolt fajl betoltve", accepted);
+    }
+
+    // más verzió és rossz magic: nullopt
+    {
+        auto buf = good;
+        buf[4] = static_cast<char>(buf[4] + 1);
+        write_all(bad, buf, buf.size());
+        BarSeries ser(300);
+        auto mods = make_modules();
+        CHECK(!data::load_snapshot(bad, sym, Timeframe::M5, ser, mods));
+        buf = good;
+        buf[0] = 'X';
+        write_all(bad, buf, buf.size());
+        CHECK(!data::load_snapshot(bad, sym, Timeframe::M5, ser, mods));
+        CHECK(ser.empty());
+    }
+
+    // hiányzó fájl
+    {
+        BarSeries ser(300);
+        auto mods = make_modules();
+        CHECK(!data::load_snapshot((dir / "nincs.snap").string(), sym, Timeframe::M5, ser, mods));
+    }
+
+    fs::remove_all(dir);
+    return check_exit();
+}
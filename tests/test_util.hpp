@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Minimális ellenőrző makrók a ctest-ből futó tesztekhez: hiba esetén kiírja a helyet és
+// nem nulla kóddal lép ki a main végén (check_exit()).
+inline int& check_failures(){ static int n = 0; return n; }
+
+#define CHECK(cond) do { if (!(cond)) { \
+    std::fprintf(stderr, "%s:%d: CHECK(%s) sikertelen\n", __FILE__, __LINE__, #cond); ++check_failures(); } } while (0)
+
+#define CHECK_MSG(cond, ...) do { if (!(cond)) { \
+    std::fprintf(stderr, "%s:%d: CHECK(%s) sikertelen: ", __FILE__, __LINE__, #cond); \
+    std::fprintf(stderr, __VA_ARGS__); std::fputc('\n', stderr); ++check_failures(); } } while (0)
+
+inline int check_exit(){
+    if (check_failures() == 0) { std::puts("OK"); return EXIT_SUCCESS; }
+    std::fprintf(stderr, "%d ellenorzes sikertelen\n", check_failures());
+    return EXIT_FAILURE;
+}
+
+// determinisztikus, pozitív árfolyam-szerű sorozat (geometriai véletlen bolyongás)
+inline std::vector<double> random_walk(std::size_t n, std::uint64_t seed = 1, double start = 30000.0, double vol = 0.002){
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> nd(0.0, vol);
+    std::vector<double> v(n);
+    double x = start;
+    for (auto& e : v) { x *= 1.0 + nd(rng); e = x; }
+    return v;
+}
@@ -0,0 +1,76 @@
+// util::TaskGroup egy közös ThreadPool-on: a wait() csak a csoport saját feladataira vár (egy másik
+// csoport blokkolt feladata nem tartja fel), a beágyazott csoport workerről sem akad el, és a
+// csoportos grid_search ugyanazt adja, mint a saját szálas.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "strategy/grid_search.hpp"
+#include "util/thread_pool.hpp"
+#include "test_util.hpp"
+
+int main(){
+    using namespace std::chrono_literals;
+    util::ThreadPool pool(2);
+
+    // A csoport egy feladata a release-ig blokkol; B közben végez, és a wait()-je visszatér
+    {
+        std::promise<void> release;
+        std::shared_future<void> gate = release.get_future().share();
+        std::atomic<int> a_done{0}, b_done{0};
+        util::TaskGroup a(pool);
+        a.submit([&]{ gate.wait(); ++a_done; });
+
+        auto b_wait = std::async(std::launch::async, [&]{
+            util::TaskGroup b(pool);
+            for (int i = 0; i < 100; ++i) b.submit([&]{ ++b_done; });
+            b.wait();
+            return b_done.load();
+        });
+        CHECK_MSG(b_wait.wait_for(5s) == std::future_status::ready, "B a masik csoportra var");
+        CHECK(b_wait.get() == 100);
+        CHECK(a_done == 0);
+
+        release.set_value();
+        a.wait();
+        CHECK(a_done == 1);
+    }
+
+    // beágyazott csoportok: minden külső feladat a workeren egy belső csoportra vár
+    {
+        std::atomic<int> inner{0};
+        util::TaskGroup outer(pool);
+        for (int i = 0; i < 8; ++i){
+            outer.submit([&]{
+                util::TaskGroup g(pool);
+                for (int k = 0; k < 16; ++k) g.submit([&]{ ++inner; });
+                g.wait();
+            });
+        }
+        outer.wait();
+        CHECK_MSG(inner == 8*16, "%d", inner.load());
+    }
+
+    // grid_search a közös poolon == saját szálakkal
+    {
+        const std::size_t n = 3000;
+        const auto close = random_walk(n, 3, 100.0);
+        ScoreMatrix sm; sm.resize(3, n);
+        for (std::size_t k = 0; k < 3; ++k){
+            const auto r = random_walk(n, 10 + k, 50.0, 0.05);
+            for (std::size_t i = 0; i < n; ++i) sm.row(k)[i] = std::clamp(r[i], 0.0, 100.0);
+        }
+        BarColumns bars; bars.close = close;
+        const auto ws = weight_simplex(3, 10);
+        const SimParams p;
+        const auto t = grid_search(sm, bars, ws, p, 10, 2);
+        const auto g = grid_search(sm, bars, ws, p, 10, pool);
+        CHECK(t.size() == g.size());
+        for (std::size_t i = 0; i < std::min(t.size(), g.size()); ++i)
+            CHECK(t[i].r.final_eq == g[i].r.final_eq && t[i].r.trades == g[i].r.trades);
+    }
+    return check_exit();
+}
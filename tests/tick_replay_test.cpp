@@ -0,0 +1,134 @@
+// backtest::TickReplay: a market megbízás a bar zárása + latency utáni első kötésen teljesül (gapnél
+// a következő kötésen), a slippage a jel barjának záróárához mér; a bracket target a tp-t érintő
+// kötésen is teljesül (a limit áron), a stop a szint alatti kötés árán; darabokban etetve ugyanaz.
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "backtest/tick_replay.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+constexpr std::int64_t kBar = 60'000;
+constexpr std::int64_t kT0 = 28'333'334 * kBar;    // percre igazított kezdet
+
+struct Ticks {
+    std::vector<std::int64_t> t;
+    std::vector<double> px;
+    void add(std::int64_t at, double p){ t.push_back(kT0 + at); px.push_back(p); }
+    TickColumns cols() const { return {t, px, {}, {}}; }
+};
+
+// jel a bar indexe szerint (a többi bar semleges)
+backtest::TickReplay::SignalFn signals(std::map<std::int64_t, Signal> at_bar){
+    return [m = std::move(at_bar)](const Bar& b){
+        const auto it = m.find((b.open_time_ms - kT0)/kBar);
+        return it == m.end()? Signal::Neutral : it->second;
+    };
+}
+
+// emelkedő ár másodpercenként: a kötés ideje az árából visszaolvasható
+double ramp(std::int64_t at){ return 100.0 + static_cast<double>(at/1000)*0.01; }
+
+} // namespace
+
+int main(){
+    // market belépés / zárás latency-vel: Long a 2. bar zárásán, Short az 5. bar zárásán
+    struct Case { std::int64_t latency, gap_from, gap_to, entry_at, exit_at; };
+    for (const Case c : {Case{0, 0, 0, 180'000, 360'000}, Case{5'000, 0, 0, 185'000, 365'000},
+                         Case{5'000, 180'000, 192'000, 192'000, 365'000}, Case{61'000, 0, 0, 241'000, 421'000}}){
+        Ticks tk;
+        for (std::int64_t at = 0; at < 600'000; at += 1000)
+            if (at < c.gap_from || at >= c.gap_to) tk.add(at, ramp(at));
+        backtest::Params p;
+        std::vector<backtest::Trade> trades;
+        backtest::TickReplay rp(p, {kBar, c.latency}, signals({{2, Signal::Long}, {5, Signal::Short}}), &trades);
+        rp.feed(tk.cols());
+        const auto r = rp.finish();
+
+        CHECK_MSG(trades.size() == 1 && r.trades == 1, "latency %lld: %zu trade", static_cast<long long>(c.latency), trades.size());
+        if (trades.size() != 1) continue;
+        const auto& t = trades[0];
+        CHECK_MSG(t.entry_px == ramp(c.entry_at), "latency %lld: belepes %.17g, vart %.17g",
+                  static_cast<long long>(c.latency), t.entry_px, ramp(c.entry_at));
+        CHECK_MSG(t.exit_px == ramp(c.exit_at), "latency %lld: zaras %.17g, vart %.17g",
+                  static_cast<long long>(c.latency), t.exit_px, ramp(c.exit_at));
+        CHECK(t.reason == backtest::ExitReason::Signal);
+        CHECK(t.entry_i == static_cast<std::size_t>(c.entry_at/kBar) && t.exit_i == static_cast<std::size_t>(c.exit_at/kBar));
+        // slippage a jel barjának záróárától (2. bar: 179 s, 5. bar: 359 s)
+        const double ref_in = ramp(179'000), ref_out = ramp(359'000);
+        const double slip = (t.entry_px - ref_in)/ref_in + (ref_out - t.exit_px)/ref_out;
+        CHECK(rp.stats().fills == 2);
+        CHECK(std::fabs(rp.stats().avg_slippage_bps() - slip/2*1e4) < 1e-9);
+        CHECK(std::fabs(r.final_eq - (p.cash + t.pnl)) < 1e-9);
+        CHECK(rp.stats().bars == 10 && rp.stats().ticks == tk.t.size());
+    }
+
+    // bracket: 1% target és stop. Első trade: a pontosan tp-n lévő kötés zár (a limit áron);
+    // második: a stop gappel, a szint alatti kötés árán.
+    {
+        const double tp_px = 100.0*(1.0 + 1.0/100.0);   // ugyanaz a számítás, mint a belépéskor
+        Ticks tk;
+        for (std::int64_t at = 0; at < 120'000; at += 1000) tk.add(at, 100.0);
+        tk.add(120'000, 100.0);         // belépés (Long az 1. bar zárásán)
+        tk.add(121'000, 100.5);
+        tk.add(122'000, 100.99);
+        tk.add(123'000, tp_px);         // target: pontosan a szinten
+        tk.add(124'000, 100.2);
+        for (std::int64_t at = 125'000; at < 240'000; at += 1000) tk.add(at, 100.0);
+        tk.add(240'000, 100.0);         // belépés (Long a 3. bar zárásán)
+        tk.add(241'000, 99.5);
+        tk.add(242'000, 99.2);
+        tk.add(243'000, 98.5);          // stop 99-en, gap: a kötés áron
+        tk.add(244'000, 101.5);
+        for (std::int64_t at = 245'000; at < 360'000; at += 1000) tk.add(at, 100.0);
+
+        backtest::Params p;
+        p.bracket = {1.0, 1.0, backtest::TieBreak::StopFirst};
+        std::vector<backtest::Trade> trades;
+        backtest::TickReplay rp(p, {kBar, 0}, signals({{1, Signal::Long}, {3, Signal::Long}}), &trades);
+        rp.feed(tk.cols());
+        const auto r = rp.finish();
+
+        CHECK_MSG(trades.size() == 2, "%zu trade", trades.size());
+        CHECK(r.targets == 1 && r.stops == 1);
+        if (trades.size() == 2){
+            CHECK(trades[0].reason == backtest::ExitReason::TakeProfit && trades[0].exit_px == tp_px);
+            CHECK(trades[0].entry_px == 100.0 && trades[0].entry_i == 2 && trades[0].exit_i == 2);
+            CHECK(trades[1].reason == backtest::ExitReason::StopLoss && trades[1].exit_px == 98.5);
+            CHECK(trades[1].entry_i == 4 && trades[1].exit_i == 4);
+        }
+    }
+
+    // darabokban etetve (a bar- és a függő megbízás-állapot a feed() hívások között él) ugyanaz
+    {
+        Ticks tk;
+        const auto w = random_walk(20'000, 4, 100.0, 0.001);
+        for (std::size_t i = 0; i < w.size(); ++i) tk.add(static_cast<std::int64_t>(i)*700, w[i]);
+        backtest::Params p;
+        p.bracket = {0.4, 0.3, backtest::TieBreak::StopFirst};
+        auto sig = [](const Bar& b){ return b.close > b.open*1.0005? Signal::Long : (b.close < b.open*0.9995? Signal::Short : Signal::Neutral); };
+
+        std::vector<backtest::Trade> whole, parts;
+        backtest::TickReplay a(p, {kBar, 2'500}, sig, &whole), b(p, {kBar, 2'500}, sig, &parts);
+        a.feed(tk.cols());
+        const auto ra = a.finish();
+        const TickColumns all = tk.cols();
+        std::size_t at = 0;
+        for (const std::size_t len : {std::size_t{1}, std::size_t{7}, std::size_t{85}, std::size_t{3001}, std::size_t{9000}}){
+            b.feed(all.subspan(at, len));
+            at += len;
+        }
+        b.feed(all.subspan(at, all.size() - at));
+        const auto rb = b.finish();
+
+        CHECK(ra.trades > 10 && ra.stops > 0 && ra.targets > 0);
+        CHECK(ra.final_eq == rb.final_eq && ra.trades == rb.trades && whole.size() == parts.size());
+        bool same = whole.size() == parts.size();
+        for (std::size_t k = 0; same && k < whole.size(); ++k)
+            same = whole[k].entry_px == parts[k].entry_px && whole[k].exit_px == parts[k].exit_px && whole[k].reason == parts[k].reason;
+        CHECK(same);
+    }
+    return check_exit();
+}